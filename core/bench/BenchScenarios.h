@@ -0,0 +1,244 @@
+#ifndef SOLARSYS_BENCH_BENCH_SCENARIOS_H
+#define SOLARSYS_BENCH_BENCH_SCENARIOS_H
+
+#include "simulation/SolarSystem.h"
+#include "random/CounterRng.h"
+
+#include <string>
+#include <vector>
+
+/*--- Reproducible benchmark scenarios ---*/
+// Planet elements are the J2000 mean elements (Standish, JPL), moons use
+// circular-ish orbits in their parent's equatorial plane. Every scenario is a
+// pure function of its arguments, so runs on different machines compare.
+namespace BenchScenarios {
+
+    constexpr double DEG = M_PI / 180.0;
+
+    struct PlanetRecord {
+        int id;
+        const char* name;
+        double mass;            // kg
+        double a;               // AU
+        double e;
+        double i;               // deg
+        double meanLongitude;   // deg (L)
+        double longPeri;        // deg (ϖ)
+        double ascNode;         // deg (Ω)
+    };
+
+    struct MoonRecord {
+        int id;
+        const char* name;
+        int parentId;
+        double mass;            // kg
+        double a;               // m
+        double e;
+        double i;               // deg, relative to ecliptic
+    };
+
+    inline const std::vector<PlanetRecord>& planets() {
+        static const std::vector<PlanetRecord> table = {
+            {1, "Mercury", 3.3011e23,  0.38709927, 0.20563593,  7.00497902, 252.25032350,  77.45779628,  48.33076593},
+            {2, "Venus",   4.8675e24,  0.72333566, 0.00677672,  3.39467605, 181.97909950, 131.60246718,  76.67984255},
+            {3, "Earth",   5.9720e24,  1.00000261, 0.01671123, -0.00001531, 100.46457166, 102.93768193,   0.0},
+            {4, "Mars",    6.4171e23,  1.52371034, 0.09339410,  1.84969142,  -4.55343205, -23.94362959,  49.55953891},
+            {5, "Jupiter", 1.8982e27,  5.20288700, 0.04838624,  1.30439695,  34.39644051,  14.72847983, 100.47390909},
+            {6, "Saturn",  5.6834e26,  9.53667594, 0.05386179,  2.48599187,  49.95424423,  92.59887831, 113.66242448},
+            {7, "Uranus",  8.6810e25, 19.18916464, 0.04725744,  0.77263783, 313.23810451, 170.95427630,  74.01692503},
+            {8, "Neptune", 1.02413e26, 30.06992276, 0.00859048, 1.77004347, -55.12002969,  44.96476227, 131.78422574},
+        };
+        return table;
+    }
+
+    inline const std::vector<MoonRecord>& moons() {
+        static const std::vector<MoonRecord> table = {
+            {101, "Moon",     3, 7.342e22,  3.844e8,   0.0549,   5.145},
+            {201, "Phobos",   4, 1.0659e16, 9.376e6,   0.0151,   1.08},
+            {202, "Deimos",   4, 1.4762e15, 2.3463e7,  0.00033,  1.79},
+            {301, "Io",       5, 8.9319e22, 4.217e8,   0.0041,   2.21},
+            {302, "Europa",   5, 4.7998e22, 6.709e8,   0.009,    1.79},
+            {303, "Ganymede", 5, 1.4819e23, 1.0704e9,  0.0013,   2.21},
+            {304, "Callisto", 5, 1.0759e23, 1.8827e9,  0.0074,   2.02},
+            {401, "Titan",    6, 1.3452e23, 1.22187e9, 0.0288,  27.0},
+            {402, "Rhea",     6, 2.306e21,  5.2704e8,  0.001,   26.7},
+            {501, "Titania",  7, 3.4e21,    4.363e8,   0.0011,  97.8},
+            {502, "Oberon",   7, 3.076e21,  5.835e8,   0.0014,  97.8},
+            {601, "Triton",   8, 2.14e22,   3.547e8,   0.000016, 130.0},
+        };
+        return table;
+    }
+
+    inline OrbitalElements planetElements(const PlanetRecord& p) {
+        OrbitalElements e;
+        e.semiMajorAxis = p.a * PhysicsConstants::AU;
+        e.eccentricity = p.e;
+        e.inclination = p.i * DEG;
+        e.longitudeOfAscNode = p.ascNode * DEG;
+        e.argumentOfPeriapsis = (p.longPeri - p.ascNode) * DEG;
+        e.meanAnomaly = (p.meanLongitude - p.longPeri) * DEG;
+        e.trueAnomaly = 0.0;
+        e.epoch = 0.0;
+        return e;
+    }
+
+    inline OrbitalElements moonElements(const MoonRecord& m, double phase) {
+        OrbitalElements e;
+        e.semiMajorAxis = m.a;
+        e.eccentricity = m.e;
+        e.inclination = m.i * DEG;
+        e.longitudeOfAscNode = 0.0;
+        e.argumentOfPeriapsis = 0.0;
+        e.meanAnomaly = phase;
+        e.trueAnomaly = 0.0;
+        e.epoch = 0.0;
+        return e;
+    }
+
+    inline BodyState makeState(int id, double mass, const Orbit& orbit) {
+        BodyState s;
+        s.id = id;
+        s.mass = mass;
+        s.position = orbit.getPositionAtTime(0.0);
+        s.velocity = orbit.getVelocityAtTime(0.0);
+        s.acceleration = Vec3();
+        return s;
+    }
+
+    // Shift to the barycentric frame so the system doesn't drift
+    inline void toBarycentric(std::vector<BodyState>& bodies) {
+        Vec3 com = IntegratorUtils::computeCenterOfMass(bodies);
+        Vec3 comV = IntegratorUtils::computeCenterOfMassVelocity(bodies);
+        for (auto& b : bodies) {
+            b.position -= com;
+            b.velocity -= comV;
+        }
+    }
+
+    inline BodyState sunState() {
+        BodyState s;
+        s.id = 0;
+        s.mass = PhysicsConstants::SOLAR_MASS;
+        s.position = Vec3();
+        s.velocity = Vec3();
+        s.acceleration = Vec3();
+        return s;
+    }
+
+    /*--- Sun + the given planets (by id), barycentric ---*/
+    inline std::vector<BodyState> planetarySystem(const std::vector<int>& planetIds) {
+        std::vector<BodyState> bodies = { sunState() };
+        for (const auto& p : planets()) {
+            for (int id : planetIds) {
+                if (id == p.id) {
+                    bodies.push_back(makeState(p.id, p.mass, Orbit(planetElements(p), PhysicsConstants::SOLAR_MASS)));
+                }
+            }
+        }
+        toBarycentric(bodies);
+        return bodies;
+    }
+
+    /*--- Sun + Mercury..Mars ---*/
+    inline std::vector<BodyState> innerSystem() { return planetarySystem({1, 2, 3, 4}); }
+
+    /*--- Sun + Jupiter + Saturn (near 5:2 resonance) ---*/
+    inline std::vector<BodyState> sunJupiterSaturn() { return planetarySystem({5, 6}); }
+
+    /*--- Sun + a Halley-like comet (e = 0.967, q = 0.59 AU) starting at aphelion ---*/
+    inline std::vector<BodyState> eccentricComet() {
+        OrbitalElements e;
+        e.semiMajorAxis = 17.834 * PhysicsConstants::AU;
+        e.eccentricity = 0.96714;
+        e.inclination = 162.26 * DEG;
+        e.longitudeOfAscNode = 58.42 * DEG;
+        e.argumentOfPeriapsis = 111.33 * DEG;
+        e.meanAnomaly = M_PI;
+        e.trueAnomaly = 0.0;
+        e.epoch = 0.0;
+        std::vector<BodyState> bodies = { sunState(),
+            makeState(90001, 2.2e14, Orbit(e, PhysicsConstants::SOLAR_MASS)) };
+        toBarycentric(bodies);
+        return bodies;
+    }
+
+    /*--- Sun + Earth + a 1 t spacecraft on a hyperbolic Earth flyby ---*/
+    // Starts 1.5e6 km out at v_inf = 5 km/s with an aim that puts periapsis
+    // near 7000 km (about 600 km altitude) roughly 3.5 days later
+    inline std::vector<BodyState> earthFlyby() {
+        std::vector<BodyState> bodies = planetarySystem({3});
+        const BodyState& earth = bodies[1];
+        const double mu = PhysicsConstants::G * earth.mass;
+        const double vInf = 5.0e3;
+        const double periapsis = 7.0e6;
+        const double distance = 1.5e9;
+        const double aim = periapsis * std::sqrt(1.0 + 2.0 * mu / (periapsis * vInf * vInf));
+
+        BodyState craft;
+        craft.id = 90002;
+        craft.mass = 1000.0;
+        craft.position = earth.position + Vec3(-distance, aim, 0.0);
+        craft.velocity = earth.velocity + Vec3(std::sqrt(vInf * vInf + 2.0 * mu / distance), 0.0, 0.0);
+        craft.acceleration = Vec3();
+        bodies.push_back(craft);
+        return bodies;
+    }
+
+    /*--- Sun + 8 planets + 12 major moons ---*/
+    inline std::vector<BodyState> fullSystem() {
+        std::vector<BodyState> bodies = { sunState() };
+        for (const auto& p : planets()) {
+            bodies.push_back(makeState(p.id, p.mass, Orbit(planetElements(p), PhysicsConstants::SOLAR_MASS)));
+        }
+
+        size_t planetCount = bodies.size();
+        for (const auto& m : moons()) {
+            for (size_t k = 1; k < planetCount; ++k) {
+                if (bodies[k].id != m.parentId) continue;
+                Orbit rel(moonElements(m, 0.37 * m.id), bodies[k].mass);
+                BodyState s = makeState(m.id, m.mass, rel);
+                s.position += bodies[k].position;
+                s.velocity += bodies[k].velocity;
+                bodies.push_back(s);
+            }
+        }
+        toBarycentric(bodies);
+        return bodies;
+    }
+
+    /*--- Massless main-belt test particles (2.1-3.3 AU, e < 0.2, i < 10 deg) ---*/
+    inline std::vector<BodyState> beltParticles(size_t count, uint64_t seed = 2024) {
+        std::vector<BodyState> particles;
+        particles.reserve(count);
+        CounterRng rng(seed, 0);
+
+        for (size_t k = 0; k < count; ++k) {
+            OrbitalElements e;
+            e.semiMajorAxis = rng.uniform(2.1, 3.3) * PhysicsConstants::AU;
+            e.eccentricity = rng.uniform(0.0, 0.2);
+            e.inclination = rng.uniform(0.0, 10.0) * DEG;
+            e.longitudeOfAscNode = rng.uniform(0.0, 2.0 * M_PI);
+            e.argumentOfPeriapsis = rng.uniform(0.0, 2.0 * M_PI);
+            e.meanAnomaly = rng.uniform(0.0, 2.0 * M_PI);
+            e.trueAnomaly = 0.0;
+            e.epoch = 0.0;
+            particles.push_back(makeState(100000 + static_cast<int>(k), 0.0, Orbit(e, PhysicsConstants::SOLAR_MASS)));
+        }
+        return particles;
+    }
+
+    /*--- Keplerian SolarSystem with the 8 planets ---*/
+    inline SolarSystem keplerianPlanets() {
+        SolarSystem system;
+        system.setStar(std::make_unique<Star>(0, "Sun", CelestialBody::BodyType::STAR,
+                                              PhysicsConstants::SOLAR_MASS, 6.96e8));
+        for (const auto& p : planets()) {
+            system.addPlanet(std::make_unique<Planet>(p.id, p.name, CelestialBody::BodyType::PLANET, p.mass));
+            system.setOrbit(p.id, Orbit(planetElements(p), PhysicsConstants::SOLAR_MASS));
+        }
+        system.setUseKeplerianOrbits(true);
+        return system;
+    }
+}
+
+#endif // SOLARSYS_BENCH_BENCH_SCENARIOS_H
@@ -0,0 +1,1182 @@
+#include "BenchScenarios.h"
+#include "humanity/EventEngine.h"
+#include "physics/ParticleGravity.h"
+#include "simulation/OrbitEventScheduler.h"
+#include "simulation/PatchedConicPropagator.h"
+#include "simulation/PipelinedRunLoop.h"
+#include "simulation/SpatialIndex.h"
+#include "simulation/TransferMatrix.h"
+#include "simulation/TransferSearch.h"
+#include "simulation/WorkStealingPool.h"
+
+#ifdef SOLARSYS_HAS_NET
+#include "net/ParticleShards.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Reproducible throughput benchmarks for the core.
+//
+//   solarsys_bench [--json] [--out FILE] [--quick] [--filter TEXT] [--min-time SECONDS]
+//                  [--trace FILE]
+//
+// --json prints one JSON object per result (JSON Lines) instead of a table;
+// --out appends the same JSON Lines to FILE for tracking over time.
+// --trace writes a Chrome trace (profiling builds, SOLARSYS_ENABLE_PROFILING).
+
+namespace {
+
+    struct BenchOptions {
+        bool json = false;
+        bool quick = false;
+        std::string outPath;
+        std::string filter;
+        std::string tracePath;
+        double minTime = 0.5;
+    };
+
+    struct BenchResult {
+        std::string suite;
+        std::string scenario;
+        std::string method;
+        size_t bodies = 0;
+        uint64_t steps = 0;
+        double seconds = 0.0;
+        double pairInteractions = 0.0;  // total over the timed steps
+        double energyDrift = std::numeric_limits<double>::quiet_NaN();
+
+        double stepsPerSecond() const { return seconds > 0 ? steps / seconds : 0.0; }
+        double pairsPerSecond() const { return seconds > 0 ? pairInteractions / seconds : 0.0; }
+        double nsPerBodyStep() const {
+            double work = static_cast<double>(steps) * static_cast<double>(bodies);
+            return work > 0 ? seconds * 1e9 / work : 0.0;
+        }
+    };
+
+    struct Timing {
+        uint64_t steps;
+        double seconds;
+    };
+
+    // Runs step() until both minSteps and minSeconds are met (or maxSteps reached)
+    Timing timeSteps(const std::function<void()>& step, double minSeconds,
+                     uint64_t minSteps, uint64_t maxSteps) {
+        using Clock = std::chrono::steady_clock;
+        step();  // warm-up: first-touch, cache fill, lazy init
+
+        uint64_t steps = 0;
+        auto start = Clock::now();
+        double elapsed = 0.0;
+        while (steps < maxSteps && (steps < minSteps || elapsed < minSeconds)) {
+            step();
+            ++steps;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        return Timing{steps, elapsed};
+    }
+
+    // Results of timed loops are stored here so the optimizer can't drop them
+    volatile double benchSink = 0.0;
+
+    const char* methodName(IntegrationMethod m) {
+        switch (m) {
+            case IntegrationMethod::EULER: return "euler";
+            case IntegrationMethod::SYMPLECTIC_EULER: return "symplectic_euler";
+            case IntegrationMethod::VELOCITY_VERLET: return "velocity_verlet";
+            case IntegrationMethod::RK4: return "rk4";
+        }
+        return "unknown";
+    }
+
+    // Acceleration evaluations per body per step for each method
+    int evaluationsPerStep(IntegrationMethod m) {
+        return m == IntegrationMethod::RK4 ? 5 : 1;
+    }
+
+    const IntegrationMethod ALL_METHODS[] = {
+        IntegrationMethod::EULER, IntegrationMethod::SYMPLECTIC_EULER,
+        IntegrationMethod::VELOCITY_VERLET, IntegrationMethod::RK4
+    };
+
+    void integrateBody(BodyState& body, double dt, IntegrationMethod method,
+                       const std::vector<BodyState>& field) {
+        switch (method) {
+            case IntegrationMethod::EULER:
+                Integrator::euler(body, dt, Integrator::nBodyAcceleration, field); break;
+            case IntegrationMethod::SYMPLECTIC_EULER:
+                Integrator::symplecticEuler(body, dt, Integrator::nBodyAcceleration, field); break;
+            case IntegrationMethod::VELOCITY_VERLET:
+                Integrator::velocityVerlet(body, dt, Integrator::nBodyAcceleration, field); break;
+            case IntegrationMethod::RK4:
+                Integrator::rk4(body, dt, Integrator::nBodyAcceleration, field); break;
+        }
+    }
+
+    class BenchRunner {
+    private:
+        BenchOptions options;
+        std::vector<BenchResult> results;
+        std::ofstream out;
+
+    public:
+        explicit BenchRunner(const BenchOptions& opts) : options(opts) {
+            if (!options.outPath.empty()) out.open(options.outPath, std::ios::app);
+            if (!options.json) {
+                std::printf("%-12s %-22s %-22s %9s %9s %12s %14s %12s %12s\n",
+                            "suite", "scenario", "method", "bodies", "steps",
+                            "steps/s", "pairs/s", "ns/body-step", "energy drift");
+            }
+        }
+
+        bool enabled(const std::string& suite, const std::string& scenario, const std::string& method) const {
+            if (options.filter.empty()) return true;
+            std::string key = suite + "/" + scenario + "/" + method;
+            return key.find(options.filter) != std::string::npos;
+        }
+
+        const BenchOptions& getOptions() const { return options; }
+
+        void report(const BenchResult& r) {
+            results.push_back(r);
+            std::string line = toJson(r);
+            if (out) out << line << "\n";
+
+            if (options.json) {
+                std::cout << line << std::endl;
+            } else {
+                std::printf("%-12s %-22s %-22s %9zu %9llu %12.4g %14.4g %12.4g %12.3g\n",
+                            r.suite.c_str(), r.scenario.c_str(), r.method.c_str(), r.bodies,
+                            static_cast<unsigned long long>(r.steps), r.stepsPerSecond(),
+                            r.pairsPerSecond(), r.nsPerBodyStep(), r.energyDrift);
+                std::fflush(stdout);
+            }
+        }
+
+    private:
+        static std::string number(double v) {
+            if (!std::isfinite(v)) return "null";
+            std::ostringstream s;
+            s.precision(9);
+            s << v;
+            return s.str();
+        }
+
+        static std::string toJson(const BenchResult& r) {
+            std::ostringstream s;
+            s << "{\"suite\":\"" << r.suite << "\",\"scenario\":\"" << r.scenario
+              << "\",\"method\":\"" << r.method << "\",\"bodies\":" << r.bodies
+              << ",\"steps\":" << r.steps << ",\"seconds\":" << number(r.seconds)
+              << ",\"steps_per_s\":" << number(r.stepsPerSecond())
+              << ",\"pair_interactions_per_s\":" << number(r.pairsPerSecond())
+              << ",\"ns_per_body_step\":" << number(r.nsPerBodyStep())
+              << ",\"energy_drift\":" << number(r.energyDrift) << "}";
+            return s.str();
+        }
+    };
+
+    /*--- Integrator throughput through SolarSystem::step() in N-body mode ---*/
+    void benchIntegrators(BenchRunner& runner) {
+        struct Scenario { const char* name; std::vector<BodyState> bodies; double dt; };
+        std::vector<Scenario> scenarios = {
+            {"inner", BenchScenarios::innerSystem(), TimeConstants::HOUR},
+            {"planets+moons", BenchScenarios::fullSystem(), 10.0 * TimeConstants::MINUTE},
+        };
+
+        for (const auto& sc : scenarios) {
+            for (IntegrationMethod m : ALL_METHODS) {
+                if (!runner.enabled("integrator", sc.name, methodName(m))) continue;
+
+                SolarSystem system;
+                system.setBodyStates(sc.bodies);
+                system.setUseKeplerianOrbits(false);
+                system.setIntegrationMethod(m);
+                system.getTimeSystem().setTimeStep(sc.dt);
+
+                double e0 = IntegratorUtils::computeTotalEnergy(system.getBodyStates());
+                Timing t = timeSteps([&] { system.step(); }, runner.getOptions().minTime, 100, 10000000);
+                double e1 = IntegratorUtils::computeTotalEnergy(system.getBodyStates());
+
+                size_t n = sc.bodies.size();
+                BenchResult r;
+                r.suite = "integrator";
+                r.scenario = sc.name;
+                r.method = methodName(m);
+                r.bodies = n;
+                r.steps = t.steps;
+                r.seconds = t.seconds;
+                r.pairInteractions = static_cast<double>(t.steps) * n * (n - 1) * evaluationsPerStep(m);
+                r.energyDrift = (e1 - e0) / std::abs(e0);
+                runner.report(r);
+            }
+        }
+    }
+
+    /*--- Massless test particles in the field of the Sun + 8 planets ---*/
+    void benchTestParticles(BenchRunner& runner) {
+        std::vector<size_t> counts = {10000, 100000, 1000000};
+        if (runner.getOptions().quick) counts = {10000};
+
+        for (size_t count : counts) {
+            std::string scenario = "particles_" + std::to_string(count);
+            for (IntegrationMethod m : ALL_METHODS) {
+                if (!runner.enabled("particles", scenario, methodName(m))) continue;
+
+                std::vector<BodyState> massive = BenchScenarios::planetarySystem({1, 2, 3, 4, 5, 6, 7, 8});
+                std::vector<BodyState> particles = BenchScenarios::beltParticles(count);
+                std::vector<BodyState> field;
+                const double dt = TimeConstants::DAY;
+
+                auto step = [&] {
+                    field = massive;    // particles see the start-of-step field
+                    for (auto& body : massive) integrateBody(body, dt, m, field);
+                    for (auto& p : particles) integrateBody(p, dt, m, field);
+                };
+                Timing t = timeSteps(step, runner.getOptions().minTime, 2, 1000000);
+
+                BenchResult r;
+                r.suite = "particles";
+                r.scenario = scenario;
+                r.method = methodName(m);
+                r.bodies = count + massive.size();
+                r.steps = t.steps;
+                r.seconds = t.seconds;
+                double pairsPerEval = static_cast<double>(count) * massive.size()
+                                    + static_cast<double>(massive.size()) * (massive.size() - 1);
+                r.pairInteractions = static_cast<double>(t.steps) * pairsPerEval * evaluationsPerStep(m);
+                runner.report(r);
+            }
+        }
+    }
+
+    /*--- Belt particles under the planets: double vs. mixed-precision force kernel ---*/
+    // The energy column of the mixed row is its largest relative error in the
+    // specific potential against the double kernel, not a drift over time
+    void benchForces(BenchRunner& runner) {
+        size_t count = runner.getOptions().quick ? 10000 : 100000;
+        std::string scenario = "particles_" + std::to_string(count);
+
+        ForceSources sources;
+        sources.assign(BenchScenarios::planetarySystem({1, 2, 3, 4, 5, 6, 7, 8}));
+        std::vector<BodyState> particles = BenchScenarios::beltParticles(count);
+        std::vector<double> x(count), y(count), z(count), ax(count), ay(count), az(count);
+        for (size_t i = 0; i < count; ++i) {
+            x[i] = particles[i].position.x;
+            y[i] = particles[i].position.y;
+            z[i] = particles[i].position.z;
+        }
+        ForceErrorReport error = ParticleGravity::measureError(sources, x.data(), y.data(), z.data(), count);
+
+        for (ForcePrecision precision : {ForcePrecision::DOUBLE, ForcePrecision::MIXED}) {
+            const char* method = precision == ForcePrecision::DOUBLE ? "double" : "mixed";
+            if (!runner.enabled("forces", scenario, method)) continue;
+
+            Timing t = timeSteps([&] {
+                ParticleGravity::accelerations(sources, x.data(), y.data(), z.data(), count,
+                                               ax.data(), ay.data(), az.data(), nullptr, precision);
+            }, runner.getOptions().minTime, 10, 1000000);
+            benchSink = ax[count / 2];
+
+            BenchResult r;
+            r.suite = "forces";
+            r.scenario = scenario;
+            r.method = method;
+            r.bodies = count + sources.size();
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            r.pairInteractions = static_cast<double>(t.steps) * count * sources.size();
+            if (precision == ForcePrecision::MIXED) r.energyDrift = error.maxEnergyError;
+            runner.report(r);
+        }
+    }
+
+#ifdef SOLARSYS_HAS_NET
+    /*--- Belt particles sharded over forked local workers, one day per lock-step ---*/
+    void benchShards(BenchRunner& runner) {
+        size_t count = runner.getOptions().quick ? 10000 : 100000;
+        std::string scenario = "particles_" + std::to_string(count);
+        std::vector<BodyState> massive = BenchScenarios::planetarySystem({1, 2, 3, 4, 5, 6, 7, 8});
+        std::vector<double> radii(massive.size(), 0.0);
+
+        for (size_t workers : {1, 2, 4}) {
+            std::string method = "workers_" + std::to_string(workers);
+            if (!runner.enabled("shards", scenario, method)) continue;
+
+            ParticleShardCoordinator coordinator;
+            std::vector<pid_t> pids;
+            std::string error;
+            if (!ParticleShards::spawnLocalWorkers(coordinator, workers, pids, &error) ||
+                !coordinator.distribute(BenchScenarios::beltParticles(count), massive, radii, 0.0)) {
+                std::cerr << "shards: " << (error.empty() ? coordinator.getLastError() : error) << "\n";
+                coordinator.shutdown();
+                ParticleShards::waitForWorkers(pids);
+                continue;
+            }
+
+            // The field is held fixed; only transport and worker time are measured
+            Timing t = timeSteps([&] { coordinator.step(massive, TimeConstants::DAY); },
+                                 runner.getOptions().minTime, 5, 100000);
+            benchSink = coordinator.getTime();
+            coordinator.shutdown();
+            ParticleShards::waitForWorkers(pids);
+
+            BenchResult r;
+            r.suite = "shards";
+            r.scenario = scenario;
+            r.method = method;
+            r.bodies = count + massive.size();
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            r.pairInteractions = static_cast<double>(t.steps) * count * massive.size();
+            runner.report(r);
+        }
+    }
+#endif
+
+    /*--- Lane-interleaved ensemble (8 perturbed copies of the inner system) ---*/
+    void benchEnsemble(BenchRunner& runner) {
+        const size_t lanes = 8;
+        for (IntegrationMethod m : ALL_METHODS) {
+            if (!runner.enabled("ensemble", "inner_x8", methodName(m))) continue;
+
+            std::vector<BodyState> bodies = BenchScenarios::innerSystem();
+            EnsembleState ensemble = EnsembleState::broadcast(bodies, lanes);
+            for (size_t l = 0; l < lanes; ++l) ensemble.px[ensemble.index(3, l)] += 1000.0 * l;
+
+            double e0 = IntegratorUtils::computeTotalEnergy(ensemble.getLane(0));
+            Timing t = timeSteps([&] { Integrator::stepEnsemble(ensemble, TimeConstants::HOUR, m); },
+                                 runner.getOptions().minTime, 100, 10000000);
+            double e1 = IntegratorUtils::computeTotalEnergy(ensemble.getLane(0));
+
+            size_t n = bodies.size();
+            BenchResult r;
+            r.suite = "ensemble";
+            r.scenario = "inner_x8";
+            r.method = methodName(m);
+            r.bodies = n * lanes;
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            r.pairInteractions = static_cast<double>(t.steps) * lanes * n * (n - 1) * evaluationsPerStep(m);
+            r.energyDrift = (e1 - e0) / std::abs(e0);
+            runner.report(r);
+        }
+    }
+
+    /*--- SolarSystem::step() cost: analytic vs. integrated planets ---*/
+    void benchStepModes(BenchRunner& runner) {
+        if (runner.enabled("step", "planets", "keplerian")) {
+            SolarSystem system = BenchScenarios::keplerianPlanets();
+            system.getTimeSystem().setTimeStep(TimeConstants::DAY);
+
+            // Query every planet each tick, as a renderer or exporter would
+            double sink = 0.0;
+            Timing t = timeSteps([&] {
+                system.step();
+                for (const auto& p : BenchScenarios::planets()) sink += system.getBodyPosition(p.id).x;
+            }, runner.getOptions().minTime, 100, 100000000);
+            benchSink = sink;
+
+            BenchResult r;
+            r.suite = "step";
+            r.scenario = "planets";
+            r.method = "keplerian";
+            r.bodies = BenchScenarios::planets().size() + 1;
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+
+        // Large catalogue where only the planets are queried: step cost must not scale with N
+        size_t catalogue = runner.getOptions().quick ? 100000 : 1000000;
+        std::string catalogueScenario = "catalogue_" + std::to_string(catalogue);
+        if (runner.enabled("step", catalogueScenario, "keplerian_lazy")) {
+            SolarSystem system = BenchScenarios::keplerianPlanets();
+            system.getTimeSystem().setTimeStep(TimeConstants::DAY);
+            CounterRng rng(7, 0);
+            for (size_t k = 0; k < catalogue; ++k) {
+                OrbitalElements e;
+                e.semiMajorAxis = rng.uniform(2.1, 3.3) * PhysicsConstants::AU;
+                e.eccentricity = rng.uniform(0.0, 0.2);
+                e.inclination = rng.uniform(0.0, 0.17);
+                e.longitudeOfAscNode = rng.uniform(0.0, 2.0 * M_PI);
+                e.argumentOfPeriapsis = rng.uniform(0.0, 2.0 * M_PI);
+                e.meanAnomaly = rng.uniform(0.0, 2.0 * M_PI);
+                e.trueAnomaly = 0.0;
+                e.epoch = 0.0;
+                system.setOrbit(100000 + static_cast<int>(k), Orbit(e, PhysicsConstants::SOLAR_MASS));
+            }
+
+            double sink = 0.0;
+            Timing t = timeSteps([&] {
+                system.step();
+                for (const auto& p : BenchScenarios::planets()) sink += system.getBodyPosition(p.id).x;
+            }, runner.getOptions().minTime, 100, 100000000);
+            benchSink = sink;
+
+            BenchResult r;
+            r.suite = "step";
+            r.scenario = catalogueScenario;
+            r.method = "keplerian_lazy";
+            r.bodies = catalogue + BenchScenarios::planets().size() + 1;
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+
+        if (runner.enabled("step", "planets", "nbody_velocity_verlet")) {
+            SolarSystem system;
+            system.setBodyStates(BenchScenarios::planetarySystem({1, 2, 3, 4, 5, 6, 7, 8}));
+            system.setUseKeplerianOrbits(false);
+            system.setIntegrationMethod(IntegrationMethod::VELOCITY_VERLET);
+            system.getTimeSystem().setTimeStep(TimeConstants::DAY);
+
+            double e0 = IntegratorUtils::computeTotalEnergy(system.getBodyStates());
+            Timing t = timeSteps([&] { system.step(); }, runner.getOptions().minTime, 100, 100000000);
+            double e1 = IntegratorUtils::computeTotalEnergy(system.getBodyStates());
+
+            size_t n = system.getBodyStates().size();
+            BenchResult r;
+            r.suite = "step";
+            r.scenario = "planets";
+            r.method = "nbody_velocity_verlet";
+            r.bodies = n;
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            r.pairInteractions = static_cast<double>(t.steps) * n * (n - 1);
+            r.energyDrift = (e1 - e0) / std::abs(e0);
+            runner.report(r);
+        }
+    }
+
+    /*--- Orbit::getPositionAtTime over a belt catalogue and an e=0.97 comet, plus the inverse ---*/
+    void benchOrbitEvaluation(BenchRunner& runner) {
+        struct Scenario { const char* name; std::vector<Orbit> orbits; };
+
+        std::vector<Orbit> belt;
+        CounterRng rng(7, 0);
+        for (int k = 0; k < 10000; ++k) {
+            OrbitalElements e;
+            e.semiMajorAxis = rng.uniform(2.1, 3.3) * PhysicsConstants::AU;
+            e.eccentricity = rng.uniform(0.0, 0.3);
+            e.inclination = rng.uniform(0.0, 0.3);
+            e.longitudeOfAscNode = rng.uniform(0.0, 2.0 * M_PI);
+            e.argumentOfPeriapsis = rng.uniform(0.0, 2.0 * M_PI);
+            e.meanAnomaly = rng.uniform(0.0, 2.0 * M_PI);
+            e.trueAnomaly = 0.0;
+            e.epoch = 0.0;
+            belt.emplace_back(e, PhysicsConstants::SOLAR_MASS);
+        }
+
+        OrbitalElements halley;
+        halley.semiMajorAxis = 17.8 * PhysicsConstants::AU;
+        halley.eccentricity = 0.967;
+        halley.inclination = 162.3 * BenchScenarios::DEG;
+        halley.longitudeOfAscNode = 58.4 * BenchScenarios::DEG;
+        halley.argumentOfPeriapsis = 111.3 * BenchScenarios::DEG;
+        halley.meanAnomaly = 0.0;
+        halley.trueAnomaly = 0.0;
+        halley.epoch = 0.0;
+
+        std::vector<Scenario> scenarios = {
+            {"belt_10000", belt},
+            {"comet_e0.967", std::vector<Orbit>(10000, Orbit(halley, PhysicsConstants::SOLAR_MASS))},
+        };
+
+        for (const auto& sc : scenarios) {
+            if (!runner.enabled("orbit", sc.name, "getPositionAtTime")) continue;
+
+            double time = 0.0;
+            double sink = 0.0;
+            Timing t = timeSteps([&] {
+                time += 0.731 * TimeConstants::DAY;
+                for (const auto& orbit : sc.orbits) sink += orbit.getPositionAtTime(time).x;
+            }, runner.getOptions().minTime, 10, 10000000);
+            benchSink = sink;
+
+            BenchResult r;
+            r.suite = "orbit";
+            r.scenario = sc.name;
+            r.method = "getPositionAtTime";
+            r.bodies = sc.orbits.size();
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+
+        // Inverse direction: osculating elements for the whole belt per pass
+        if (runner.enabled("orbit", "belt_10000", "stateToElementsBatch")) {
+            size_t n = belt.size();
+            std::vector<double> x(n), y(n), z(n), vx(n), vy(n), vz(n), mu(n);
+            for (size_t k = 0; k < n; ++k) {
+                Vec3 p, v;
+                belt[k].getStateAtTime(0.0, p, v);
+                x[k] = p.x; y[k] = p.y; z[k] = p.z;
+                vx[k] = v.x; vy[k] = v.y; vz[k] = v.z;
+                mu[k] = belt[k].getMu();
+            }
+
+            ElementArrays elements;
+            double sink = 0.0;
+            Timing t = timeSteps([&] {
+                OrbitUtils::stateToElementsBatch(x.data(), y.data(), z.data(), vx.data(), vy.data(), vz.data(),
+                                                 mu.data(), n, elements);
+                sink += elements.meanAnomaly[n / 2];
+            }, runner.getOptions().minTime, 10, 10000000);
+            benchSink = sink;
+
+            BenchResult r;
+            r.suite = "orbit";
+            r.scenario = "belt_10000";
+            r.method = "stateToElementsBatch";
+            r.bodies = n;
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+    }
+
+    /*--- Patched-conic fleet: Earth->Mars Lambert departures with dispersed velocities ---*/
+    void benchPatchedConic(BenchRunner& runner) {
+        size_t fleet = runner.getOptions().quick ? 200 : 2000;
+        std::string scenario = "earth_mars_" + std::to_string(fleet);
+        if (!runner.enabled("conic", scenario, "propagate")) return;
+
+        SolarSystem system = BenchScenarios::keplerianPlanets();
+        const Orbit& earth = system.getOrbits().at(3);
+        const Orbit& mars = system.getOrbits().at(4);
+
+        // Departure just outside Earth's SOI, aimed at Mars 198 days later
+        double launch = 455.0 * TimeConstants::DAY, tof = 198.0 * TimeConstants::DAY;
+        Vec3 re, ve, rm, vm;
+        earth.getStateAtTime(launch, re, ve);
+        mars.getStateAtTime(launch + tof, rm, vm);
+        Vec3 start = re + ve.normalized() * 1.0e9;
+        LambertSolution transfer = LambertSolver::solve(start, rm, tof, earth.getMu());
+
+        size_t transitions = 0;
+        double sink = 0.0;
+        Timing t = timeSteps([&] {
+            PatchedConicPropagator propagator(system);
+            CounterRng rng(11, 0);
+            for (size_t k = 0; k < fleet; ++k) {
+                Vec3 dv(rng.uniform(-300.0, 300.0), rng.uniform(-300.0, 300.0), rng.uniform(-100.0, 100.0));
+                propagator.addCraft(static_cast<int>(k), 0, start, transfer.departureVelocity + dv, launch);
+            }
+            propagator.propagateTo(launch + 2.0 * tof);
+            transitions = propagator.getTransitions().size();
+            Vec3 p, v;
+            propagator.getState(0, p, v);
+            sink += p.x;
+        }, runner.getOptions().minTime, 3, 1000);
+        benchSink = sink + static_cast<double>(transitions);
+
+        BenchResult r;
+        r.suite = "conic";
+        r.scenario = scenario;
+        r.method = "propagate";
+        r.bodies = fleet;
+        r.steps = t.steps;
+        r.seconds = t.seconds;
+        runner.report(r);
+    }
+
+    /*--- Belt spatial index: per-tick refit and batched kNN vs. brute force ---*/
+    void benchSpatial(BenchRunner& runner) {
+        size_t count = runner.getOptions().quick ? 2000 : 20000;
+        size_t queryCount = 1000;
+        const size_t k = 8;
+        std::string scenario = "belt_" + std::to_string(count);
+
+        std::vector<BodyState> belt = BenchScenarios::beltParticles(count);
+        std::vector<Vec3> queries(queryCount);
+        for (size_t q = 0; q < queryCount; ++q) queries[q] = belt[(q * 7919) % count].position;
+
+        if (runner.enabled("spatial", scenario, "update")) {
+            // One day of drift per update, so refits dominate with occasional rebuilds
+            SpatialIndex index;
+            uint64_t tick = 0;
+            Timing t = timeSteps([&] {
+                for (auto& b : belt) b.position = b.position + b.velocity * TimeConstants::DAY;
+                index.update(belt, static_cast<double>(tick), tick);
+                ++tick;
+            }, runner.getOptions().minTime, 10, 100000);
+            benchSink = static_cast<double>(index.getRebuildCount());
+
+            BenchResult r;
+            r.suite = "spatial";
+            r.scenario = scenario;
+            r.method = "update";
+            r.bodies = count;
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+
+        if (runner.enabled("spatial", scenario, "knn_batch")) {
+            SpatialIndex index;
+            index.update(belt, 0.0, 0);
+            auto snapshot = index.snapshot();
+            SpatialQueryResults results;
+            double sink = 0.0;
+            Timing t = timeSteps([&] {
+                snapshot->nearestBatch(queries, k, results);
+                sink += results.hits.back().distance;
+            }, runner.getOptions().minTime, 10, 100000);
+            benchSink = sink;
+
+            BenchResult r;
+            r.suite = "spatial";
+            r.scenario = scenario;
+            r.method = "knn_batch";
+            r.bodies = count;
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+
+        if (runner.enabled("spatial", scenario, "knn_brute")) {
+            std::vector<double> distances(count);
+            double sink = 0.0;
+            Timing t = timeSteps([&] {
+                for (const Vec3& q : queries) {
+                    for (size_t i = 0; i < count; ++i) distances[i] = (belt[i].position - q).magnitudeSquared();
+                    std::nth_element(distances.begin(), distances.begin() + (k - 1), distances.end());
+                    sink += distances[k - 1];
+                }
+            }, runner.getOptions().minTime, 1, 100000);
+            benchSink = sink;
+
+            BenchResult r;
+            r.suite = "spatial";
+            r.scenario = scenario;
+            r.method = "knn_brute";
+            r.bodies = count;
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+    }
+
+    /*--- Century of planetary apsides: per-day tick scan vs. event-driven jumps ---*/
+    void benchEvents(BenchRunner& runner) {
+        const double days = 36525.0;
+        auto planets = BenchScenarios::planets();
+
+        if (runner.enabled("events", "planets_century", "tick_scan")) {
+            // Detect periapsis as the sign change of dr/dt between daily samples
+            double sink = 0.0;
+            Timing t = timeSteps([&] {
+                SolarSystem system = BenchScenarios::keplerianPlanets();
+                system.getTimeSystem().setTimeStep(TimeConstants::DAY);
+                std::vector<double> last(planets.size(), 0.0), lastDelta(planets.size(), 0.0);
+                for (int d = 0; d < static_cast<int>(days); ++d) {
+                    system.step();
+                    for (size_t k = 0; k < planets.size(); ++k) {
+                        double r = system.getBodyPosition(planets[k].id).magnitude();
+                        double delta = r - last[k];
+                        if (d > 1 && lastDelta[k] < 0.0 && delta >= 0.0) sink += r;
+                        last[k] = r;
+                        lastDelta[k] = delta;
+                    }
+                }
+            }, runner.getOptions().minTime, 3, 1000);
+            benchSink = sink;
+
+            BenchResult r;
+            r.suite = "events";
+            r.scenario = "planets_century";
+            r.method = "tick_scan";
+            r.bodies = planets.size();
+            r.steps = t.steps * static_cast<uint64_t>(days);
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+
+        if (runner.enabled("events", "planets_century", "event_jump")) {
+            double sink = 0.0;
+            Timing t = timeSteps([&] {
+                SolarSystem system = BenchScenarios::keplerianPlanets();
+                OrbitEventScheduler scheduler;
+                for (const auto& p : planets) scheduler.watch(p.id, OrbitEventMask::APSIDES);
+                scheduler.advanceTo(system, days * TimeConstants::DAY, [&](const OrbitEvent& ev) {
+                    if (ev.type == OrbitEventType::PERIAPSIS) sink += system.getBodyPosition(ev.bodyId).magnitude();
+                });
+            }, runner.getOptions().minTime, 3, 1000000);
+            benchSink = sink;
+
+            BenchResult r;
+            r.suite = "events";
+            r.scenario = "planets_century";
+            r.method = "event_jump";
+            r.bodies = planets.size();
+            r.steps = t.steps * static_cast<uint64_t>(days);
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+    }
+
+    /*--- IntegratorUtils diagnostics cost ---*/
+    void benchDiagnostics(BenchRunner& runner) {
+        struct Scenario { const char* name; std::vector<BodyState> bodies; };
+        std::vector<Scenario> scenarios = {
+            {"planets+moons", BenchScenarios::fullSystem()},
+            {"massive_1000", BenchScenarios::beltParticles(1000)},
+        };
+        for (auto& b : scenarios[1].bodies) b.mass = 1e18;
+
+        for (const auto& sc : scenarios) {
+            if (!runner.enabled("diagnostics", sc.name, "computeTotalEnergy")) continue;
+
+            double sink = 0.0;
+            Timing t = timeSteps([&] { sink += IntegratorUtils::computeTotalEnergy(sc.bodies); },
+                                 runner.getOptions().minTime, 10, 100000000);
+            benchSink = sink;
+
+            size_t n = sc.bodies.size();
+            BenchResult r;
+            r.suite = "diagnostics";
+            r.scenario = sc.name;
+            r.method = "computeTotalEnergy";
+            r.bodies = n;
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            r.pairInteractions = static_cast<double>(t.steps) * n * (n - 1) / 2.0;
+            runner.report(r);
+        }
+    }
+
+    /*--- N-body run with diagnostics + trajectory output, inline vs. pipelined ---*/
+    void benchPipeline(BenchRunner& runner) {
+        // Discards the CSV text so the bench measures formatting, not the disk
+        struct NullBuffer : std::streambuf {
+            int overflow(int c) override { return c; }
+            std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+        };
+
+        uint64_t steps = runner.getOptions().quick ? 200 : 2000;
+        for (bool pipelined : {false, true}) {
+            const char* method = pipelined ? "pipelined" : "serial";
+            if (!runner.enabled("pipeline", "planets+moons", method)) continue;
+
+            SolarSystem system;
+            system.setBodyStates(BenchScenarios::fullSystem());
+            system.setUseKeplerianOrbits(false);
+            system.setIntegrationMethod(IntegrationMethod::VELOCITY_VERLET);
+            system.getTimeSystem().setTimeStep(TimeConstants::HOUR);
+
+            NullBuffer nullBuffer;
+            std::ostream trajectory(&nullBuffer);
+            std::vector<PipelineStages::DiagnosticSample> samples;
+            samples.reserve(steps);
+
+            PipelinedRunLoop loop(system);
+            loop.setPipelined(pipelined);
+            loop.addStage("diagnostics", PipelineStages::diagnostics(samples));
+            loop.addStage("trajectory", PipelineStages::trajectoryCsv(trajectory));
+            loop.run(steps);
+
+            size_t n = system.getBodyStates().size();
+            BenchResult r;
+            r.suite = "pipeline";
+            r.scenario = "planets+moons";
+            r.method = method;
+            r.bodies = n;
+            r.steps = loop.getMetrics().steps;
+            r.seconds = loop.getMetrics().wallSeconds;
+            r.pairInteractions = static_cast<double>(r.steps) * n * (n - 1);
+            r.energyDrift = (samples.back().energy - samples.front().energy) / std::abs(samples.front().energy);
+            runner.report(r);
+        }
+    }
+
+    /*--- Lambert porkchop grid (Earth -> Mars), ns/body-step is ns per cell ---*/
+    void benchTransfer(BenchRunner& runner) {
+        auto planets = BenchScenarios::planets();
+        Orbit earth(BenchScenarios::planetElements(planets[2]), PhysicsConstants::SOLAR_MASS);
+        Orbit mars(BenchScenarios::planetElements(planets[3]), PhysicsConstants::SOLAR_MASS);
+
+        size_t side = runner.getOptions().quick ? 300 : 1000;
+        PorkchopConfig config;
+        config.launchEnd = 3.0 * TimeConstants::YEAR;
+        config.launchSteps = side;
+        config.tofMin = 60.0 * TimeConstants::DAY;
+        config.tofMax = 500.0 * TimeConstants::DAY;
+        config.tofSteps = side;
+
+        WorkStealingPool pool;
+        struct Variant { const char* method; WorkStealingPool* pool; };
+        const Variant variants[] = {{"porkchop_serial", nullptr}, {"porkchop_pool", &pool}};
+
+        for (const auto& v : variants) {
+            std::string scenario = "earth_mars_" + std::to_string(side) + "x" + std::to_string(side);
+            if (!runner.enabled("transfer", scenario, v.method)) continue;
+            if (v.pool && pool.getThreadCount() < 2) continue;
+
+            TransferSearch search(earth, mars, v.pool);
+            double sink = 0.0;
+            Timing t = timeSteps([&] { sink += search.computeGrid(config).departureVInf[side / 2]; },
+                                 runner.getOptions().minTime, 2, 1000);
+            benchSink = sink;
+
+            BenchResult r;
+            r.suite = "transfer";
+            r.scenario = scenario;
+            r.method = v.method;
+            r.bodies = side * side;
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+
+        // Daily ticks of the 8-planet transfer matrix with a full row of
+        // lookups per tick: every pair each tick vs. the synodic schedule
+        std::vector<int> ids;
+        for (const auto& p : planets) ids.push_back(p.id);
+        const int days = 3652;
+        for (bool incremental : {false, true}) {
+            const char* method = incremental ? "matrix_incremental" : "matrix_every_tick";
+            if (!runner.enabled("transfer", "planets_decade", method)) continue;
+
+            double sink = 0.0;
+            Timing t = timeSteps([&] {
+                SolarSystem system = BenchScenarios::keplerianPlanets();
+                system.getTimeSystem().setTimeStep(TimeConstants::DAY);
+                TransferMatrix matrix(ids);
+                for (int d = 0; d < days; ++d) {
+                    system.step();
+                    if (incremental) matrix.update(system);
+                    else matrix.refreshAll(system);
+                    for (int to : ids) sink += matrix.getTravelTime(3, to, system.getTimeSystem().getCurrentTime());
+                }
+            }, runner.getOptions().minTime, 2, 1000);
+            benchSink = sink;
+
+            BenchResult r;
+            r.suite = "transfer";
+            r.scenario = "planets_decade";
+            r.method = method;
+            r.bodies = ids.size();
+            r.steps = t.steps * days;
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+    }
+
+    /*--- A year of daily ticks over many colonies: Poisson scheduling vs. per-tick Bernoulli draws ---*/
+    void benchHumanity(BenchRunner& runner) {
+        // Mostly rare events, as in the mission data: most ticks fire nothing
+        const char* techJson = R"([
+            {"id": "shielding", "cost": 50, "effects": {"storm": 0.25}},
+            {"id": "governance", "cost": 120, "requires": ["shielding"], "effects": {"unrest": 0.5}}
+        ])";
+        const char* eventJson = R"([
+            {"id": "storm", "rate": 0.05, "effects": {"stability": -0.02}},
+            {"id": "unrest", "rate": 0.2, "maxStability": 0.6, "effects": {"stability": -0.1}},
+            {"id": "reform", "rate": 0.1, "maxStability": 0.8, "effects": {"stability": 0.15}},
+            {"id": "breach", "rate": 0.02, "effects": {"population": -0.02}},
+            {"id": "boom", "rate": 0.05, "minStability": 0.7, "effects": {"population": 0.05}},
+            {"id": "plague", "rate": 0.001, "effects": {"population": -0.3}},
+            {"id": "discovery", "rate": 0.01, "requires": ["governance"], "effects": {"research": 40}},
+            {"id": "impact", "rate": 1e-8, "repeatable": false, "effects": {"collapse": true}}
+        ])";
+        const char* civJson = R"([
+            {"name": "bench", "researchRate": 20,
+             "colonies": [{"name": "colony", "population": 1e6, "stability": 0.7}]}
+        ])";
+        JsonValue techs, events, civs;
+        JsonValue::parse(techJson, techs);
+        JsonValue::parse(eventJson, events);
+        JsonValue::parse(civJson, civs);
+
+        size_t count = runner.getOptions().quick ? 1000 : 10000;
+        std::string scenario = "colonies_" + std::to_string(count);
+        const int days = 365;
+
+        if (runner.enabled("humanity", scenario, "poisson")) {
+            double sink = 0.0;
+            uint64_t seed = 0;
+            Timing t = timeSteps([&] {
+                EventEngine engine(++seed);
+                engine.compile(techs, events);
+                engine.loadCivilizations(civs, count);
+                for (int d = 0; d < days; ++d) sink += static_cast<double>(engine.advance(TimeConstants::DAY));
+            }, runner.getOptions().minTime, 3, 1000);
+            benchSink = sink;
+
+            BenchResult r;
+            r.suite = "humanity";
+            r.scenario = scenario;
+            r.method = "poisson";
+            r.bodies = count;
+            r.steps = t.steps * days;
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+
+        if (runner.enabled("humanity", scenario, "bernoulli")) {
+            // Every event of every colony rolled each tick at the starting rates
+            // (no state updates), i.e. a lower bound for the per-tick approach
+            EventEngine engine;
+            engine.compile(techs, events);
+            engine.loadCivilizations(civs, count);
+            const size_t eventCount = engine.getEventCount();
+            std::vector<double> chance(count * eventCount);
+            for (size_t c = 0; c < count; ++c) {
+                for (size_t e = 0; e < eventCount; ++e) chance[c * eventCount + e] = engine.getRate(c, e) * TimeConstants::DAY;
+            }
+
+            double sink = 0.0;
+            uint64_t seed = 0;
+            Timing t = timeSteps([&] {
+                CounterRng rng(++seed, 0);
+                for (int d = 0; d < days; ++d) {
+                    for (double p : chance) sink += rng.uniform() < p ? 1.0 : 0.0;
+                }
+            }, runner.getOptions().minTime, 3, 1000);
+            benchSink = sink;
+
+            BenchResult r;
+            r.suite = "humanity";
+            r.scenario = scenario;
+            r.method = "bernoulli";
+            r.bodies = count;
+            r.steps = t.steps * days;
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+    }
+
+    /*--- Random seeks into a recorded N-body run (ns/body-step is ns per seek per body) ---*/
+    void benchHistory(BenchRunner& runner) {
+        const uint64_t ticks = runner.getOptions().quick ? 5000 : 50000;
+        std::string scenario = "full_" + std::to_string(ticks) + "h";
+        for (bool reverse : {false, true}) {
+            const char* method = reverse ? "seek_reverse" : "seek_replay";
+            if (!runner.enabled("history", scenario, method)) continue;
+
+            SolarSystem system;
+            system.setUseKeplerianOrbits(false);
+            system.setBodyStates(BenchScenarios::fullSystem());
+            for (auto& s : system.getBodyStates()) s.acceleration = Integrator::nBodyAcceleration(s, system.getBodyStates());
+            system.getTimeSystem().setTimeStep(TimeConstants::HOUR);
+            KeyframeConfig config;
+            config.reverseReplay = reverse;
+            system.setHistoryRecording(true, config);
+            for (uint64_t k = 0; k < ticks; ++k) system.step();
+
+            CounterRng rng(11, 0);
+            double sink = 0.0;
+            Timing t = timeSteps([&] {
+                SeekResult r = system.seekTo(rng.uniform(0.0, static_cast<double>(ticks)) * TimeConstants::HOUR);
+                sink += static_cast<double>(r.steps);
+            }, runner.getOptions().minTime, 10, 100000);
+            benchSink = sink;
+
+            BenchResult r;
+            r.suite = "history";
+            r.scenario = scenario;
+            r.method = method;
+            r.bodies = system.getBodyStates().size();
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+    }
+
+    /*--- Stellar flares over a year of hourly ticks: scheduled vs. rolled every tick ---*/
+    void benchFlares(BenchRunner& runner) {
+        const size_t count = runner.getOptions().quick ? 100 : 1000;
+        std::string scenario = "stars_" + std::to_string(count);
+        const int hours = 365 * 24;
+        const double rate = 1.0 / TimeConstants::DAY;
+        const double intensity = 0.3;
+        const double decayTime = 0.5 * TimeConstants::DAY;
+
+        for (bool scheduled : {false, true}) {
+            const char* method = scheduled ? "poisson" : "bernoulli";
+            if (!runner.enabled("flares", scenario, method)) continue;
+
+            std::vector<Star> stars;
+            for (size_t k = 0; k < count; ++k) {
+                stars.emplace_back(static_cast<int>(k), "star", CelestialBody::BodyType::STAR,
+                                   PhysicsConstants::SOLAR_MASS, 6.96e8);
+                stars.back().updateActivityLevel(0.2);
+                stars.back().setFlareModel(rate, intensity, decayTime);
+                stars.back().seedRandomStream(5, k);
+            }
+            // Per-tick reference: one draw per star per tick, excess decayed every tick
+            std::vector<double> excess(count, 0.0);
+            std::vector<CounterRng> rngs;
+            for (size_t k = 0; k < count; ++k) rngs.emplace_back(5, k);
+            const double tickDecay = std::exp(-TimeConstants::HOUR / decayTime);
+
+            double sink = 0.0;
+            Timing t = timeSteps([&] {
+                for (int h = 1; h <= hours; ++h) {
+                    for (size_t k = 0; k < count; ++k) {
+                        if (scheduled) {
+                            sink += static_cast<double>(stars[k].advanceActivity(h * TimeConstants::HOUR));
+                            continue;
+                        }
+                        double level = 0.2 + excess[k];
+                        if (rngs[k].uniform() < rate * level * TimeConstants::HOUR) {
+                            excess[k] = std::min(1.0, level + intensity) - 0.2;
+                            sink += 1.0;
+                        }
+                        excess[k] *= tickDecay;
+                    }
+                }
+                for (Star& star : stars) star.startActivity(0.0);
+            }, runner.getOptions().minTime, 3, 1000);
+            benchSink = sink;
+
+            BenchResult r;
+            r.suite = "flares";
+            r.scenario = scenario;
+            r.method = method;
+            r.bodies = count;
+            r.steps = t.steps * hours;
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+    }
+
+    /*--- Belt particles under the planets: all N-body vs. promoted into Keplerian mode ---*/
+    // Same start for both rows: the hybrid system, seeded barycentric for N-body
+    void benchHybrid(BenchRunner& runner) {
+        const size_t count = 256;
+        std::string scenario = "belt_" + std::to_string(count);
+        for (bool hybrid : {false, true}) {
+            const char* method = hybrid ? "hybrid" : "nbody_all";
+            if (!runner.enabled("hybrid", scenario, method)) continue;
+
+            SolarSystem system = BenchScenarios::keplerianPlanets();
+            system.getTimeSystem().setTimeStep(TimeConstants::DAY);
+            for (const BodyState& p : BenchScenarios::beltParticles(count)) {
+                system.getBodyStates().push_back(p);
+                system.promoteToNumerical(p.id);
+            }
+            if (!hybrid) {
+                system.initializeBodyStates(true);
+                system.setUseKeplerianOrbits(false);
+            }
+            Timing t = timeSteps([&] { system.step(); }, runner.getOptions().minTime, 10, 1000000);
+            benchSink = system.getBodyStates().back().position.x;
+
+            BenchResult r;
+            r.suite = "hybrid";
+            r.scenario = scenario;
+            r.method = method;
+            r.bodies = system.getBodyStates().size();
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            runner.report(r);
+        }
+    }
+
+    /*--- Planets over millennia: direct RK4 vs. Laplace-Lagrange secular mode ---*/
+    // The energy column of the laplace row is its largest eccentricity-vector
+    // error against the direct row over the span, not a drift
+    void benchSecular(BenchRunner& runner) {
+        const int kyr = runner.getOptions().quick ? 1 : 10;
+        std::string scenario = "planets_" + std::to_string(kyr) + "kyr";
+        const double span = kyr * 1000.0 * TimeConstants::YEAR;
+        const bool direct = runner.enabled("secular", scenario, "direct_rk4");
+        const bool laplace = runner.enabled("secular", scenario, "laplace");
+        if (!direct && !laplace) return;
+
+        SolarSystem system = BenchScenarios::keplerianPlanets();
+        system.setSecularMode(true);
+        const double dt = 0.5 * TimeConstants::DAY;     // Mercury in 176 steps
+        SecularErrorReport report = system.getSecularSystem()->compareWithDirect(span, dt, 100);
+
+        if (direct) {
+            BenchResult r;
+            r.suite = "secular";
+            r.scenario = scenario;
+            r.method = "direct_rk4";
+            r.bodies = report.ids.size() + 1;
+            r.steps = static_cast<uint64_t>(std::ceil(span / dt));
+            r.seconds = report.directSeconds;
+            runner.report(r);
+        }
+        if (laplace) {
+            // Thousand-year steps through SolarSystem, orbits rewritten each step
+            system.getTimeSystem().setTimeStep(1000.0 * TimeConstants::YEAR);
+            Timing t = timeSteps([&] { system.step(); }, runner.getOptions().minTime, 10, 10000000);
+            benchSink = system.getBodyPosition(3).x;
+
+            BenchResult r;
+            r.suite = "secular";
+            r.scenario = scenario;
+            r.method = "laplace";
+            r.bodies = report.ids.size();
+            r.steps = t.steps;
+            r.seconds = t.seconds;
+            r.energyDrift = report.maxEccentricityError;
+            runner.report(r);
+        }
+    }
+
+    void printUsage() {
+        std::cout << "usage: solarsys_bench [--json] [--out FILE] [--quick] [--filter TEXT] [--min-time SECONDS]\n"
+                  << "                      [--trace FILE]\n"
+                  << "  filter matches suite/scenario/method, e.g. --filter particles_10000/rk4\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--json") options.json = true;
+        else if (arg == "--quick") { options.quick = true; options.minTime = 0.1; }
+        else if (arg == "--out" && i + 1 < argc) options.outPath = argv[++i];
+        else if (arg == "--filter" && i + 1 < argc) options.filter = argv[++i];
+        else if (arg == "--min-time" && i + 1 < argc) options.minTime = std::atof(argv[++i]);
+        else if (arg == "--trace" && i + 1 < argc) options.tracePath = argv[++i];
+        else { printUsage(); return arg == "--help" ? 0 : 1; }
+    }
+
+    if (!options.tracePath.empty()) Profiler::setTraceEnabled(true);
+
+    BenchRunner runner(options);
+    benchIntegrators(runner);
+    benchEnsemble(runner);
+    benchStepModes(runner);
+    benchOrbitEvaluation(runner);
+    benchDiagnostics(runner);
+    benchPipeline(runner);
+    benchTestParticles(runner);
+    benchForces(runner);
+#ifdef SOLARSYS_HAS_NET
+    benchShards(runner);
+#endif
+    benchTransfer(runner);
+    benchEvents(runner);
+    benchPatchedConic(runner);
+    benchSpatial(runner);
+    benchHumanity(runner);
+    benchHistory(runner);
+    benchHybrid(runner);
+    benchFlares(runner);
+    benchSecular(runner);
+
+    if (Profiler::isCompiledIn() && !options.json) Profiler::printReport(std::cout);
+    if (!options.tracePath.empty() && !Profiler::writeChromeTrace(options.tracePath)) {
+        std::cerr << "could not write trace to " << options.tracePath << "\n";
+        return 1;
+    }
+    return 0;
+}
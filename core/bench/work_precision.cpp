@@ -0,0 +1,366 @@
+#include "BenchScenarios.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Work-precision sweep of the integrators: every method x timestep on a few
+// standard scenarios, scored against a converged high-accuracy reference.
+//
+//   solarsys_workprec [--csv | --json] [--out FILE] [--quick] [--filter TEXT]
+//                     [--min-time SECONDS] [--max-error METERS] [--max-drift REL]
+//
+// Each row is one point of a work-precision curve: cost (per-body force
+// evaluations and wall time) against accuracy (largest final position error
+// over all bodies and the largest relative energy excursion during the run).
+// Three paths are swept: "step" is SolarSystem::step() (bodies updated in
+// place, one after the other), "step+reg" the same with close-encounter
+// regularization (each leapfrog kick counts as one evaluation) and "ensemble"
+// is Integrator::stepEnsemble() (all bodies from one force evaluation). The
+// reference is ensemble RK4 at 1/16 of the finest step of the full ladder
+// (--quick included); its own error is estimated against half that step and
+// printed with the scenario. After each scenario the cheapest configuration
+// meeting --max-error and --max-drift is reported.
+
+namespace {
+
+    struct Options {
+        bool csv = false;
+        bool json = false;
+        bool quick = false;
+        std::string outPath;
+        std::string filter;
+        double minTime = 0.05;      // repeat short runs until timed this long
+        double maxError = 1.0e6;    // m
+        double maxDrift = 1.0e-6;
+    };
+
+    struct Scenario {
+        const char* name;
+        std::vector<BodyState> bodies;
+        double span;                    // s
+        std::vector<double> stepDays;   // swept timesteps
+        double referenceDays = 0.0;
+    };
+
+    enum class Path { STEP, REGULARIZED, ENSEMBLE };
+    const Path ALL_PATHS[] = { Path::STEP, Path::REGULARIZED, Path::ENSEMBLE };
+
+    const char* pathName(Path path) {
+        switch (path) {
+            case Path::STEP: return "step";
+            case Path::REGULARIZED: return "step+reg";
+            case Path::ENSEMBLE: return "ensemble";
+        }
+        return "unknown";
+    }
+
+    struct Point {
+        std::string scenario;
+        const char* path;
+        const char* method;
+        double dt = 0.0;
+        uint64_t steps = 0;
+        double forceEvaluations = 0.0;  // per-body acceleration evaluations + regularized kicks
+        double seconds = 0.0;
+        double positionError = 0.0;     // m, max over bodies at the end
+        double energyDrift = 0.0;       // max |E - E0| / |E0| over the run
+    };
+
+    struct RunResult {
+        std::vector<BodyState> states;     // at the end of the run
+        double energyDrift = 0.0;
+        double seconds = 0.0;
+        double encounterKicks = 0.0;
+    };
+
+    const IntegrationMethod ALL_METHODS[] = {
+        IntegrationMethod::EULER, IntegrationMethod::SYMPLECTIC_EULER,
+        IntegrationMethod::VELOCITY_VERLET, IntegrationMethod::RK4
+    };
+
+    const char* methodName(IntegrationMethod m) {
+        switch (m) {
+            case IntegrationMethod::EULER: return "euler";
+            case IntegrationMethod::SYMPLECTIC_EULER: return "symplectic_euler";
+            case IntegrationMethod::VELOCITY_VERLET: return "velocity_verlet";
+            case IntegrationMethod::RK4: return "rk4";
+        }
+        return "unknown";
+    }
+
+    // Acceleration evaluations per body per step (both paths)
+    int evaluationsPerStep(IntegrationMethod m) {
+        return m == IntegrationMethod::RK4 ? 5 : 1;
+    }
+
+    constexpr size_t ENERGY_SAMPLES = 256;
+
+    double steadySeconds() {
+        using namespace std::chrono;
+        return duration<double>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Integrates `steps` steps of dt; energy sampling is excluded from the timing
+    RunResult integrate(const std::vector<BodyState>& initial, Path path, IntegrationMethod method,
+                        double dt, uint64_t steps) {
+        RunResult result;
+        double e0 = IntegratorUtils::computeTotalEnergy(initial);
+        uint64_t sampleEvery = std::max<uint64_t>(1, steps / ENERGY_SAMPLES);
+        auto sample = [&](const std::vector<BodyState>& bodies) {
+            double drift = std::abs(IntegratorUtils::computeTotalEnergy(bodies) - e0) / std::abs(e0);
+            // NaN once a run blows up must not read as "no drift"
+            result.energyDrift = std::isnan(drift) ? drift : std::max(result.energyDrift, drift);
+        };
+
+        if (path != Path::ENSEMBLE) {
+            SolarSystem system;
+            system.setBodyStates(initial);
+            system.setUseKeplerianOrbits(false);
+            system.setIntegrationMethod(method);
+            system.setEncounterRegularization(path == Path::REGULARIZED);
+            system.getTimeSystem().setTimeStep(dt);
+            for (uint64_t done = 0; done < steps;) {
+                uint64_t chunk = std::min(sampleEvery, steps - done);
+                double start = steadySeconds();
+                for (uint64_t k = 0; k < chunk; ++k) system.step();
+                result.seconds += steadySeconds() - start;
+                done += chunk;
+                sample(system.getBodyStates());
+            }
+            result.states = system.getBodyStates();
+            result.encounterKicks = static_cast<double>(system.getEncounterStats().kicks);
+        } else {
+            EnsembleState ensemble = EnsembleState::broadcast(initial, 1);
+            for (uint64_t done = 0; done < steps;) {
+                uint64_t chunk = std::min(sampleEvery, steps - done);
+                double start = steadySeconds();
+                for (uint64_t k = 0; k < chunk; ++k) Integrator::stepEnsemble(ensemble, dt, method);
+                result.seconds += steadySeconds() - start;
+                done += chunk;
+                sample(ensemble.getLane(0));
+            }
+            result.states = ensemble.getLane(0);
+        }
+        return result;
+    }
+
+    double maxPositionError(const std::vector<BodyState>& a, const std::vector<BodyState>& b) {
+        double worst = 0.0;
+        for (size_t k = 0; k < a.size() && k < b.size(); ++k) {
+            double error = (a[k].position - b[k].position).magnitude();
+            if (std::isnan(error)) return error;
+            worst = std::max(worst, error);
+        }
+        return worst;
+    }
+
+    bool meets(const Point& p, const Options& options) {
+        return p.positionError <= options.maxError && p.energyDrift <= options.maxDrift;
+    }
+
+    class Reporter {
+    private:
+        Options options;
+        std::ofstream out;
+
+    public:
+        explicit Reporter(const Options& opts) : options(opts) {
+            if (!options.outPath.empty()) out.open(options.outPath, std::ios::app);
+            if (options.csv) {
+                std::printf("scenario,path,method,dt_days,steps,force_evaluations,seconds,position_error_m,energy_drift\n");
+            } else if (!options.json) {
+                std::printf("%-12s %-9s %-17s %9s %9s %12s %10s %12s %12s\n", "scenario", "path", "method",
+                            "dt [d]", "steps", "force evals", "seconds", "pos err [m]", "energy drift");
+            }
+        }
+
+        void report(const Point& p) {
+            std::string line = toJson(p);
+            if (out) out << line << "\n";
+            if (options.json) {
+                std::cout << line << std::endl;
+            } else if (options.csv) {
+                std::printf("%s,%s,%s,%.9g,%llu,%.9g,%.6g,%.6g,%.6g\n", p.scenario.c_str(), p.path, p.method,
+                            p.dt / TimeConstants::DAY, static_cast<unsigned long long>(p.steps),
+                            p.forceEvaluations, p.seconds, p.positionError, p.energyDrift);
+            } else {
+                std::printf("%-12s %-9s %-17s %9.4g %9llu %12.4g %10.4g %12.4g %12.3g\n", p.scenario.c_str(),
+                            p.path, p.method, p.dt / TimeConstants::DAY, static_cast<unsigned long long>(p.steps),
+                            p.forceEvaluations, p.seconds, p.positionError, p.energyDrift);
+            }
+            std::fflush(stdout);
+        }
+
+        // Comment lines, so CSV and JSON Lines output stays machine-readable
+        void note(const std::string& text) {
+            std::printf("%s%s\n", options.csv || options.json ? "# " : "", text.c_str());
+            std::fflush(stdout);
+        }
+
+    private:
+        static std::string number(double v) {
+            if (!std::isfinite(v)) return "null";
+            std::ostringstream s;
+            s.precision(9);
+            s << v;
+            return s.str();
+        }
+
+        static std::string toJson(const Point& p) {
+            std::ostringstream s;
+            s << "{\"scenario\":\"" << p.scenario << "\",\"path\":\"" << p.path << "\",\"method\":\"" << p.method
+              << "\",\"dt_days\":" << number(p.dt / TimeConstants::DAY) << ",\"steps\":" << p.steps
+              << ",\"force_evaluations\":" << number(p.forceEvaluations)
+              << ",\"seconds\":" << number(p.seconds)
+              << ",\"position_error_m\":" << number(p.positionError)
+              << ",\"energy_drift\":" << number(p.energyDrift) << "}";
+            return s.str();
+        }
+    };
+
+    std::string describe(const Point& p) {
+        char text[160];
+        std::snprintf(text, sizeof(text), "%s %s dt=%.4g d (%.4g force evals, %.3g s, err %.3g m, drift %.3g)",
+                      p.path, p.method, p.dt / TimeConstants::DAY, p.forceEvaluations, p.seconds,
+                      p.positionError, p.energyDrift);
+        return text;
+    }
+
+    std::string keyOf(const Scenario& sc, Path path, IntegrationMethod method) {
+        return std::string(sc.name) + "/" + pathName(path) + "/" + methodName(method);
+    }
+
+    bool selected(const std::string& key, const Options& options) {
+        return options.filter.empty() || key.find(options.filter) != std::string::npos;
+    }
+
+    void sweep(const Scenario& sc, const Options& options, Reporter& reporter) {
+        bool any = false;
+        for (Path path : ALL_PATHS) {
+            for (IntegrationMethod method : ALL_METHODS) any = any || selected(keyOf(sc, path, method), options);
+        }
+        if (!any) return;
+
+        auto stepsFor = [&sc](double dt) { return static_cast<uint64_t>(std::llround(sc.span / dt)); };
+
+        // Reference, and its error estimate from a run at half its step
+        uint64_t refSteps = stepsFor(sc.referenceDays * TimeConstants::DAY);
+        RunResult reference = integrate(sc.bodies, Path::ENSEMBLE, IntegrationMethod::RK4, sc.span / refSteps, refSteps);
+        RunResult check = integrate(sc.bodies, Path::ENSEMBLE, IntegrationMethod::RK4,
+                                    sc.span / (2 * refSteps), 2 * refSteps);
+        char text[200];
+        std::snprintf(text, sizeof(text), "%s: %zu bodies over %.4g years, reference ensemble rk4 dt=%.4g d, "
+                      "reference error ~%.3g m", sc.name, sc.bodies.size(), sc.span / TimeConstants::YEAR,
+                      sc.span / refSteps / TimeConstants::DAY, maxPositionError(reference.states, check.states));
+        reporter.note(text);
+
+        const Point* cheapestWork = nullptr;
+        const Point* cheapestTime = nullptr;
+        std::vector<Point> points;
+        points.reserve(3 * (sizeof(ALL_METHODS) / sizeof(ALL_METHODS[0])) * sc.stepDays.size());
+
+        for (Path path : ALL_PATHS) {
+            for (IntegrationMethod method : ALL_METHODS) {
+                if (!selected(keyOf(sc, path, method), options)) continue;
+
+                for (double days : sc.stepDays) {
+                    uint64_t steps = stepsFor(days * TimeConstants::DAY);
+                    double dt = sc.span / steps;    // every run ends exactly at the span
+
+                    // Runs are deterministic: repeat only to time short ones reliably
+                    RunResult run = integrate(sc.bodies, path, method, dt, steps);
+                    double seconds = run.seconds;
+                    int repeats = 1;
+                    while (seconds < options.minTime) {
+                        seconds += integrate(sc.bodies, path, method, dt, steps).seconds;
+                        ++repeats;
+                    }
+
+                    Point p;
+                    p.scenario = sc.name;
+                    p.path = pathName(path);
+                    p.method = methodName(method);
+                    p.dt = dt;
+                    p.steps = steps;
+                    p.forceEvaluations = static_cast<double>(steps) * evaluationsPerStep(method) * sc.bodies.size() +
+                                         run.encounterKicks;
+                    p.seconds = seconds / repeats;
+                    p.positionError = maxPositionError(run.states, reference.states);
+                    p.energyDrift = run.energyDrift;
+                    reporter.report(p);
+                    points.push_back(p);
+                }
+            }
+        }
+
+        for (const Point& p : points) {
+            if (!meets(p, options)) continue;
+            if (!cheapestWork || p.forceEvaluations < cheapestWork->forceEvaluations) cheapestWork = &p;
+            if (!cheapestTime || p.seconds < cheapestTime->seconds) cheapestTime = &p;
+        }
+        std::snprintf(text, sizeof(text), "%s: target error <= %.3g m, drift <= %.3g", sc.name,
+                      options.maxError, options.maxDrift);
+        reporter.note(text);
+        if (!cheapestWork) {
+            reporter.note("  no swept configuration meets the target");
+            return;
+        }
+        reporter.note("  fewest force evals: " + describe(*cheapestWork));
+        reporter.note("  least wall time:    " + describe(*cheapestTime));
+    }
+
+    // Timestep ladder: count values doubling from `finest` days
+    std::vector<double> ladder(double finest, int count) {
+        std::vector<double> days;
+        for (int k = 0; k < count; ++k) days.push_back(finest * std::ldexp(1.0, k));
+        return days;
+    }
+
+    void printUsage() {
+        std::cout << "usage: solarsys_workprec [--csv | --json] [--out FILE] [--quick] [--filter TEXT]\n"
+                  << "                         [--min-time SECONDS] [--max-error METERS] [--max-drift REL]\n"
+                  << "  filter matches scenario/path/method, e.g. --filter comet/ensemble\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--csv") options.csv = true;
+        else if (arg == "--json") options.json = true;
+        else if (arg == "--quick") options.quick = true;
+        else if (arg == "--out" && i + 1 < argc) options.outPath = argv[++i];
+        else if (arg == "--filter" && i + 1 < argc) options.filter = argv[++i];
+        else if (arg == "--min-time" && i + 1 < argc) options.minTime = std::atof(argv[++i]);
+        else if (arg == "--max-error" && i + 1 < argc) options.maxError = std::atof(argv[++i]);
+        else if (arg == "--max-drift" && i + 1 < argc) options.maxDrift = std::atof(argv[++i]);
+        else { printUsage(); return arg == "--help" ? 0 : 1; }
+    }
+
+    // --quick keeps the same ladders but drops the finest rungs
+    int drop = options.quick ? 3 : 0;
+    std::vector<Scenario> scenarios = {
+        {"sun_jup_sat", BenchScenarios::sunJupiterSaturn(), 100.0 * TimeConstants::YEAR, ladder(1.0, 8)},
+        {"inner", BenchScenarios::innerSystem(), 10.0 * TimeConstants::YEAR, ladder(0.125, 8)},
+        // One full orbit (P ~ 75.3 yr), through perihelion at mid-run
+        {"comet", BenchScenarios::eccentricComet(), 75.3 * TimeConstants::YEAR, ladder(0.25, 8)},
+        {"flyby", BenchScenarios::earthFlyby(), 7.0 * TimeConstants::DAY, ladder(60.0 / TimeConstants::DAY, 8)},
+    };
+
+    Reporter reporter(options);
+    for (Scenario& sc : scenarios) {
+        sc.referenceDays = sc.stepDays.front() / 16.0;
+        sc.stepDays.erase(sc.stepDays.begin(), sc.stepDays.begin() + drop);
+        sweep(sc, options, reporter);
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+#ifndef SOLARSYS_CORE_CAPI_SOLARSYS_C_H
+#define SOLARSYS_CORE_CAPI_SOLARSYS_C_H
+
+/*--- Stable C ABI over solarsys_core (libsolarsys_c) ---*/
+/*
+ * Opaque handle + plain C types only, so ctypes/cffi (interface/python_c_bindings)
+ * and other languages can bind without a C++ toolchain. Calls return
+ * SOLARSYS_OK (0) or a negative status; solarsys_last_error() describes the last
+ * failure on the calling thread.
+ *
+ * Body state is exposed zero-copy: solarsys_get_state_view() returns the base
+ * address, element stride and field offsets of the engine's own state array, which
+ * NumPy can wrap with explicit strides. The view stays valid until the body count
+ * changes; `generation` increments whenever the storage is reallocated.
+ * Step in batches (solarsys_step_n) so the FFI cost is paid once per batch.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #define SOLARSYS_C_API __declspec(dllexport)
+#else
+    #define SOLARSYS_C_API __attribute__((visibility("default")))
+#endif
+
+#define SOLARSYS_C_ABI_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--- Status codes ---*/
+enum {
+    SOLARSYS_OK = 0,
+    SOLARSYS_ERR_INVALID_ARGUMENT = -1,
+    SOLARSYS_ERR_IO = -2,
+    SOLARSYS_ERR_PARSE = -3,
+    SOLARSYS_ERR_STATE = -4
+};
+
+/*--- Integration methods (mirror IntegrationMethod) ---*/
+enum {
+    SOLARSYS_EULER = 0,
+    SOLARSYS_SYMPLECTIC_EULER = 1,
+    SOLARSYS_VELOCITY_VERLET = 2,
+    SOLARSYS_RK4 = 3
+};
+
+typedef struct solarsys_system solarsys_system;
+
+/*--- Zero-copy description of the body state array ---*/
+typedef struct {
+    const void* base;           /* first element */
+    size_t count;               /* number of bodies */
+    size_t stride;              /* bytes between consecutive bodies */
+    size_t id_offset;           /* int32 */
+    size_t mass_offset;         /* double */
+    size_t position_offset;     /* double[3], meters */
+    size_t velocity_offset;     /* double[3], m/s */
+    size_t acceleration_offset; /* double[3], m/s^2 */
+    uint64_t generation;        /* bumps when base/count change */
+} solarsys_state_view;
+
+/*--- Zero-copy view of the environment pass arrays (index-aligned) ---*/
+typedef struct {
+    size_t count;
+    const int32_t* ids;
+    const double* distance;     /* heliocentric, meters */
+    const double* irradiance;   /* W/m^2 */
+    const double* coma_radius;  /* meters, 0 for non-comets */
+    const uint8_t* active_tail; /* 0/1 */
+    size_t pending_events;      /* transitions waiting in solarsys_take_environment_events */
+} solarsys_environment_view;
+
+/*--- Comet tail transition (mirror EnvironmentEvent) ---*/
+typedef struct {
+    int32_t body_id;
+    int32_t activated;          /* 1 = tail switched on, 0 = switched off */
+    double time;                /* simulation seconds */
+    double distance;            /* meters */
+} solarsys_environment_event;
+
+/*--- Lifecycle ---*/
+SOLARSYS_C_API int solarsys_abi_version(void);
+SOLARSYS_C_API solarsys_system* solarsys_create(void);
+SOLARSYS_C_API void solarsys_destroy(solarsys_system* system);
+SOLARSYS_C_API const char* solarsys_last_error(void);
+
+/*--- Scenario setup ---*/
+SOLARSYS_C_API int solarsys_load_planets_json(solarsys_system* system, const char* path);
+SOLARSYS_C_API int solarsys_add_body(solarsys_system* system, int32_t id, double mass,
+                                     const double position[3], const double velocity[3]);
+SOLARSYS_C_API int solarsys_set_time_step(solarsys_system* system, double seconds);
+SOLARSYS_C_API int solarsys_set_integration_method(solarsys_system* system, int method);
+SOLARSYS_C_API int solarsys_set_keplerian(solarsys_system* system, int enabled);
+
+/*--- Stepping ---*/
+SOLARSYS_C_API int solarsys_step_n(solarsys_system* system, uint64_t steps);
+
+/*--- Queries ---*/
+SOLARSYS_C_API double solarsys_get_time(const solarsys_system* system);
+SOLARSYS_C_API uint64_t solarsys_get_tick(const solarsys_system* system);
+SOLARSYS_C_API size_t solarsys_body_count(const solarsys_system* system);
+SOLARSYS_C_API int solarsys_get_state_view(solarsys_system* system, solarsys_state_view* out);
+SOLARSYS_C_API double solarsys_total_energy(const solarsys_system* system);
+
+/*--- Environment pass (irradiance, comet tails, coma) ---*/
+/* interval > 0 runs the pass inside solarsys_step_n every `interval` ticks; 0 disables it.
+ * Arrays stay valid until the next step or configure call. Events accumulate until taken. */
+SOLARSYS_C_API int solarsys_configure_environment(solarsys_system* system, uint32_t interval, double hysteresis);
+SOLARSYS_C_API int solarsys_get_environment_view(solarsys_system* system, solarsys_environment_view* out);
+SOLARSYS_C_API int solarsys_take_environment_events(solarsys_system* system, solarsys_environment_event* out,
+                                                    size_t capacity, size_t* written);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SOLARSYS_CORE_CAPI_SOLARSYS_C_H */
@@ -8,16 +8,17 @@ protected:
     /*--- Operational info ---*/
     std::string owner;          // country / organization
     std::string purpose;        // e.g., "Communication", "Weather", "Navigation"
-    double launchDate;          // year or unix timestamp
+    double launchDate = 0.0;    // year or unix timestamp
 
     /*--- Orbital characteristics ---*/
-    double semiMajorAxis;       // meters
-    double eccentricity;
-    double inclination;         // radians
+    double semiMajorAxis = 0.0; // meters (negative on escape trajectories)
+    double eccentricity = 0.0;
+    double inclination = 0.0;   // radians
+    int centralBodyId = 0;      // body whose sphere of influence holds the orbit
 
     /*--- Status ---*/
     std::string status;         // e.g., "Active", "Inactive", "Decommissioned"
-    double remainingFuel;       // percentage or kg
+    double remainingFuel = 0.0; // percentage or kg
 
 public:
     /*--- Constructors & Destructors ---*/
@@ -31,6 +32,7 @@ public:
     double getSemiMajorAxis() const { return semiMajorAxis; }
     double getEccentricity() const { return eccentricity; }
     double getInclination() const { return inclination; }
+    int getCentralBodyId() const { return centralBodyId; }
     std::string getStatus() const { return status; }
     double getRemainingFuel() const { return remainingFuel; }
 
@@ -41,6 +43,7 @@ public:
     void setSemiMajorAxis(double a) { semiMajorAxis = a; }
     void setEccentricity(double e) { eccentricity = e; }
     void setInclination(double i) { inclination = i; }
+    void setCentralBodyId(int id) { centralBodyId = id; }
     void setStatus(const std::string& s) { status = s; }
     void setRemainingFuel(double f) { remainingFuel = f; }
 };
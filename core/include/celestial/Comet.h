@@ -6,17 +6,17 @@
 class Comet : public CelestialBody {
 protected:
     /*--- Orbital characteristics ---*/
-    double semiMajorAxis;       // meters
-    double eccentricity;        // typically > 0.9 (highly elliptical)
-    double orbitalPeriod;       // seconds
-    double inclination;         // radians
-    double perihelion;          // closest approach to sun (meters)
-    double aphelion;            // farthest point (meters)
+    double semiMajorAxis = 0.0;     // meters
+    double eccentricity = 0.0;      // typically > 0.9 (highly elliptical)
+    double orbitalPeriod = 0.0;     // seconds
+    double inclination = 0.0;       // radians
+    double perihelion = 0.0;        // closest approach to sun (meters)
+    double aphelion = 0.0;          // farthest point (meters)
 
     /*--- Coma & tail ---*/
-    double cometHeadRadius;     // nucleus radius (meters)
-    double comaRadius;          // extent of coma (meters)
-    bool hasActiveTail;
+    double cometHeadRadius = 0.0;   // nucleus radius (meters)
+    double comaRadius = 0.0;        // extent of coma (meters)
+    bool hasActiveTail = false;
 
     /*--- Origin ---*/
     std::string origin;         // e.g., "Oort Cloud", "Kuiper Belt"
@@ -51,4 +51,14 @@ public:
     void setOrigin(const std::string& o) { origin = o; }
 };
 
+/*--- Activity model (Comet.cpp); EnvironmentPass applies it in bulk ---*/
+namespace CometActivity {
+    constexpr double TAIL_ACTIVATION_AU = 3.0;  // tail switches on inside this distance
+    constexpr double COMA_CUTOFF_AU = 5.0;      // no coma beyond this distance
+    constexpr double MAX_COMA_SCALE = 1000.0;   // coma radius at the Sun, in nucleus radii
+}
+
+bool shouldHaveActiveTail(double distanceToSun);
+double estimateComaRadius(double distanceToSun, double baseRadius);
+
 #endif // SOLARSYS_CORE_CELESTIAL_COMET_H
\ No newline at end of file
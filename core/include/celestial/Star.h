@@ -2,6 +2,9 @@
 #define SOLARSYS_CORE_CELESTIAL_STAR_H
 
 #include "CelestialBody.h"
+#include "../random/CounterRng.h"
+#include <cstddef>
+#include <limits>
 
 /*--- O–M are Morgan–Keenan spectral classes (https://www.ebsco.com/research-starters/history/morgan-keenan-classification-system-mk-or-mkk) ---*/
 enum class SpectralType 
@@ -25,6 +28,20 @@ enum class EvolutionaryStage
     BLACK_HOLE
 };
 
+/*--- Flare schedule at one instant (for keyframes) ---*/
+// Valid only for the schedule it was taken from: a restart (new model, level
+// or stream) bumps the star's generation and orphans older snapshots.
+struct FlareScheduleState {
+    uint64_t generation = 0;        // 0 = none
+    double anchorTime = 0.0;
+    double flareExcess = 0.0;
+    double reachBoost = 0.0;
+    double activityTime = 0.0;
+    double nextFlareTime = std::numeric_limits<double>::infinity();
+    uint64_t flareCount = 0;
+    CounterRng rng;                 // block and position within it
+};
+
 class Star : public CelestialBody
 {
 protected:
@@ -32,22 +49,41 @@ protected:
     /*--- Basic stellar properties ---*/
     double luminosity;          // watts
     double surfaceTemperature;  // kelvin
-    double radiationReach;      // meters
+    double radiationReach = 0.0;    // meters, when quiet
 
     /*--- Classification & state ---*/
     SpectralType spectralType;
     EvolutionaryStage evolutionaryStage;
 
     /*--- Activity & variability ---*/
-    double activityLevel;    // 0.0 (calm) -> 1.0 (violent)
-    double flareProbability;  // solar explosion likelihood
-    double flareIntensity; 
+    // Flares arrive as a Poisson process of rate flareRate * activity; each
+    // adds flareIntensity to the activity and widens the radiation reach, and
+    // both relax back exponentially with flareDecayTime
+    double quiescentActivity = 0.0; // 0.0 (calm) -> 1.0 (violent)
+    double flareRate = 0.0;         // flares per second at activity 1.0
+    double flareIntensity = 0.0;
+    double flareDecayTime = 0.0;    // seconds, e-folding of the flare excess
     double flareRadius;
 
+    /*--- Flare schedule (analytic between flares) ---*/
+    double anchorTime = 0.0;        // last flare, or the start of the schedule
+    double flareExcess = 0.0;       // activity above quiescent at anchorTime
+    double reachBoost = 0.0;        // relative radiation reach gain at anchorTime
+    double activityTime = 0.0;      // time the star was last advanced to
+    double nextFlareTime = std::numeric_limits<double>::infinity();
+    uint64_t flareCount = 0;
+    double scheduleStart = 0.0;     // replay point for advancing backward
+    double startExcess = 0.0;
+    double startBoost = 0.0;
+    uint64_t scheduleGeneration = 1;    // bumped by every restart
+
     /*--- Age & lifecycle ---*/
     double age;  // years
     double lifespan; // years
 
+    /*--- Per-star random stream (reproducible, not shared between stars) ---*/
+    CounterRng activityRng;
+
 public:
     /*--- Constructors & destructors ---*/
     using CelestialBody::CelestialBody; // Inherit constructors
@@ -59,19 +95,56 @@ public:
     SpectralType getSpectralType() const { return spectralType; }
     EvolutionaryStage getEvolutionaryStage() const { return evolutionaryStage; }
     double getAge() const { return age; }
-    double getActivityLevel() const { return activityLevel; }
-    void updateActivityLevel(double newLevel) { activityLevel = newLevel; }
+    // Activity and radiation reach at the time the star was last advanced to
+    double getActivityLevel() const;
+    double getRadiationReach() const;
+    double getNextFlareTime() const { return nextFlareTime; }
+    uint64_t getFlareCount() const { return flareCount; }
+    // Sets the quiescent level, clears any flare excess and restarts the schedule
+    void updateActivityLevel(double newLevel);
 
     /*--- Mutators ---*/
     void setLuminosity(double L) { luminosity = L; }
     void setSurfaceTemperature(double T) { surfaceTemperature = T; }
     void setSpectralType(SpectralType s) { spectralType = s; }
     void setEvolutionaryStage(EvolutionaryStage e) { evolutionaryStage = e; }
+    void setRadiationReach(double reach) { radiationReach = reach; }
+    void setFlareModel(double rate, double intensity, double decayTime);
+
+    /*--- Random stream ---*/
+    // Restarts the flare schedule at the current time on the new stream
+    void seedRandomStream(uint64_t seed, uint64_t stream) {
+        activityRng = CounterRng(CounterRng::mixSeed(seed, RandomDomain::STELLAR_ACTIVITY), stream);
+        startActivity(activityTime);
+    }
 
-    /*--- Behavior & dynamics ---*/
-    void simulateFlareEvent();
+    /*--- Behavior & dynamics (Star.cpp) ---*/
+    // Anchors the flare schedule at `time` with the current state and draws
+    // the first flare time; the stream restarts from its first block
+    void startActivity(double time);
+    // Applies every flare due up to `time` and returns how many; between
+    // flares this is one comparison, so calling it every tick is free. Going
+    // back in time replays the schedule from its start, so the flares are a
+    // pure function of seed, stream and time; restoring a saved state first
+    // bounds that replay to the flares since the save.
+    size_t advanceActivity(double time) {
+        if (time >= activityTime && time < nextFlareTime) {
+            activityTime = time;
+            return 0;
+        }
+        return processFlares(time);
+    }
     double irradianceAtDistance(double distance) const;
 
+    /*--- Schedule snapshots ---*/
+    FlareScheduleState saveFlareSchedule() const;
+    // False (and no change) when the schedule restarted since the save
+    bool restoreFlareSchedule(const FlareScheduleState& state);
+
+private:
+    // Draws the next flare time after anchorTime (Star.cpp)
+    void scheduleNextFlare();
+    size_t processFlares(double time);
 };
 
 #endif // SOLARSYS_CORE_CELESTIAL_STAR_H 
\ No newline at end of file
@@ -0,0 +1,208 @@
+#ifndef SOLARSYS_CORE_DIAGNOSTICS_PROFILER_H
+#define SOLARSYS_CORE_DIAGNOSTICS_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*--- Instrumented phases ---*/
+enum class ProfilePhase : uint8_t {
+    STEP,                   // whole SolarSystem::step()
+    KEPLER_PROPAGATION,     // lazy Kepler solve on a position query
+    NBODY_INTEGRATION,      // numerical integration incl. forces
+    FORCE_EVALUATION,       // standalone force passes (ensemble kernel)
+    ENSEMBLE_STEP,          // Integrator::stepEnsemble
+    ENVIRONMENT,            // EnvironmentPass irradiance / comet activity
+    DIAGNOSTICS,            // energy / momentum checks
+    OUTPUT,                 // export, serialization, I/O
+    COUNT
+};
+
+/*--- Event counters ---*/
+enum class ProfileCounter : uint8_t {
+    FORCE_EVALUATIONS,      // per-body acceleration evaluations
+    PAIR_INTERACTIONS,
+    KEPLER_SOLVES,
+    KEPLER_ITERATIONS,
+    ALLOCATIONS,            // operator new calls on this thread
+    ALLOCATED_BYTES,
+    COUNT
+};
+
+constexpr size_t PROFILE_PHASE_COUNT = static_cast<size_t>(ProfilePhase::COUNT);
+constexpr size_t PROFILE_COUNTER_COUNT = static_cast<size_t>(ProfileCounter::COUNT);
+
+/*--- Per-thread profile (single writer: the owning thread) ---*/
+// Writers use relaxed load+store rather than read-modify-write, which costs the
+// same as a plain add while keeping concurrent queries race-free.
+struct ThreadProfile {
+    struct TraceEvent {
+        ProfilePhase phase;
+        uint64_t startNanos;
+        uint64_t durationNanos;
+    };
+
+    uint32_t threadIndex = 0;
+    std::atomic<uint64_t> counters[PROFILE_COUNTER_COUNT] = {};
+    std::atomic<uint64_t> phaseCalls[PROFILE_PHASE_COUNT] = {};
+    std::atomic<uint64_t> phaseSampledCalls[PROFILE_PHASE_COUNT] = {};
+    std::atomic<uint64_t> phaseSampledNanos[PROFILE_PHASE_COUNT] = {};
+
+    /*--- Scope bookkeeping (owner thread only) ---*/
+    int depth = 0;
+    bool sampling = false;
+    uint32_t framesUntilSample = 1;
+
+    std::mutex traceMutex;
+    std::vector<TraceEvent> trace;
+
+    bool retired = false;       // owner exited; guarded by the registry mutex
+
+    static void bump(std::atomic<uint64_t>& c, uint64_t n) {
+        c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+/*--- Aggregated view returned by Profiler::snapshot() ---*/
+struct ProfileReport {
+    struct PhaseStats {
+        uint64_t calls = 0;
+        uint64_t sampledCalls = 0;
+        uint64_t sampledNanos = 0;
+
+        double meanNanos() const { return sampledCalls ? double(sampledNanos) / sampledCalls : 0.0; }
+        // Sampled time scaled to all calls
+        double estimatedTotalNanos() const { return meanNanos() * calls; }
+    };
+
+    struct ThreadStats {
+        uint32_t threadIndex = 0;
+        uint64_t counters[PROFILE_COUNTER_COUNT] = {};
+        PhaseStats phases[PROFILE_PHASE_COUNT];
+    };
+
+    std::vector<ThreadStats> threads;
+    ThreadStats total;
+
+    uint64_t counter(ProfileCounter c) const { return total.counters[static_cast<size_t>(c)]; }
+    uint64_t steps() const { return phase(ProfilePhase::STEP).calls; }
+    const PhaseStats& phase(ProfilePhase p) const { return total.phases[static_cast<size_t>(p)]; }
+};
+
+/*--- Process-wide profiler ---*/
+// Counters are exact. Phase timing is sampled: the outermost scope on a thread
+// decides once per frame (1 in samplingInterval) whether nested scopes read the
+// clock, which keeps enabled overhead under 1% even for 10-body steps.
+// Instrumentation sites use the SOLARSYS_PROFILE_* macros below, which compile
+// to nothing unless SOLARSYS_ENABLE_PROFILING is defined (CMake option).
+class Profiler {
+private:
+    static std::atomic<uint32_t> samplingInterval;
+    static std::atomic<bool> traceEnabled;
+
+public:
+    /*--- Configuration ---*/
+    static void setSamplingInterval(uint32_t interval) { samplingInterval = interval ? interval : 1; }
+    static uint32_t getSamplingInterval() { return samplingInterval; }
+    static void setTraceEnabled(bool enabled) { traceEnabled = enabled; }
+    static bool isTraceEnabled() { return traceEnabled; }
+    static constexpr bool isCompiledIn() {
+#ifdef SOLARSYS_ENABLE_PROFILING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /*--- Query ---*/
+    static ProfileReport snapshot();
+    static void reset();
+    static void printReport(std::ostream& os);
+    static bool writeChromeTrace(const std::string& path);
+
+    static const char* phaseName(ProfilePhase p);
+    static const char* counterName(ProfileCounter c);
+
+    /*--- Hot path ---*/
+    static uint64_t nowNanos() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static ThreadProfile& threadProfile() {
+        if (!currentProfile) currentProfile = registerThread();
+        return *currentProfile;
+    }
+
+    static void count(ProfileCounter c, uint64_t n) {
+        ThreadProfile::bump(threadProfile().counters[static_cast<size_t>(c)], n);
+    }
+
+    static void recordTrace(ThreadProfile& profile, ProfilePhase phase, uint64_t start, uint64_t end);
+
+    // Hands the calling thread's profile back for reuse (runs at thread exit)
+    static void retireThread();
+
+private:
+    inline static thread_local ThreadProfile* currentProfile = nullptr;
+
+    // Hands out the profile of an exited thread when there is one, so pools
+    // that come and go keep the registry at their peak thread count
+    static ThreadProfile* registerThread();
+};
+
+/*--- RAII phase timer ---*/
+class ProfileScope {
+private:
+    ThreadProfile& profile;
+    ProfilePhase phase;
+    uint64_t start;
+    bool timed;
+
+public:
+    explicit ProfileScope(ProfilePhase phase_)
+        : profile(Profiler::threadProfile()), phase(phase_), start(0) {
+        size_t p = static_cast<size_t>(phase);
+        ThreadProfile::bump(profile.phaseCalls[p], 1);
+
+        if (profile.depth++ == 0) {
+            profile.sampling = --profile.framesUntilSample == 0;
+            if (profile.sampling) profile.framesUntilSample = Profiler::getSamplingInterval();
+        }
+        timed = profile.sampling;
+        if (timed) start = Profiler::nowNanos();
+    }
+
+    ~ProfileScope() {
+        if (timed) {
+            uint64_t end = Profiler::nowNanos();
+            size_t p = static_cast<size_t>(phase);
+            ThreadProfile::bump(profile.phaseSampledCalls[p], 1);
+            ThreadProfile::bump(profile.phaseSampledNanos[p], end - start);
+            if (Profiler::isTraceEnabled()) Profiler::recordTrace(profile, phase, start, end);
+        }
+        --profile.depth;
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+/*--- Instrumentation macros ---*/
+#ifdef SOLARSYS_ENABLE_PROFILING
+    #define SOLARSYS_PROFILE_CONCAT_INNER(a, b) a##b
+    #define SOLARSYS_PROFILE_CONCAT(a, b) SOLARSYS_PROFILE_CONCAT_INNER(a, b)
+    #define SOLARSYS_PROFILE_SCOPE(phase) \
+        ProfileScope SOLARSYS_PROFILE_CONCAT(profileScope_, __LINE__)(ProfilePhase::phase)
+    #define SOLARSYS_PROFILE_COUNT(counter, n) \
+        Profiler::count(ProfileCounter::counter, static_cast<uint64_t>(n))
+#else
+    #define SOLARSYS_PROFILE_SCOPE(phase) ((void)0)
+    #define SOLARSYS_PROFILE_COUNT(counter, n) ((void)0)
+#endif
+
+#endif // SOLARSYS_CORE_DIAGNOSTICS_PROFILER_H
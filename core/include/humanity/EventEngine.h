@@ -0,0 +1,196 @@
+#ifndef SOLARSYS_CORE_HUMANITY_EVENT_ENGINE_H
+#define SOLARSYS_CORE_HUMANITY_EVENT_ENGINE_H
+
+#include "../io/Json.h"
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <vector>
+
+/*--- Definitions (JSON files in data/humanity) ---*/
+// technologies.json: array of
+//   { "id", "name", "cost" (research points), "requires": [tech ids],
+//     "effects": { "<event id>": rate multiplier, ... } }
+// events.json: array of
+//   { "id", "name", "rate" (expected firings per colony-year while triggered),
+//     "requires": [tech ids], "minPopulation", "minStability", "maxStability",
+//     "repeatable" (default true),
+//     "effects": { "population" (relative change), "stability" (added),
+//                  "research" (points added), "collapse" (bool) } }
+// civilizations.json: array of
+//   { "name", "researchRate" (points per year), "technologies": [tech ids],
+//     "colonies": [ { "name", "body", "population", "stability" } ] }
+// Every field but the ids is optional. Stability lives in [0, 1].
+
+struct EventEffect {
+    double population = 0.0;
+    double stability = 0.0;
+    double research = 0.0;
+    bool collapse = false;
+};
+
+struct TechDefinition {
+    std::string id;
+    std::string name;
+    double cost = 0.0;
+};
+
+struct EventDefinition {
+    std::string id;
+    std::string name;
+    double ratePerYear = 0.0;
+    double minPopulation = 0.0;
+    double minStability = 0.0;
+    double maxStability = 1.0;
+    bool repeatable = true;
+    EventEffect effect;
+};
+
+struct ColonyInfo {
+    std::string name;
+    int bodyId = -1;
+    uint32_t civilization = 0;
+};
+
+enum class HistoryKind : uint8_t { EVENT, TECHNOLOGY, COLLAPSE };
+
+struct HistoryEntry {
+    double time;
+    uint32_t colony;
+    HistoryKind kind;
+    uint32_t index;         // event or tech index (COLLAPSE: the event that caused it)
+};
+
+/*--- Batched probabilistic events, techs and colonies ---*/
+// Definitions compile into dense tables: per-event base rates, requirement
+// bitsets and trigger bounds, and a tech x event matrix of rate
+// multipliers. Colony state is stored as arrays (population, stability,
+// research, known-tech bitsets, per-event rate rows).
+//
+// A colony's rates change only when one of its events fires or a tech
+// unlocks, so between those points each colony is a Poisson process with a
+// constant total rate. The engine draws the colony's next event time from an
+// exponential and keeps one entry per colony in a time-ordered queue (next
+// event or next tech unlock, whichever is first); a tick with nothing due
+// costs a single comparison, however many rare events are defined.
+//
+// Colonies research the first unknown tech whose prerequisites they know, in
+// definition order, at their civilization's research rate. Draws come from
+// Philox (CounterRng::philox) keyed by the seed and indexed by (colony, draw
+// number), so a colony's history depends only on the seed and its own past,
+// never on how many other colonies exist or in which order they run. That
+// also makes Monte Carlo cheap: replicas are just more colonies.
+class EventEngine {
+private:
+    /*--- Compiled definitions ---*/
+    std::vector<TechDefinition> techs;
+    std::vector<EventDefinition> events;
+    size_t techWords;                       // 64-bit words per tech bitset
+
+    std::vector<double> eventRate;          // per second
+    std::vector<double> eventMinPopulation;
+    std::vector<double> eventMinStability;
+    std::vector<double> eventMaxStability;
+    std::vector<uint8_t> eventOnce;         // 1 for non-repeatable events
+    std::vector<uint64_t> eventRequires;    // [event * techWords]
+    std::vector<uint64_t> techRequires;     // [tech * techWords]
+    std::vector<double> techMultiplier;     // [tech * events], 1 when the tech leaves the event alone
+
+    /*--- Civilizations ---*/
+    std::vector<std::string> civilizationNames;
+    std::vector<double> civilizationResearchRate;   // points per second
+
+    /*--- Colonies (SoA) ---*/
+    std::vector<ColonyInfo> colonies;
+    std::vector<double> population;
+    std::vector<double> stability;
+    std::vector<double> research;           // points toward the current target
+    std::vector<double> researchUpdated;    // time research was last brought up to date
+    std::vector<int32_t> researchTarget;    // tech index, -1 when nothing is left
+    std::vector<uint8_t> alive;
+    std::vector<uint64_t> known;            // [colony * techWords]
+    std::vector<uint8_t> fired;             // [colony * events], for non-repeatable events
+    std::vector<double> multiplier;         // [colony * events], product over known techs
+    std::vector<double> rates;              // [colony * events], per second, 0 when not triggered
+    std::vector<double> totalRate;
+    std::vector<double> nextEvent;
+    std::vector<double> nextUnlock;
+    std::vector<uint64_t> draws;            // RNG draws consumed per colony
+    std::vector<uint32_t> generation;       // invalidates stale queue entries
+
+    /*--- Scheduling ---*/
+    struct Due {
+        double time;
+        uint32_t colony;
+        uint32_t generation;
+        bool operator>(const Due& other) const { return time > other.time; }
+    };
+    std::priority_queue<Due, std::vector<Due>, std::greater<Due>> queue;
+
+    uint32_t key[2];
+    double time;
+
+    std::vector<HistoryEntry> history;
+    std::vector<uint64_t> eventCounts;
+    std::vector<double> uniformScratch;
+
+public:
+    /*--- Constructors ---*/
+    explicit EventEngine(uint64_t seed = 0);
+
+    /*--- Definitions (replace everything, colonies included) ---*/
+    bool compile(const JsonValue& technologies, const JsonValue& eventList, std::string* error = nullptr);
+    bool loadDefinitions(const std::string& technologiesPath, const std::string& eventsPath,
+                         std::string* error = nullptr);
+
+    /*--- Colonies ---*/
+    // Appends every colony of every civilization `replicas` times (replica-major)
+    bool loadCivilizations(const JsonValue& civilizations, size_t replicas = 1, std::string* error = nullptr);
+    bool loadCivilizations(const std::string& path, size_t replicas = 1, std::string* error = nullptr);
+
+    /*--- Driving ---*/
+    // Restarts every colony's random stream and reschedules from the current
+    // time (colony state is kept)
+    void reseed(uint64_t seed);
+    // Processes everything due in (time, time + dt] in time order; returns the
+    // number of history entries added
+    size_t advance(double dt);
+
+    /*--- Results ---*/
+    double getTime() const { return time; }
+    const std::vector<HistoryEntry>& getHistory() const { return history; }
+    void clearHistory() { history.clear(); }
+    uint64_t getEventCount(size_t event) const { return eventCounts[event]; }
+
+    /*--- Lookup ---*/
+    size_t getTechCount() const { return techs.size(); }
+    size_t getEventCount() const { return events.size(); }
+    const TechDefinition& getTech(size_t tech) const { return techs[tech]; }
+    const EventDefinition& getEvent(size_t event) const { return events[event]; }
+    int findTech(const std::string& id) const;
+    int findEvent(const std::string& id) const;
+
+    size_t getColonyCount() const { return colonies.size(); }
+    const ColonyInfo& getColony(size_t colony) const { return colonies[colony]; }
+    bool isAlive(size_t colony) const { return alive[colony] != 0; }
+    double getPopulation(size_t colony) const { return population[colony]; }
+    double getStability(size_t colony) const { return stability[colony]; }
+    bool knowsTech(size_t colony, size_t tech) const {
+        return (known[colony * techWords + tech / 64] >> (tech % 64)) & 1u;
+    }
+    // Current firing rate of an event in a colony, per second (0 when not triggered)
+    double getRate(size_t colony, size_t event) const { return rates[colony * events.size() + event]; }
+
+private:
+    void clearColonies();
+    void syncResearch(size_t colony, double now);
+    void evaluateRates(size_t colony);
+    void chooseResearchTarget(size_t colony);
+    void schedule(size_t colony, double now, double u);
+    void scheduleBatch(size_t begin, size_t end, double now);
+    void process(size_t colony, double now);
+    void unlock(size_t colony, size_t tech);
+    double drawUniform(size_t colony);
+};
+
+#endif // SOLARSYS_CORE_HUMANITY_EVENT_ENGINE_H
@@ -0,0 +1,85 @@
+#ifndef SOLARSYS_CORE_IO_JSON_H
+#define SOLARSYS_CORE_IO_JSON_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/*--- Minimal JSON document model for the data/ files ---*/
+// Enough of RFC 8259 for hand-written data files: objects keep insertion order,
+// numbers are doubles, \u escapes outside ASCII are encoded as UTF-8.
+class JsonValue {
+public:
+    enum class Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+private:
+    Type type;
+    bool boolValue;
+    double numberValue;
+    std::string stringValue;
+    std::vector<JsonValue> arrayValue;
+    std::vector<std::pair<std::string, JsonValue>> objectValue;
+
+public:
+    /*--- Constructors ---*/
+    JsonValue() : type(Type::NUL), boolValue(false), numberValue(0.0) {}
+    explicit JsonValue(bool b) : type(Type::BOOLEAN), boolValue(b), numberValue(0.0) {}
+    explicit JsonValue(double n) : type(Type::NUMBER), boolValue(false), numberValue(n) {}
+    explicit JsonValue(const std::string& s) : type(Type::STRING), boolValue(false), numberValue(0.0), stringValue(s) {}
+
+    static JsonValue makeArray() { JsonValue v; v.type = Type::ARRAY; return v; }
+    static JsonValue makeObject() { JsonValue v; v.type = Type::OBJECT; return v; }
+
+    /*--- Parsing (returns false and fills error on malformed input) ---*/
+    static bool parse(const std::string& text, JsonValue& out, std::string* error = nullptr);
+    static bool parseFile(const std::string& path, JsonValue& out, std::string* error = nullptr);
+
+    /*--- Type queries ---*/
+    Type getType() const { return type; }
+    bool isNull() const { return type == Type::NUL; }
+    bool isBool() const { return type == Type::BOOLEAN; }
+    bool isNumber() const { return type == Type::NUMBER; }
+    bool isString() const { return type == Type::STRING; }
+    bool isArray() const { return type == Type::ARRAY; }
+    bool isObject() const { return type == Type::OBJECT; }
+
+    /*--- Scalar access ---*/
+    bool asBool(bool fallback = false) const { return isBool() ? boolValue : fallback; }
+    double asNumber(double fallback = 0.0) const { return isNumber() ? numberValue : fallback; }
+    const std::string& asString() const { return stringValue; }
+
+    /*--- Containers ---*/
+    size_t size() const { return isArray() ? arrayValue.size() : objectValue.size(); }
+    const JsonValue& operator[](size_t index) const { return arrayValue[index]; }
+    const std::vector<JsonValue>& getArray() const { return arrayValue; }
+    const std::vector<std::pair<std::string, JsonValue>>& getObject() const { return objectValue; }
+
+    // Object member lookup; nullptr if absent or not an object
+    const JsonValue* find(const std::string& key) const {
+        for (const auto& [k, v] : objectValue) {
+            if (k == key) return &v;
+        }
+        return nullptr;
+    }
+
+    double getNumber(const std::string& key, double fallback = 0.0) const {
+        const JsonValue* v = find(key);
+        return v ? v->asNumber(fallback) : fallback;
+    }
+
+    std::string getString(const std::string& key, const std::string& fallback = "") const {
+        const JsonValue* v = find(key);
+        return (v && v->isString()) ? v->stringValue : fallback;
+    }
+
+    bool getBool(const std::string& key, bool fallback = false) const {
+        const JsonValue* v = find(key);
+        return v ? v->asBool(fallback) : fallback;
+    }
+
+    /*--- Building ---*/
+    void push(JsonValue v) { arrayValue.push_back(std::move(v)); }
+    void set(const std::string& key, JsonValue v) { objectValue.emplace_back(key, std::move(v)); }
+};
+
+#endif // SOLARSYS_CORE_IO_JSON_H
@@ -0,0 +1,22 @@
+#ifndef SOLARSYS_CORE_IO_SCENARIO_LOADER_H
+#define SOLARSYS_CORE_IO_SCENARIO_LOADER_H
+
+#include "Json.h"
+#include "../simulation/SolarSystem.h"
+#include <string>
+
+/*--- Builds SolarSystem instances from the data/solar-system JSON files ---*/
+class ScenarioLoader {
+public:
+    // Loads an array of planets (data/solar-system/planet.json layout):
+    //   { "name", "mass", "radius", "semiMajorAxis", "eccentricity", "orbitalPeriod" }
+    // Optional per-entry: "id" (default index + 1), "inclination", "longitudeOfAscNode",
+    // "argumentOfPeriapsis", "meanAnomaly" (radians). A Sun is added if the system
+    // has no star yet. Returns false and fills error on I/O or schema problems.
+    static bool loadPlanets(SolarSystem& system, const std::string& path, std::string* error = nullptr);
+
+    // Same as loadPlanets() but from an already parsed document
+    static bool loadPlanets(SolarSystem& system, const JsonValue& planets, std::string* error = nullptr);
+};
+
+#endif // SOLARSYS_CORE_IO_SCENARIO_LOADER_H
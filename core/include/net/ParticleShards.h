@@ -0,0 +1,155 @@
+#ifndef SOLARSYS_CORE_NET_PARTICLE_SHARDS_H
+#define SOLARSYS_CORE_NET_PARTICLE_SHARDS_H
+
+#include "ShardTransport.h"
+#include "../physics/ParticleGravity.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+/*--- Wire format (little endian), one ShardChannel message each ---*/
+// Every message starts with u32 magic 'SPS1' | u8 type | u8 0 | u16 0.
+// ASSIGN   coordinator -> worker: u32 shard | u8 precision | f64 pairTolerance
+//          | f64 time | u32 bodies, per body {i32 id, f64 gm, f64 encounterRadius,
+//          f64 x, y, z} | u32 particles, per particle {i32 id, f64 x, y, z, vx, vy, vz}
+// ADVANCE  coordinator -> worker: f64 dt | u32 steps | u8 wantStates | u32 bodies
+//          | steps * bodies * {f64 x, y, z}: body positions at the end of each step
+// RESULT   worker -> coordinator: u32 shard | f64 time | u32 encounters, per
+//          encounter {i32 particle, i32 body, f64 time, f64 distance}
+//          | u32 states (0 unless asked), per state {i32 id, f64 x, y, z, vx, vy, vz}
+// SHUTDOWN coordinator -> worker, no payload and no reply
+// ASSIGN is answered with a RESULT at the assigned time.
+namespace ShardMessage {
+    constexpr uint32_t MAGIC = 0x31535053;     // "SPS1"
+    constexpr uint8_t ASSIGN = 0;
+    constexpr uint8_t ADVANCE = 1;
+    constexpr uint8_t RESULT = 2;
+    constexpr uint8_t SHUTDOWN = 3;
+    constexpr size_t HEADER_BYTES = 8;
+}
+
+/*--- Test particle entering a body's encounter radius ---*/
+struct ShardEncounter {
+    int particleId;
+    int bodyId;
+    double time;            // end of the step that crossed inward
+    double distance;
+};
+
+struct ShardConfig {
+    ForcePrecision precision = ForcePrecision::DOUBLE;
+    MixedPrecisionConfig mixed;
+};
+
+/*--- Worker side: owns one shard of massless particles ---*/
+// Particles are SoA and advance with velocity Verlet (kick-drift-kick) in
+// the field of the massive bodies the coordinator sends. An ADVANCE message
+// carries the body positions at the end of every step of a segment, so a
+// worker never extrapolates the field and one round trip can cover many steps.
+class ParticleShardWorker {
+private:
+    uint32_t shard;
+    ForcePrecision precision;
+    MixedPrecisionConfig mixed;
+    double time;
+
+    ForceSources sources;
+    std::vector<int> bodyIds;
+    std::vector<double> encounterRadius;
+
+    std::vector<int> ids;
+    std::vector<double> x, y, z, vx, vy, vz, ax, ay, az;
+    std::vector<uint8_t> inside;        // [particle * bodies + body]
+
+    std::vector<ShardEncounter> encounters;
+
+public:
+    /*--- Constructors ---*/
+    ParticleShardWorker() : shard(0), precision(ForcePrecision::DOUBLE), time(0.0) {}
+
+    // Answers messages until SHUTDOWN or until the channel closes. Returns
+    // false if it stopped on a malformed message or a failed send.
+    bool serve(ShardChannel& channel);
+
+    // Handles one request; false for malformed input. reply is empty for SHUTDOWN.
+    bool handle(const std::vector<uint8_t>& request, std::vector<uint8_t>& reply, bool& shutdown);
+
+    size_t getParticleCount() const { return ids.size(); }
+    double getTime() const { return time; }
+
+private:
+    void computeAccelerations();
+    void detectEncounters();
+    void writeResult(std::vector<uint8_t>& out, bool withStates);
+};
+
+/*--- Coordinator side: splits particles over workers and steps them in lock-step ---*/
+// Each call sends to every worker first and then collects the replies, so the
+// shards run concurrently in their own processes (or on other nodes).
+// Particles keep the order given to distribute(); shard k holds a contiguous
+// run of them.
+class ParticleShardCoordinator {
+private:
+    std::vector<std::unique_ptr<ShardChannel>> workers;
+    std::vector<size_t> shardSizes;
+    std::vector<int> bodyIds;
+    double time;
+    std::vector<ShardEncounter> encounters;
+    std::string lastError;
+    std::vector<uint8_t> buffer;
+
+public:
+    /*--- Constructors & Destructors ---*/
+    ParticleShardCoordinator() : time(0.0) {}
+    ~ParticleShardCoordinator() { shutdown(); }
+
+    ParticleShardCoordinator(const ParticleShardCoordinator&) = delete;
+    ParticleShardCoordinator& operator=(const ParticleShardCoordinator&) = delete;
+
+    /*--- Workers ---*/
+    void addWorker(std::unique_ptr<ShardChannel> channel);
+    size_t getWorkerCount() const { return workers.size(); }
+
+    /*--- Propagation ---*/
+    // encounterRadii is index-aligned with massive (0 disables a body); the
+    // massive set and its order are fixed until the next distribute()
+    bool distribute(const std::vector<BodyState>& particles, const std::vector<BodyState>& massive,
+                    const std::vector<double>& encounterRadii, double time_,
+                    const ShardConfig& config = ShardConfig());
+    // samples[k] holds the massive bodies at time + (k + 1) * dt
+    bool advance(const std::vector<std::vector<BodyState>>& samples, double dt);
+    bool step(const std::vector<BodyState>& massive, double dt) { return advance({massive}, dt); }
+    // Current particle states in distribute() order (massless, zero acceleration)
+    bool gather(std::vector<BodyState>& particles);
+    void shutdown();
+    // Closes the channels without telling the workers; for forked children
+    // that inherited the coordinator
+    void detachWorkers();
+
+    /*--- Results ---*/
+    double getTime() const { return time; }
+    size_t getParticleCount() const;
+    const std::vector<ShardEncounter>& getEncounters() const { return encounters; }
+    void clearEncounters() { encounters.clear(); }
+    const std::string& getLastError() const { return lastError; }
+
+private:
+    bool exchange(const std::vector<std::vector<uint8_t>>& requests, std::vector<BodyState>* states);
+    bool fail(const std::string& message);
+};
+
+/*--- Local workers for one-machine runs ---*/
+namespace ParticleShards {
+    // Forks count worker processes connected over socket pairs and adds them
+    // to the coordinator. Call before starting threads in this process.
+    bool spawnLocalWorkers(ParticleShardCoordinator& coordinator, size_t count,
+                           std::vector<pid_t>& pids, std::string* error = nullptr);
+    // Reaps the given workers (after coordinator.shutdown())
+    void waitForWorkers(std::vector<pid_t>& pids);
+
+    // Connects to a coordinator's ShardListener address and serves until shutdown
+    int runWorker(const std::string& address);
+}
+
+#endif // SOLARSYS_CORE_NET_PARTICLE_SHARDS_H
@@ -0,0 +1,81 @@
+#ifndef SOLARSYS_CORE_NET_SHARD_TRANSPORT_H
+#define SOLARSYS_CORE_NET_SHARD_TRANSPORT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*--- Ordered, reliable message channel between a coordinator and one worker ---*/
+// Blocking on both ends: shard traffic is lock-step (request, then reply), so
+// there is nothing useful to do while waiting. Implementations only have to
+// preserve message boundaries; see SocketChannel for the stream-socket one.
+class ShardChannel {
+public:
+    virtual ~ShardChannel() = default;
+
+    // Both return false once the peer is gone or the channel was closed
+    virtual bool send(const std::vector<uint8_t>& message) = 0;
+    virtual bool receive(std::vector<uint8_t>& message) = 0;
+    virtual void close() = 0;
+};
+
+/*--- Stream socket channel (Unix domain or TCP), u32 length prefix per message ---*/
+class SocketChannel : public ShardChannel {
+private:
+    int fd;
+
+    static constexpr uint32_t MAX_MESSAGE_BYTES = 1u << 30;
+
+public:
+    /*--- Constructors & Destructors ---*/
+    explicit SocketChannel(int fd_) : fd(fd_) {}
+    ~SocketChannel() override { close(); }
+
+    SocketChannel(const SocketChannel&) = delete;
+    SocketChannel& operator=(const SocketChannel&) = delete;
+
+    // Address is "unix:/path/to/socket" or "tcp:host:port"; nullptr on failure
+    static std::unique_ptr<SocketChannel> connect(const std::string& address, std::string* error = nullptr);
+
+    // Two connected channels, for workers forked on this machine
+    static bool pair(std::unique_ptr<SocketChannel>& a, std::unique_ptr<SocketChannel>& b,
+                     std::string* error = nullptr);
+
+    /*--- ShardChannel ---*/
+    bool send(const std::vector<uint8_t>& message) override;
+    bool receive(std::vector<uint8_t>& message) override;
+    void close() override;
+
+    int getFd() const { return fd; }
+};
+
+/*--- Accepts worker connections for a coordinator ---*/
+class ShardListener {
+private:
+    int listenFd;
+    std::string address;        // as bound, with the actual port for tcp:host:0
+    std::string unixPath;       // unlinked again on close()
+
+public:
+    /*--- Constructors & Destructors ---*/
+    ShardListener() : listenFd(-1) {}
+    ~ShardListener() { close(); }
+
+    ShardListener(const ShardListener&) = delete;
+    ShardListener& operator=(const ShardListener&) = delete;
+
+    /*--- Lifecycle ---*/
+    // "unix:/path" (a stale socket file is replaced) or "tcp:host:port"
+    // (port 0 picks a free one, see getAddress())
+    bool listen(const std::string& address_, std::string* error = nullptr);
+    // Waits up to timeoutSeconds (negative: forever); nullptr on timeout or error
+    std::unique_ptr<SocketChannel> accept(double timeoutSeconds = -1.0, std::string* error = nullptr);
+    void close();
+
+    /*--- Accessors ---*/
+    const std::string& getAddress() const { return address; }
+    bool isListening() const { return listenFd >= 0; }
+};
+
+#endif // SOLARSYS_CORE_NET_SHARD_TRANSPORT_H
@@ -0,0 +1,136 @@
+#ifndef SOLARSYS_CORE_NET_STATE_STREAM_SERVER_H
+#define SOLARSYS_CORE_NET_STATE_STREAM_SERVER_H
+
+#include "WebSocketServer.h"
+#include "../physics/Integrator.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+
+/*--- Wire format (little endian), consumed by visualization/src/stateStream.js ---*/
+// Every frame starts with a 56-byte header:
+//   u32 magic 'SSF1' | u8 type | u8 0 | u16 0 | u32 sequence | u32 count
+//   f64 simTime | f64 origin x, y, z (meters) | f64 quantum (meters per LSB)
+// KEYFRAME: i32 ids[count], then f32 xyz[count] relative to origin.
+// DELTA:    count entries of { u32 index, i16 dx, dy, dz } against the positions
+//           the client reconstructed so far (closed loop, so error never drifts
+//           past quantum/2). Indices refer to the last keyframe's id table.
+namespace StreamFrame {
+    constexpr uint32_t MAGIC = 0x31465353;     // "SSF1"
+    constexpr uint8_t KEYFRAME = 0;
+    constexpr uint8_t DELTA = 1;
+    constexpr size_t HEADER_BYTES = 56;
+    constexpr size_t DELTA_ENTRY_BYTES = 10;
+}
+
+/*--- Per-client view settings (sent by the client as a JSON text message) ---*/
+struct StreamClientSettings {
+    Vec3 origin;                    // camera-dependent origin, meters
+    double lodDistance = 0.0;       // beyond this (from origin) bodies are subsampled; 0 disables
+    uint32_t farStride = 4;         // far bodies refresh every farStride-th frame
+    double quantum = 1000.0;        // finest delta resolution, meters
+    uint32_t keyframeInterval = 300;
+
+    // Apply any fields present in {"origin":[x,y,z],"lodDistance":..,"farStride":..,
+    // "quantum":..,"keyframeInterval":..}. Returns false if the text is not a JSON object.
+    bool applyJson(const std::string& text);
+};
+
+/*--- Snapshot of the simulation taken on the stepping thread ---*/
+struct StreamSnapshot {
+    double time = 0.0;
+    std::vector<int> ids;
+    std::vector<double> positions;  // xyz interleaved
+
+    void assign(double time_, const std::vector<BodyState>& states);
+};
+
+/*--- Delta encoder for one client ---*/
+class StreamFrameEncoder {
+private:
+    StreamClientSettings settings;
+    std::vector<int> ids;
+    std::vector<double> reconstructed;  // client-side positions relative to settings.origin
+    uint32_t sequence;
+    uint32_t framesSinceKey;
+    bool needKeyframe;
+
+public:
+    StreamFrameEncoder() : sequence(0), framesSinceKey(0), needKeyframe(true) {}
+
+    const StreamClientSettings& getSettings() const { return settings; }
+    void setSettings(const StreamClientSettings& s);
+    void requestKeyframe() { needKeyframe = true; }
+
+    // Encodes the next frame into out. Returns false when nothing changed
+    // (empty delta), in which case nothing should be sent.
+    bool encode(const StreamSnapshot& snapshot, std::vector<uint8_t>& out);
+
+private:
+    void encodeKeyframe(const StreamSnapshot& snapshot, std::vector<uint8_t>& out);
+    void writeHeader(std::vector<uint8_t>& out, uint8_t type, uint32_t count, double time, double quantum);
+};
+
+/*--- State streaming server ---*/
+// publish() is meant to be called right after SolarSystem::step(). It copies the
+// states into a pending snapshot under a short lock and pokes the I/O thread;
+// it never waits on a socket. When frames arrive faster than a client drains
+// them, frames for that client are dropped (and counted), so a slow browser
+// degrades to a lower frame rate instead of slowing the simulation.
+class StateStreamServer {
+public:
+    struct Stats {
+        uint64_t published = 0;     // snapshots accepted by publish()
+        uint64_t throttled = 0;     // publish() calls skipped by the rate limit
+        uint64_t framesSent = 0;
+        uint64_t framesDropped = 0; // per-client frames skipped due to backpressure
+        uint64_t bytesSent = 0;
+        size_t clients = 0;
+    };
+
+private:
+    WebSocketServer server;
+    double maxFramesPerSecond;
+    std::chrono::steady_clock::time_point lastPublish;
+
+    std::mutex pendingMutex;
+    StreamSnapshot pending;
+    bool hasPending;
+
+    StreamSnapshot current;                                             // I/O thread only
+    std::unordered_map<WebSocketServer::ClientId, StreamFrameEncoder> encoders;   // I/O thread only
+    std::vector<uint8_t> frameBuffer;                                   // I/O thread only
+
+    std::atomic<uint64_t> published;
+    std::atomic<uint64_t> throttled;
+    std::atomic<uint64_t> framesSent;
+    std::atomic<uint64_t> framesDropped;
+    std::atomic<uint64_t> bytesSent;
+
+public:
+    /*--- Constructors & Destructors ---*/
+    explicit StateStreamServer(double maxFramesPerSecond_ = 60.0);
+    ~StateStreamServer() { stop(); }
+
+    /*--- Lifecycle ---*/
+    bool start(uint16_t port, const std::string& bindAddress = "127.0.0.1", std::string* error = nullptr);
+    void stop() { server.stop(); }
+    uint16_t getPort() const { return server.getPort(); }
+    size_t getClientCount() const { return server.getClientCount(); }
+
+    /*--- Publishing (simulation thread) ---*/
+    // Returns false if the snapshot was skipped (no clients or rate limited)
+    bool publish(double time, const std::vector<BodyState>& states);
+
+    void setMaxFramesPerSecond(double fps) { maxFramesPerSecond = fps; }
+    Stats getStats() const;
+
+private:
+    void onOpen(WebSocketServer::ClientId id);
+    void onText(WebSocketServer::ClientId id, const std::string& text);
+    void onWake();
+    void sendTo(WebSocketServer::ClientId id, StreamFrameEncoder& encoder);
+};
+
+#endif // SOLARSYS_CORE_NET_STATE_STREAM_SERVER_H
@@ -0,0 +1,89 @@
+#ifndef SOLARSYS_CORE_NET_WEBSOCKET_SERVER_H
+#define SOLARSYS_CORE_NET_WEBSOCKET_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*--- Minimal RFC 6455 server for local tooling (POSIX sockets, no TLS) ---*/
+// All socket work and every handler run on one I/O thread. Other threads only
+// call wake(), which makes the I/O thread invoke onWake; that is where frames
+// are encoded and queued. Sends never block: bytes the kernel won't take yet
+// stay queued and isWritable() reports false until they drain.
+class WebSocketServer {
+public:
+    using ClientId = uint64_t;
+
+    struct Handlers {
+        std::function<void(ClientId)> onOpen;
+        std::function<void(ClientId, const std::string&)> onText;
+        std::function<void(ClientId)> onClose;
+        std::function<void()> onWake;
+    };
+
+private:
+    struct Client {
+        int fd = -1;
+        bool handshakeDone = false;
+        bool closing = false;
+        std::string inBuffer;
+        std::string fragment;       // text message being reassembled
+        std::vector<uint8_t> outBuffer;
+        size_t outOffset = 0;
+    };
+
+    Handlers handlers;
+    int listenFd;
+    int wakePipe[2];
+    uint16_t port;
+    std::atomic<bool> running;
+    std::atomic<size_t> clientCount;
+    std::thread ioThread;
+
+    std::map<ClientId, Client> clients;     // I/O thread only
+    ClientId nextClientId;
+
+    static constexpr size_t MAX_MESSAGE_BYTES = 1 << 16;
+
+public:
+    /*--- Constructors & Destructors ---*/
+    WebSocketServer();
+    ~WebSocketServer();
+
+    WebSocketServer(const WebSocketServer&) = delete;
+    WebSocketServer& operator=(const WebSocketServer&) = delete;
+
+    /*--- Lifecycle (any thread) ---*/
+    // Port 0 picks a free port (see getPort()). Binds 127.0.0.1 unless told otherwise.
+    bool start(uint16_t port_, const Handlers& handlers_,
+               const std::string& bindAddress = "127.0.0.1", std::string* error = nullptr);
+    void stop();
+    void wake();
+
+    /*--- Accessors (any thread) ---*/
+    uint16_t getPort() const { return port; }
+    size_t getClientCount() const { return clientCount; }
+    bool isRunning() const { return running; }
+
+    /*--- Sending (I/O thread only, i.e. from handlers) ---*/
+    bool isWritable(ClientId id) const;
+    bool sendBinary(ClientId id, const std::vector<uint8_t>& payload);
+    bool sendText(ClientId id, const std::string& text);
+    std::vector<ClientId> getClientIds() const;
+
+private:
+    void run();
+    void acceptClients();
+    void readClient(ClientId id, Client& client);
+    bool processHandshake(Client& client);
+    void processFrames(ClientId id, Client& client);
+    void queueFrame(Client& client, uint8_t opcode, const uint8_t* data, size_t size);
+    void flush(Client& client);
+    void closeClient(ClientId id);
+};
+
+#endif // SOLARSYS_CORE_NET_WEBSOCKET_SERVER_H
@@ -0,0 +1,67 @@
+#ifndef SOLARSYS_CORE_PHYSICS_ENCOUNTER_REGULARIZATION_H
+#define SOLARSYS_CORE_PHYSICS_ENCOUNTER_REGULARIZATION_H
+
+#include "Integrator.h"
+#include <cstdint>
+#include <vector>
+
+/*--- When a pair is integrated as a regularized two-body subsystem ---*/
+// A pair is regularized inside hillFactor mutual Hill radii, taken with
+// respect to the most massive body (a flyby or a moon). Pairs that include
+// that body have no Hill sphere to test (a comet at perihelion); they are
+// regularized once the global step under-resolves them, i.e. when dt exceeds
+// stepFraction * sqrt(r^3 / G(m1 + m2)), the local two-body dynamical time,
+// and only while the body plunges inside half its semi-major axis (eccentric
+// or unbound orbits), so short-period planets are never taken.
+// A flyby stays regularized for the whole Hill-sphere passage: switching
+// only around periapsis would mix two integrations of the same hyperbola.
+struct EncounterConfig {
+    double hillFactor = 3.0;
+    double stepFraction = 0.05;
+    uint32_t substeps = 8;          // leapfrog steps per global step at the start-of-step pace
+    uint32_t maxSubsteps = 4096;    // hard cap per pair per global step
+};
+
+struct EncounterPair {
+    size_t first;
+    size_t second;
+    double severity;                // dt over the pair's dynamical time (ordering)
+};
+
+struct EncounterStats {
+    uint64_t pairSteps = 0;         // regularized pair advances
+    uint64_t kicks = 0;             // leapfrog kicks, one two-body force each
+    size_t lastStepPairs = 0;
+};
+
+/*--- Close two-body encounters with a time-transformed leapfrog ---*/
+// Kick-drift-kick in the split "pair + everything else": each member takes a
+// half kick from the external field of the other bodies, the pair then moves
+// as an isolated two-body system for dt, and the closing half kick uses the
+// field at the end of the step. advancePair() does the first two parts,
+// completePair() the last once the rest of the system has moved.
+//
+// The isolated relative motion uses the logarithmic-Hamiltonian leapfrog
+// (Mikkola & Tanikawa 1999; Preto & Tremaine 1999): drifts advance physical
+// time by ds / (T + B) and kicks by ds * r / mu, with B the binding energy,
+// so the physical substep shrinks with the separation and the orbit (ellipse
+// or hyperbola) is followed exactly with only a phase error. The leapfrog is
+// composed to fourth order (Yoshida) to keep that error small, and the last
+// substep is solved so the pair lands exactly on the end of the global step.
+namespace EncounterRegularization {
+    // Disjoint qualifying pairs, most under-resolved first (a body joins at
+    // most one pair per step)
+    void findPairs(const std::vector<BodyState>& bodies, double dt, const EncounterConfig& config,
+                   std::vector<EncounterPair>& out);
+
+    // Opening half kick with each one's acceleration from every body outside
+    // the pair, then the isolated pair advance over dt; returns the number of
+    // leapfrog kicks taken. Leaves acceleration untouched.
+    uint32_t advancePair(BodyState& a, BodyState& b, const Vec3& externalA, const Vec3& externalB,
+                         double dt, const EncounterConfig& config);
+
+    // Closing half kick with the external field at the end of the step
+    void completePair(BodyState& a, BodyState& b, const Vec3& externalA, const Vec3& externalB, double dt);
+}
+
+#endif // SOLARSYS_CORE_PHYSICS_ENCOUNTER_REGULARIZATION_H
@@ -85,6 +85,11 @@ public:
     static double hillSphereRadius(double bodyMass, double parentMass, double semiMajorAxis) {
         return semiMajorAxis * std::cbrt(bodyMass / (3.0 * parentMass));
     }
+
+    /*--- Laplace sphere of influence (patched-conic frame switch radius) ---*/
+    static double laplaceSphereRadius(double bodyMass, double parentMass, double semiMajorAxis) {
+        return semiMajorAxis * std::pow(bodyMass / parentMass, 0.4);
+    }
 };
 
 #endif // SOLARSYS_CORE_PHYSICS_GRAVITY_H
\ No newline at end of file
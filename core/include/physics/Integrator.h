@@ -17,6 +17,78 @@ struct BodyState {
 /*--- Acceleration function type ---*/
 using AccelerationFunc = std::function<Vec3(const BodyState&, const std::vector<BodyState>&)>;
 
+/*--- Integration method enum ---*/
+enum class IntegrationMethod {
+    EULER,
+    SYMPLECTIC_EULER,
+    VELOCITY_VERLET,
+    RK4
+};
+
+/*--- Lane-interleaved ensemble of K copies of one system ---*/
+// Element (body, lane) lives at [body * laneCount + lane], so for a fixed body
+// pair the lane loop walks contiguous doubles, branch-free and through
+// non-aliasing row pointers. GCC packs it 2 universes per instruction on the
+// default (SSE2) build, 4 with SOLARSYS_NATIVE_ARCH on AVX2 hardware.
+struct EnsembleState {
+    size_t bodyCount = 0;
+    size_t laneCount = 0;
+    std::vector<int> ids;       // per body, shared by all lanes
+
+    std::vector<double> mass;   // per lane, so mass perturbations are allowed
+    std::vector<double> px, py, pz;
+    std::vector<double> vx, vy, vz;
+    std::vector<double> ax, ay, az;
+    bool accelerationValid = false;
+
+    /*--- Scratch for multi-stage methods (kept to avoid per-step allocation) ---*/
+    std::vector<double> scratch;
+
+    void resize(size_t bodies, size_t lanes) {
+        bodyCount = bodies;
+        laneCount = lanes;
+        size_t n = bodies * lanes;
+        ids.assign(bodies, 0);
+        for (auto* v : {&mass, &px, &py, &pz, &vx, &vy, &vz, &ax, &ay, &az}) v->assign(n, 0.0);
+        accelerationValid = false;
+    }
+
+    size_t index(size_t body, size_t lane) const { return body * laneCount + lane; }
+
+    // Load one universe into a lane; bodies must match the ensemble's body order
+    void setLane(size_t lane, const std::vector<BodyState>& bodies) {
+        for (size_t b = 0; b < bodyCount && b < bodies.size(); ++b) {
+            size_t k = index(b, lane);
+            ids[b] = bodies[b].id;
+            mass[k] = bodies[b].mass;
+            px[k] = bodies[b].position.x; py[k] = bodies[b].position.y; pz[k] = bodies[b].position.z;
+            vx[k] = bodies[b].velocity.x; vy[k] = bodies[b].velocity.y; vz[k] = bodies[b].velocity.z;
+        }
+        accelerationValid = false;
+    }
+
+    std::vector<BodyState> getLane(size_t lane) const {
+        std::vector<BodyState> bodies(bodyCount);
+        for (size_t b = 0; b < bodyCount; ++b) {
+            size_t k = index(b, lane);
+            bodies[b].id = ids[b];
+            bodies[b].mass = mass[k];
+            bodies[b].position = Vec3(px[k], py[k], pz[k]);
+            bodies[b].velocity = Vec3(vx[k], vy[k], vz[k]);
+            bodies[b].acceleration = Vec3(ax[k], ay[k], az[k]);
+        }
+        return bodies;
+    }
+
+    // Replicate one system into every lane (perturb lanes afterwards)
+    static EnsembleState broadcast(const std::vector<BodyState>& bodies, size_t lanes) {
+        EnsembleState ensemble;
+        ensemble.resize(bodies.size(), lanes);
+        for (size_t l = 0; l < lanes; ++l) ensemble.setLane(l, bodies);
+        return ensemble;
+    }
+};
+
 class Integrator {
 public:
     /*--- Euler method (1st order, simple but inaccurate) ---*/
@@ -82,6 +154,16 @@ public:
         body.acceleration = accelFunc(body, allBodies);
     }
 
+    /*--- Ensemble mode: advance every lane of an EnsembleState by dt ---*/
+    // All bodies are updated synchronously from the same force evaluation
+    // (the per-body methods above update in place, body by body).
+    static void stepEnsemble(EnsembleState& ensemble, double dt, IntegrationMethod method);
+
+    /*--- Lane-wise pairwise gravity; writes ax/ay/az for positions px/py/pz ---*/
+    static void ensembleAcceleration(const EnsembleState& ensemble,
+                                     const double* px, const double* py, const double* pz,
+                                     double* ax, double* ay, double* az);
+
     /*--- Compute N-body gravitational acceleration ---*/
     static Vec3 nBodyAcceleration(const BodyState& body, const std::vector<BodyState>& allBodies) {
         Vec3 totalAccel;
@@ -94,12 +176,12 @@ public:
     }
 };
 
-/*--- Integration method enum ---*/
-enum class IntegrationMethod {
-    EULER,
-    SYMPLECTIC_EULER,
-    VELOCITY_VERLET,
-    RK4
-};
+/*--- Conservation diagnostics (Integrator.cpp) ---*/
+namespace IntegratorUtils {
+    double computeTotalEnergy(const std::vector<BodyState>& bodies);
+    Vec3 computeTotalAngularMomentum(const std::vector<BodyState>& bodies);
+    Vec3 computeCenterOfMass(const std::vector<BodyState>& bodies);
+    Vec3 computeCenterOfMassVelocity(const std::vector<BodyState>& bodies);
+}
 
 #endif // SOLARSYS_CORE_PHYSICS_INTEGRATOR_H
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef SOLARSYS_CORE_PHYSICS_LAMBERT_H
+#define SOLARSYS_CORE_PHYSICS_LAMBERT_H
+
+#include "Gravity.h"
+
+/*--- Lambert problem solution ---*/
+struct LambertSolution {
+    Vec3 departureVelocity;     // v1 at r1 (m/s)
+    Vec3 arrivalVelocity;       // v2 at r2 (m/s)
+    double x;                   // Izzo's free parameter (warm start for neighbouring problems)
+    int iterations;
+    bool valid;
+};
+
+/*--- Izzo's Lambert solver (single revolution) ---*/
+// Finds the conic from r1 to r2 in time-of-flight tof around a body with
+// gravitational parameter mu (D. Izzo, "Revisiting Lambert's problem", 2015).
+// The time-of-flight equation is solved in Izzo's x variable with third-order
+// Householder steps, using Lagrange, Battin or Lancaster expressions depending
+// on how close x is to the parabolic case. Zero-revolution transfers only.
+//
+// Grid searches should pass the x of a neighbouring solution as warmStart;
+// it typically saves half of the iterations.
+class LambertSolver {
+public:
+    static constexpr int MAX_ITERATIONS = 15;
+
+    static LambertSolution solve(const Vec3& r1, const Vec3& r2, double tof, double mu,
+                                 bool prograde = true, double warmStart = 0.0, bool useWarmStart = false);
+
+    // Non-dimensional time of flight T(x) for lambda (exposed for diagnostics)
+    static double timeOfFlight(double x, double lambda);
+};
+
+#endif // SOLARSYS_CORE_PHYSICS_LAMBERT_H
@@ -2,7 +2,10 @@
 #define SOLARSYS_CORE_PHYSICS_ORBIT_H
 
 #include "Gravity.h"
+#include "../diagnostics/Profiler.h"
 #include <cmath>
+#include <cstddef>
+#include <vector>
 
 /*--- Keplerian orbital elements ---*/
 struct OrbitalElements {
@@ -31,18 +34,22 @@ public:
         mu = PhysicsConstants::G * centralMass;
     }
 
+    /*--- Conic type (parabolic e == 1 is not supported) ---*/
+    bool isHyperbolic() const { return elements.eccentricity > 1.0; }
+
     /*--- Orbital period (Kepler's 3rd law) ---*/
     double getPeriod() const {
         if (elements.eccentricity >= 1.0) return -1.0;
         return 2.0 * M_PI * std::sqrt(std::pow(elements.semiMajorAxis, 3) / mu);
     }
 
-    /*--- Mean motion (radians per second) ---*/
+    /*--- Mean motion (radians per second; hyperbolic uses |a|) ---*/
     double getMeanMotion() const {
-        return std::sqrt(mu / std::pow(elements.semiMajorAxis, 3));
+        return std::sqrt(mu / std::pow(std::abs(elements.semiMajorAxis), 3));
     }
 
     /*--- Periapsis and apoapsis distances ---*/
+    // Hyperbolic orbits carry a < 0, so a * (1 - e) stays positive
     double getPeriapsis() const {
         return elements.semiMajorAxis * (1.0 - elements.eccentricity);
     }
@@ -57,14 +64,35 @@ public:
         double e = elements.eccentricity;
         double E = meanAnomaly;
         
-        for (int i = 0; i < maxIter; ++i) {
+        int i = 0;
+        while (i < maxIter) {
             double dE = (E - e * std::sin(E) - meanAnomaly) / (1.0 - e * std::cos(E));
             E -= dE;
+            ++i;
             if (std::abs(dE) < tolerance) break;
         }
+        SOLARSYS_PROFILE_COUNT(KEPLER_SOLVES, 1);
+        SOLARSYS_PROFILE_COUNT(KEPLER_ITERATIONS, i);
         return E;
     }
 
+    /*--- Solve the hyperbolic Kepler equation: M = e*sinh(H) - H ---*/
+    double solveHyperbolicKeplerEquation(double meanAnomaly, double tolerance = 1e-12, int maxIter = 100) const {
+        double e = elements.eccentricity;
+        double H = std::asinh(meanAnomaly / e);
+
+        int i = 0;
+        while (i < maxIter) {
+            double dH = (e * std::sinh(H) - H - meanAnomaly) / (e * std::cosh(H) - 1.0);
+            H -= dH;
+            ++i;
+            if (std::abs(dH) < tolerance * (1.0 + std::abs(H))) break;
+        }
+        SOLARSYS_PROFILE_COUNT(KEPLER_SOLVES, 1);
+        SOLARSYS_PROFILE_COUNT(KEPLER_ITERATIONS, i);
+        return H;
+    }
+
     /*--- Convert eccentric anomaly to true anomaly ---*/
     double eccentricToTrueAnomaly(double E) const {
         double e = elements.eccentricity;
@@ -76,54 +104,98 @@ public:
 
     /*--- Get position at given time ---*/
     Vec3 getPositionAtTime(double time) const {
-        double n = getMeanMotion();
-        double M = elements.meanAnomaly + n * (time - elements.epoch);
-        
-        M = std::fmod(M, 2.0 * M_PI);
-        if (M < 0) M += 2.0 * M_PI;
-        
-        double E = solveKeplerEquation(M);
-        double nu = eccentricToTrueAnomaly(E);
-        double r = elements.semiMajorAxis * (1.0 - elements.eccentricity * std::cos(E));
-        
-        double xOrbital = r * std::cos(nu);
-        double yOrbital = r * std::sin(nu);
-        
-        return transformToInertial(xOrbital, yOrbital);
+        double r, cosNu, sinNu;
+        solveAtTime(time, r, cosNu, sinNu);
+        return transformToInertial(r * cosNu, r * sinNu);
     }
 
     /*--- Get velocity at given time ---*/
     Vec3 getVelocityAtTime(double time) const {
-        double n = getMeanMotion();
-        double M = elements.meanAnomaly + n * (time - elements.epoch);
-        M = std::fmod(M, 2.0 * M_PI);
-        if (M < 0) M += 2.0 * M_PI;
-        
-        double E = solveKeplerEquation(M);
-        double nu = eccentricToTrueAnomaly(E);
-        
+        double r, cosNu, sinNu;
+        solveAtTime(time, r, cosNu, sinNu);
+        double vh = mu / specificAngularMomentum();
+        return transformVelocityToInertial(-vh * sinNu, vh * (elements.eccentricity + cosNu));
+    }
+
+    /*--- Position and velocity from a single Kepler solve ---*/
+    void getStateAtTime(double time, Vec3& position, Vec3& velocity) const {
+        double r, cosNu, sinNu;
+        solveAtTime(time, r, cosNu, sinNu);
+        double vh = mu / specificAngularMomentum();
+        position = transformToInertial(r * cosNu, r * sinNu);
+        velocity = transformVelocityToInertial(-vh * sinNu, vh * (elements.eccentricity + cosNu));
+    }
+
+    /*--- Inverse problem: first time strictly after `after` at true anomaly nu ---*/
+    // Closed form (true -> eccentric/hyperbolic -> mean anomaly). Hyperbolic
+    // orbits pass each anomaly at most once; returns false if nu lies beyond the
+    // asymptotes or was already passed.
+    bool nextTimeAtTrueAnomaly(double nu, double after, double& time) const {
         double e = elements.eccentricity;
-        double a = elements.semiMajorAxis;
-        double h = std::sqrt(mu * a * (1.0 - e*e));
-        
-        double vxOrbital = -mu / h * std::sin(nu);
-        double vyOrbital = mu / h * (e + std::cos(nu));
-        
-        return transformVelocityToInertial(vxOrbital, vyOrbital);
+        double n = getMeanMotion();
+        double cosNu = std::cos(nu), sinNu = std::sin(nu);
+        double denom = 1.0 + e * cosNu;
+
+        if (e > 1.0) {
+            if (denom <= 0.0) return false;
+            double H = std::asinh(std::sqrt(e*e - 1.0) * sinNu / denom);
+            time = elements.epoch + (e * std::sinh(H) - H - elements.meanAnomaly) / n;
+            return time > after;
+        }
+
+        double E = std::atan2(std::sqrt(1.0 - e*e) * sinNu, e + cosNu);
+        double period = 2.0 * M_PI / n;
+        double t0 = elements.epoch + (E - e * std::sin(E) - elements.meanAnomaly) / n;
+        time = t0 + (std::floor((after - t0) / period) + 1.0) * period;
+        // Guard against re-hitting `after` itself through rounding
+        if (time <= after + 1e-9 * period) time += period;
+        return true;
     }
 
     /*--- Accessors ---*/
     const OrbitalElements& getElements() const { return elements; }
+    double getMu() const { return mu; }
     double getCentralMass() const { return centralMass; }
 
     /*--- Mutators ---*/
     void setElements(const OrbitalElements& elem) { elements = elem; }
+    // Moves the reference anomaly without moving the epoch. Time-based queries
+    // already propagate from the epoch, so this is for re-basing elements only.
     void updateMeanAnomaly(double dt) {
         elements.meanAnomaly += getMeanMotion() * dt;
         elements.meanAnomaly = std::fmod(elements.meanAnomaly, 2.0 * M_PI);
     }
 
 private:
+    /*--- h = sqrt(mu * p); p = a(1 - e^2) is positive for both conics ---*/
+    double specificAngularMomentum() const {
+        double e = elements.eccentricity;
+        return std::sqrt(mu * elements.semiMajorAxis * (1.0 - e*e));
+    }
+
+    /*--- Radius and true anomaly at time (elliptic or hyperbolic) ---*/
+    void solveAtTime(double time, double& r, double& cosNu, double& sinNu) const {
+        double e = elements.eccentricity;
+        double a = elements.semiMajorAxis;
+        double M = elements.meanAnomaly + getMeanMotion() * (time - elements.epoch);
+        double nu;
+
+        if (e > 1.0) {
+            // Hyperbolic anomaly is unbounded: no wrapping
+            double H = solveHyperbolicKeplerEquation(M);
+            nu = 2.0 * std::atan(std::sqrt((e + 1.0) / (e - 1.0)) * std::tanh(H / 2.0));
+            r = a * (1.0 - e * std::cosh(H));
+        } else {
+            M = std::fmod(M, 2.0 * M_PI);
+            if (M < 0) M += 2.0 * M_PI;
+            double E = solveKeplerEquation(M);
+            nu = eccentricToTrueAnomaly(E);
+            r = a * (1.0 - e * std::cos(E));
+        }
+        cosNu = std::cos(nu);
+        sinNu = std::sin(nu);
+    }
+
     /*--- Transform orbital plane coordinates to inertial frame ---*/
     Vec3 transformToInertial(double xOrb, double yOrb) const {
         double i = elements.inclination;
@@ -146,4 +218,41 @@ private:
     }
 };
 
+/*--- Osculating elements for many bodies, structure-of-arrays ---*/
+// Output of OrbitUtils::stateToElementsBatch. Angles are in [0, 2*pi);
+// hyperbolic entries have a < 0 and carry the hyperbolic mean anomaly.
+struct ElementArrays {
+    std::vector<double> semiMajorAxis;
+    std::vector<double> eccentricity;
+    std::vector<double> inclination;
+    std::vector<double> longitudeOfAscNode;
+    std::vector<double> argumentOfPeriapsis;
+    std::vector<double> trueAnomaly;
+    std::vector<double> meanAnomaly;
+
+    /*--- Scratch for the angle pass (kept to avoid per-call allocation) ---*/
+    std::vector<double> scratch;
+
+    size_t size() const { return eccentricity.size(); }
+    void resize(size_t count);
+    OrbitalElements get(size_t index, double epoch = 0.0) const;
+};
+
+/*--- State vector <-> element conversions (Orbit.cpp) ---*/
+namespace OrbitUtils {
+    // Elements of one relative state; same conventions as the batch version
+    OrbitalElements stateToElements(const Vec3& position, const Vec3& velocity, double mu);
+
+    // Elements of count relative states given as SoA arrays, with a per-body mu.
+    // Elliptic, hyperbolic, circular and equatorial orbits take the same
+    // branch-free path: circular orbits put periapsis on the node (omega = 0),
+    // equatorial orbits put the node on +x (Omega = 0).
+    void stateToElementsBatch(const double* x, const double* y, const double* z,
+                              const double* vx, const double* vy, const double* vz,
+                              const double* mu, size_t count, ElementArrays& out);
+
+    double orbitalEnergy(double mu, double semiMajorAxis);
+    double specificAngularMomentum(double mu, double semiMajorAxis, double eccentricity);
+}
+
 #endif // SOLARSYS_CORE_PHYSICS_ORBIT_H
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef SOLARSYS_CORE_PHYSICS_PARTICLE_GRAVITY_H
+#define SOLARSYS_CORE_PHYSICS_PARTICLE_GRAVITY_H
+
+#include "Integrator.h"
+#include <cstddef>
+#include <vector>
+
+/*--- Arithmetic used for source-particle pair terms ---*/
+enum class ForcePrecision {
+    DOUBLE,     // reference kernel
+    MIXED       // float32 pair terms, double accumulation, near pairs in double
+};
+
+struct MixedPrecisionConfig {
+    // Target relative error of one float32 pair term. Pairs closer than the
+    // distance at which position rounding would exceed it run in double.
+    double pairTolerance = 1e-5;
+};
+
+/*--- Massive bodies acting on test particles, as SoA with G*m folded in ---*/
+struct ForceSources {
+    std::vector<double> x, y, z;
+    std::vector<double> gm;
+
+    size_t size() const { return gm.size(); }
+
+    void assign(const std::vector<BodyState>& massive) {
+        size_t n = massive.size();
+        x.resize(n); y.resize(n); z.resize(n); gm.resize(n);
+        for (size_t j = 0; j < n; ++j) {
+            x[j] = massive[j].position.x;
+            y[j] = massive[j].position.y;
+            z[j] = massive[j].position.z;
+            gm[j] = PhysicsConstants::G * massive[j].mass;
+        }
+    }
+};
+
+/*--- Mixed kernel measured against the double kernel on the same input ---*/
+struct ForceErrorReport {
+    size_t particles = 0;
+    size_t pairs = 0;
+    size_t promotedPairs = 0;       // evaluated in double by the mixed kernel
+    double maxForceError = 0.0;     // |a_mixed - a_double| / |a_double|
+    double rmsForceError = 0.0;
+    double maxEnergyError = 0.0;    // same for the specific potential energy
+    double rmsEnergyError = 0.0;
+};
+
+/*--- Gravity of a few massive sources on many massless particles ---*/
+// Particles are SoA doubles and the loop over them is the vectorized one.
+//
+// MIXED mode walks the particles in blocks. Each block is shifted to its own
+// origin (the centre of its bounding box) and scaled by a power of two, so
+// offsets and source positions fit float32 without overflow in r^3 and keep
+// their full 24-bit mantissa relative to the block rather than to the
+// barycentre. Pair terms are then computed in float (twice the SIMD width of
+// double), summed over groups of four sources and accumulated in double. The
+// float difference of two rounded positions loses accuracy as the pair gets
+// closer than the block and source offsets, so such pairs are flagged and
+// recomputed in double. Blocks are consecutive particles: keep them spatially
+// coherent (e.g. SpatialIndex leaf order) for the local origin to pay off.
+// The gain depends on the SIMD width the core is built for: about 1.4x with
+// SOLARSYS_NATIVE_ARCH on AVX2, but none on the portable SSE2 build, where
+// float/double conversion eats it (up to ~12% slower), so keep DOUBLE there.
+// Check accuracy with measureError() before switching a run over.
+namespace ParticleGravity {
+    // Writes (not adds) accelerations and, if potential is non-null, the
+    // specific potential energy -sum(G*m/r). Pairs closer than 1e-5 m are
+    // skipped like in Gravity::computeAcceleration. Returns the number of
+    // pairs the mixed kernel promoted to double (0 for DOUBLE).
+    size_t accelerations(const ForceSources& sources,
+                         const double* x, const double* y, const double* z, size_t count,
+                         double* ax, double* ay, double* az, double* potential = nullptr,
+                         ForcePrecision precision = ForcePrecision::DOUBLE,
+                         const MixedPrecisionConfig& config = MixedPrecisionConfig());
+
+    // Evaluates both kernels and compares them per particle
+    ForceErrorReport measureError(const ForceSources& sources,
+                                  const double* x, const double* y, const double* z, size_t count,
+                                  const MixedPrecisionConfig& config = MixedPrecisionConfig());
+}
+
+#endif // SOLARSYS_CORE_PHYSICS_PARTICLE_GRAVITY_H
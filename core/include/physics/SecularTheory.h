@@ -0,0 +1,120 @@
+#ifndef SOLARSYS_CORE_PHYSICS_SECULAR_THEORY_H
+#define SOLARSYS_CORE_PHYSICS_SECULAR_THEORY_H
+
+#include "Integrator.h"
+#include "Orbit.h"
+#include <complex>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*--- Which bodies drive the secular evolution ---*/
+// Perturbers are coupled to each other; minor bodies are massless test
+// particles in their field. A minor body whose free frequency lies within
+// resonanceMargin (relative) of a planetary mode is near a secular resonance,
+// where the forced solution blows up and the theory does not hold.
+struct SecularConfig {
+    double minPerturberMass = 1e23;     // kg; Mercury and up, not Pluto
+    double resonanceMargin = 0.05;
+};
+
+/*--- One body handed to SecularSystem::build() ---*/
+struct SecularBody {
+    int id;
+    double mass;
+    Orbit orbit;                        // heliocentric, bound
+};
+
+/*--- Secular model against a direct N-body run from the same start ---*/
+// Errors are distances between eccentricity vectors (e cos w, e sin w) and
+// between inclination vectors (sin I cos O, sin I sin O), with w the
+// longitude of perihelion and O the node, so magnitude and phase count
+// alike. Both sides start from the osculating elements, so the short-period
+// terms the direct run carries are part of the error.
+struct SecularErrorReport {
+    double horizon = 0.0;               // s
+    size_t samples = 0;
+    std::vector<int> ids;               // index-aligned with the per-body errors
+    std::vector<double> eccentricityError;
+    std::vector<double> inclinationError;
+    double maxEccentricityError = 0.0;
+    double maxInclinationError = 0.0;
+    int worstBodyId = -1;               // largest eccentricity error
+    double directSeconds = 0.0;         // wall time of the direct run
+    double secularSeconds = 0.0;        // wall time of the secular evaluations
+};
+
+/*--- Laplace-Lagrange secular theory (Murray & Dermott ch. 7) ---*/
+// Orbit-averaged, first order in the masses and second order in e and I: the
+// eccentricity vectors z = e exp(i w) obey dz/dt = i A z and the inclination
+// vectors zeta = sin(I) exp(i O) obey dzeta/dt = i B zeta, with constant A and
+// B built from Laplace coefficients of the semi-major axis ratios. build()
+// diagonalizes both once (symmetric after scaling by m n a^2), after which
+// the elements at any time are a sum of rotating modes: O(bodies x modes),
+// independent of the time span, so a step may be thousands of years.
+//
+// Semi-major axes are constant and mean longitudes advance at the Keplerian
+// mean motion. Near mean-motion resonances (Jupiter-Saturn's 5:2), at high e
+// or I, or for crossing orbits the linear theory degrades; compareWithDirect()
+// measures how much for a given system and horizon.
+class SecularSystem {
+private:
+    SecularConfig config;
+    double epoch = 0.0;                 // time of the initial elements
+    double starMass = 0.0;
+    size_t perturberCount = 0;
+
+    /*--- Per body (perturbers first, then minor bodies) ---*/
+    std::vector<int> ids;
+    std::vector<double> masses;
+    std::vector<Orbit> initial;         // osculating at epoch
+    std::vector<double> meanMotion;
+    std::vector<double> meanLongitude;  // at epoch
+
+    /*--- Modes: z_b(t) = sum_i amp[b][i] exp(i f_i dt) + free_b exp(i f_b dt) ---*/
+    std::vector<double> eccentricityFrequency;          // g_i, rad/s (perturber modes)
+    std::vector<double> inclinationFrequency;           // s_i
+    std::vector<std::complex<double>> eccentricityAmplitude;    // [body * modes + mode]
+    std::vector<std::complex<double>> inclinationAmplitude;
+    std::vector<double> freeEccentricityFrequency;      // minor bodies (0 for perturbers)
+    std::vector<double> freeInclinationFrequency;
+    std::vector<std::complex<double>> freeEccentricity;
+    std::vector<std::complex<double>> freeInclination;
+    std::vector<bool> nearResonance;
+
+public:
+    /*--- Setup ---*/
+    // Perturbers and minor bodies as osculating orbits at `time`. Fails on an
+    // unbound orbit, no perturber, or two perturbers on the same semi-major axis.
+    bool build(double starMass_, const std::vector<SecularBody>& perturbers,
+               const std::vector<SecularBody>& minorBodies, double time,
+               const SecularConfig& config_ = SecularConfig(), std::string* error = nullptr);
+
+    /*--- Evaluation ---*/
+    // Mean elements of every body at `time`, index-aligned with getIds(), with
+    // epoch = time so Orbit propagates from there
+    void evaluate(double time, std::vector<OrbitalElements>& out) const;
+
+    // Direct run over horizon from the initial elements (star included),
+    // compared with evaluate() at `samples` evenly spaced times. RK4 by
+    // default: velocity Verlet's step-size precession of perihelia is of the
+    // order of the secular rates themselves unless dt is tiny.
+    SecularErrorReport compareWithDirect(double horizon, double dt, size_t samples = 100,
+                                         IntegrationMethod method = IntegrationMethod::RK4) const;
+
+    /*--- Info ---*/
+    const std::vector<int>& getIds() const { return ids; }
+    size_t getPerturberCount() const { return perturberCount; }
+    double getEpoch() const { return epoch; }
+    const SecularConfig& getConfig() const { return config; }
+    const std::vector<double>& getEccentricityFrequencies() const { return eccentricityFrequency; }
+    const std::vector<double>& getInclinationFrequencies() const { return inclinationFrequency; }
+    bool isNearResonance(size_t index) const { return nearResonance[index]; }
+};
+
+namespace SecularTheory {
+    // b_s^(j)(alpha) = (1/pi) * integral over 0..2pi of cos(j psi) / (1 - 2 alpha cos psi + alpha^2)^s
+    double laplaceCoefficient(double s, int j, double alpha);
+}
+
+#endif // SOLARSYS_CORE_PHYSICS_SECULAR_THEORY_H
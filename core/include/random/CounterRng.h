@@ -0,0 +1,149 @@
+#ifndef SOLARSYS_CORE_RANDOM_COUNTER_RNG_H
+#define SOLARSYS_CORE_RANDOM_COUNTER_RNG_H
+
+#include <cstdint>
+#include <cmath>
+#include <limits>
+
+/*--- Counter-based random stream (Philox-4x32-10, Salmon et al. 2011) ---*/
+// Output block n of stream s under seed k is a pure function philox(n, s, k), so
+// a stream can be created anywhere (any thread, any run order) and still yield
+// the same sequence. Separate streams never share state.
+class CounterRng {
+public:
+    using result_type = uint32_t;
+
+private:
+    uint32_t key[2];
+    uint64_t stream;
+    uint64_t block;             // next block index to generate
+    uint32_t buffer[4];
+    int bufferPos;              // 4 = buffer exhausted
+
+    bool hasSpareNormal;
+    double spareNormal;
+
+    static constexpr uint32_t PHILOX_M0 = 0xD2511F53u;
+    static constexpr uint32_t PHILOX_M1 = 0xCD9E8D57u;
+    static constexpr uint32_t PHILOX_W0 = 0x9E3779B9u;
+    static constexpr uint32_t PHILOX_W1 = 0xBB67AE85u;
+
+public:
+    /*--- Constructors ---*/
+    explicit CounterRng(uint64_t seed = 0, uint64_t stream_ = 0)
+        : stream(stream_), block(0), bufferPos(4), hasSpareNormal(false), spareNormal(0.0) {
+        key[0] = static_cast<uint32_t>(seed);
+        key[1] = static_cast<uint32_t>(seed >> 32);
+        buffer[0] = buffer[1] = buffer[2] = buffer[3] = 0;
+    }
+
+    /*--- Stateless block function ---*/
+    static void philox(const uint32_t ctrIn[4], const uint32_t keyIn[2], uint32_t out[4]) {
+        uint32_t c0 = ctrIn[0], c1 = ctrIn[1], c2 = ctrIn[2], c3 = ctrIn[3];
+        uint32_t k0 = keyIn[0], k1 = keyIn[1];
+
+        for (int round = 0; round < 10; ++round) {
+            uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * c0;
+            uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * c2;
+            uint32_t hi0 = static_cast<uint32_t>(p0 >> 32), lo0 = static_cast<uint32_t>(p0);
+            uint32_t hi1 = static_cast<uint32_t>(p1 >> 32), lo1 = static_cast<uint32_t>(p1);
+
+            c0 = hi1 ^ c1 ^ k0;
+            c1 = lo1;
+            c2 = hi0 ^ c3 ^ k1;
+            c3 = lo0;
+
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+        out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+    }
+
+    /*--- Seed derivation (SplitMix64 finalizer) ---*/
+    // Used to give unrelated consumers of the same run seed disjoint keys,
+    // e.g. mixSeed(seed, STELLAR_ACTIVITY) for stars vs. plain seed for perturbations.
+    static uint64_t mixSeed(uint64_t seed, uint64_t domain) {
+        uint64_t z = seed + 0x9E3779B97F4A7C15ull * (domain + 1);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /*--- UniformRandomBitGenerator interface ---*/
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<uint32_t>::max(); }
+    result_type operator()() { return nextU32(); }
+
+    /*--- Raw output ---*/
+    uint32_t nextU32() {
+        if (bufferPos >= 4) refill();
+        return buffer[bufferPos++];
+    }
+
+    uint64_t nextU64() {
+        uint64_t lo = nextU32();
+        uint64_t hi = nextU32();
+        return (hi << 32) | lo;
+    }
+
+    /*--- Distributions ---*/
+    // Uniform in [0, 1) with 53 bits of resolution
+    double uniform() {
+        return static_cast<double>(nextU64() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    double uniform(double a, double b) { return a + (b - a) * uniform(); }
+
+    // Standard normal (Box-Muller, second value cached)
+    double normal() {
+        if (hasSpareNormal) {
+            hasSpareNormal = false;
+            return spareNormal;
+        }
+        double u1 = 1.0 - uniform();   // (0, 1]
+        double u2 = uniform();
+        double r = std::sqrt(-2.0 * std::log(u1));
+        spareNormal = r * std::sin(2.0 * M_PI * u2);
+        hasSpareNormal = true;
+        return r * std::cos(2.0 * M_PI * u2);
+    }
+
+    double normal(double mean, double sigma) { return mean + sigma * normal(); }
+
+    // Exponential waiting time with given rate (events per unit)
+    double exponential(double rate) {
+        if (rate <= 0.0) return std::numeric_limits<double>::infinity();
+        return -std::log(1.0 - uniform()) / rate;
+    }
+
+    /*--- Stream position ---*/
+    uint64_t getStream() const { return stream; }
+    uint64_t getBlock() const { return block; }
+
+    // Jump to an absolute block; O(1) since blocks are independent
+    void seekBlock(uint64_t b) {
+        block = b;
+        bufferPos = 4;
+        hasSpareNormal = false;
+    }
+
+private:
+    void refill() {
+        uint32_t ctr[4] = {
+            static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32),
+            static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)
+        };
+        philox(ctr, key, buffer);
+        ++block;
+        bufferPos = 0;
+    }
+};
+
+/*--- Stream domains for CounterRng::mixSeed ---*/
+namespace RandomDomain {
+    constexpr uint64_t PERTURBATION = 0;
+    constexpr uint64_t STELLAR_ACTIVITY = 1;
+    constexpr uint64_t HUMANITY_EVENTS = 2;
+}
+
+#endif // SOLARSYS_CORE_RANDOM_COUNTER_RNG_H
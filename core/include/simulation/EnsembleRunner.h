@@ -0,0 +1,142 @@
+#ifndef SOLARSYS_CORE_SIMULATION_ENSEMBLE_RUNNER_H
+#define SOLARSYS_CORE_SIMULATION_ENSEMBLE_RUNNER_H
+
+#include "SolarSystem.h"
+#include "../random/CounterRng.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*--- Streaming statistics (Welford, mergeable via Chan et al.) ---*/
+struct RunningStats {
+    uint64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;            // sum of squared deviations from the mean
+    double min = 0.0;
+    double max = 0.0;
+
+    void add(double value) {
+        ++count;
+        if (count == 1) {
+            min = max = value;
+        } else {
+            min = std::min(min, value);
+            max = std::max(max, value);
+        }
+        double delta = value - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (value - mean);
+    }
+
+    void merge(const RunningStats& other) {
+        if (other.count == 0) return;
+        if (count == 0) { *this = other; return; }
+
+        double total = static_cast<double>(count + other.count);
+        double delta = other.mean - mean;
+        mean += delta * static_cast<double>(other.count) / total;
+        m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / total;
+        count += other.count;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    double variance() const { return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+};
+
+/*--- Metrics produced by one run ---*/
+struct RunRecord {
+    size_t runIndex;
+    std::vector<std::pair<std::string, double>> metrics;
+
+    explicit RunRecord(size_t run = 0) : runIndex(run) {}
+    void record(const std::string& name, double value) { metrics.emplace_back(name, value); }
+};
+
+/*--- Aggregated ensemble outcome ---*/
+struct EnsembleSummary {
+    size_t runsCompleted = 0;
+    std::map<std::string, RunningStats> metrics;
+
+    void add(const RunRecord& record) {
+        ++runsCompleted;
+        for (const auto& [name, value] : record.metrics) metrics[name].add(value);
+    }
+
+    void merge(const EnsembleSummary& other) {
+        runsCompleted += other.runsCompleted;
+        for (const auto& [name, stats] : other.metrics) metrics[name].merge(stats);
+    }
+};
+
+/*--- Ensemble configuration ---*/
+struct EnsembleConfig {
+    size_t runCount = 1000;
+    uint64_t stepsPerRun = 365;
+    uint64_t seed = 0;          // master seed; run r uses stream r under this seed
+    unsigned threadCount = 0;   // 0 = hardware concurrency
+    size_t runsPerChunk = 1;    // work-stealing granularity
+};
+
+/*--- Monte Carlo runner: clone, perturb, step, observe, aggregate ---*/
+// Every run draws from CounterRng(seed, runIndex), so results depend only on the
+// master seed and the run index, never on thread count or scheduling order
+// (aggregates may differ in the last bits, since merge order follows scheduling).
+// Per-run records are folded into per-worker summaries as they finish; memory
+// is O(workers x metrics), not O(runs).
+class EnsembleRunner {
+public:
+    /*--- Hooks ---*/
+    using Perturbation = std::function<void(SolarSystem& system, CounterRng& rng, size_t runIndex)>;
+    using Observer = std::function<void(const SolarSystem& system, RunRecord& record)>;
+    using RunCallback = std::function<void(const RunRecord& record)>;
+
+private:
+    EnsembleConfig config;
+    Perturbation perturbation;
+    Observer observer;
+    RunCallback runCallback;
+
+public:
+    /*--- Constructors ---*/
+    explicit EnsembleRunner(const EnsembleConfig& config_ = EnsembleConfig())
+        : config(config_) {}
+
+    /*--- Configuration ---*/
+    void setConfig(const EnsembleConfig& c) { config = c; }
+    const EnsembleConfig& getConfig() const { return config; }
+    void setPerturbation(Perturbation p) { perturbation = std::move(p); }
+    void setObserver(Observer o) { observer = std::move(o); }
+
+    // Called once per finished run (serialized); use for streaming export
+    void setRunCallback(RunCallback cb) { runCallback = std::move(cb); }
+
+    /*--- Execution ---*/
+    EnsembleSummary run(const SolarSystem& base) const;
+
+    // Executes a single run exactly as run() would; useful to replay an outlier
+    RunRecord runSingle(const SolarSystem& base, size_t runIndex) const;
+};
+
+/*--- Common perturbations ---*/
+namespace EnsemblePerturbations {
+    // Gaussian jitter of Keplerian elements: relative sigma on a, absolute on e
+    // (clamped to [0, 0.99]), radians on i / Ω / ω / M
+    EnsembleRunner::Perturbation jitterOrbits(double sigmaSemiMajorRel, double sigmaEccentricity,
+                                              double sigmaAngle);
+
+    // Gaussian jitter of N-body positions (m) and velocities (m/s)
+    EnsembleRunner::Perturbation jitterStates(double sigmaPosition, double sigmaVelocity);
+
+    // Apply several perturbations in order, sharing the run's stream
+    EnsembleRunner::Perturbation combine(std::vector<EnsembleRunner::Perturbation> parts);
+}
+
+#endif // SOLARSYS_CORE_SIMULATION_ENSEMBLE_RUNNER_H
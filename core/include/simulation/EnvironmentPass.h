@@ -0,0 +1,94 @@
+#ifndef SOLARSYS_CORE_SIMULATION_ENVIRONMENT_PASS_H
+#define SOLARSYS_CORE_SIMULATION_ENVIRONMENT_PASS_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class SolarSystem;
+class Comet;
+
+/*--- Comet activity transition ---*/
+struct EnvironmentEvent {
+    enum class Type { TAIL_ACTIVATED, TAIL_DEACTIVATED };
+
+    Type type;
+    int bodyId;
+    double time;        // simulation seconds
+    double distance;    // heliocentric distance at the transition (meters)
+};
+
+/*--- Bulk irradiance / comet activity update ---*/
+// Applies Star::irradianceAtDistance, shouldHaveActiveTail and
+// estimateComaRadius to every tracked body in one pass over dense arrays
+// (index i matches SolarSystem::getBodyStates()[i]). The kernel is a flat
+// loop without per-body branches so it vectorizes; transitions are found in
+// a second scan over the flag bytes, so listeners only hear about changes.
+//
+// Tails use hysteresis: a tail switches on inside TAIL_ACTIVATION_AU and
+// only switches off again beyond TAIL_ACTIVATION_AU * (1 + hysteresis), so
+// a comet grazing the threshold doesn't flicker.
+class EnvironmentPass {
+public:
+    using Listener = std::function<void(const EnvironmentEvent&)>;
+
+private:
+    /*--- Dense per-body arrays ---*/
+    std::vector<int> ids;
+    std::vector<double> px, py, pz;         // gathered positions
+    std::vector<double> distance;           // heliocentric, meters
+    std::vector<double> irradiance;         // W/m^2
+    std::vector<double> comaRadius;         // meters, 0 for non-comets
+    std::vector<double> nucleusRadius;      // meters, 0 for non-comets
+    std::vector<uint8_t> isComet;
+    std::vector<uint8_t> activeTail;
+    std::vector<uint8_t> previousTail;
+    std::vector<Comet*> comets;             // write-back targets, nullptr for non-comets
+
+    uint32_t interval;
+    double hysteresis;
+    uint64_t lastTick;
+    bool hasRun;
+
+    std::vector<EnvironmentEvent> events;   // transitions from the latest pass
+    Listener listener;
+
+public:
+    /*--- Constructors ---*/
+    explicit EnvironmentPass(uint32_t interval_ = 1, double hysteresis_ = 0.1)
+        : interval(interval_ > 0 ? interval_ : 1), hysteresis(hysteresis_ > 0.0 ? hysteresis_ : 0.0),
+          lastTick(0), hasRun(false) {}
+
+    /*--- Configuration ---*/
+    void setInterval(uint32_t ticks) { interval = ticks > 0 ? ticks : 1; }
+    void setHysteresis(double fraction) { hysteresis = fraction > 0.0 ? fraction : 0.0; }
+    void setListener(Listener l) { listener = std::move(l); }
+
+    /*--- Updating ---*/
+    // Runs the pass if at least `interval` ticks passed since the last one.
+    // Re-gathers the body layout when it changed, then writes tail flags and
+    // coma radii back to the Comet objects. Returns true if the pass ran.
+    bool update(SolarSystem& system);
+
+    // Core kernel on caller-provided heliocentric positions (count = getBodyCount()).
+    // irradianceAtUnitDistance is Star::irradianceAtDistance(1.0).
+    void compute(const double* x, const double* y, const double* z,
+                 double irradianceAtUnitDistance, double time);
+
+    // Re-reads body ids, comet flags and nucleus radii from the system
+    void rebuild(const SolarSystem& system);
+
+    /*--- Results (dense, index-aligned with getIds()) ---*/
+    size_t getBodyCount() const { return ids.size(); }
+    const std::vector<int>& getIds() const { return ids; }
+    const std::vector<double>& getDistances() const { return distance; }
+    const std::vector<double>& getIrradiance() const { return irradiance; }
+    const std::vector<double>& getComaRadii() const { return comaRadius; }
+    const std::vector<uint8_t>& getActiveTails() const { return activeTail; }
+    const std::vector<EnvironmentEvent>& getEvents() const { return events; }
+
+private:
+    bool layoutMatches(const SolarSystem& system) const;
+};
+
+#endif // SOLARSYS_CORE_SIMULATION_ENVIRONMENT_PASS_H
@@ -0,0 +1,83 @@
+#ifndef SOLARSYS_CORE_SIMULATION_KEYFRAME_HISTORY_H
+#define SOLARSYS_CORE_SIMULATION_KEYFRAME_HISTORY_H
+
+#include "../celestial/Star.h"
+#include "../physics/Integrator.h"
+#include "../physics/Orbit.h"
+#include "../physics/SecularTheory.h"
+#include "../time/TimeSystem.h"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/*--- How often the run is captured and how a seek may reconstruct ---*/
+// A seek replays at most interval - 1 steps forward from the keyframe before
+// the target; with reverseReplay and velocity Verlet (time-symmetric) it
+// instead integrates backward from the keyframe after the target when that
+// one is closer, capping the work at interval / 2 steps.
+struct KeyframeConfig {
+    uint64_t interval = 256;        // ticks between keyframes
+    bool reverseReplay = true;
+};
+
+/*--- Full simulation state at one tick ---*/
+struct Keyframe {
+    uint64_t tick;
+    TimeSystem clock;
+    bool keplerian;
+    IntegrationMethod method;
+    std::vector<BodyState> states;
+    std::shared_ptr<const std::unordered_map<int, Orbit>> orbits;  // shared while unchanged
+    uint64_t orbitGeneration;
+    std::vector<int> numericalBodies;   // promoted bodies (Keplerian mode)
+    std::shared_ptr<const SecularSystem> secular;
+    FlareScheduleState flares;          // of the central star (generation 0 without one)
+};
+
+/*--- Outcome of SolarSystem::seekTo() ---*/
+struct SeekResult {
+    bool ok = false;
+    double time = 0.0;              // reached time (on the recorded tick grid)
+    uint64_t tick = 0;
+    uint64_t steps = 0;             // integration steps taken
+    bool backward = false;
+    bool exact = false;             // bit-identical to what the recorded run had at that tick
+};
+
+/*--- Sparse keyframes of one timeline, ordered by tick ---*/
+// Storage only; SolarSystem records into it and reconstructs from it.
+class KeyframeHistory {
+private:
+    KeyframeConfig config;
+    std::vector<Keyframe> keyframes;
+
+public:
+    /*--- Constructors ---*/
+    explicit KeyframeHistory(const KeyframeConfig& config_ = KeyframeConfig()) : config(config_) {}
+
+    /*--- Recording ---*/
+    bool isDue(uint64_t tick) const {
+        return keyframes.empty() || tick >= keyframes.back().tick + config.interval;
+    }
+    // Inserts in tick order, replacing a keyframe at the same tick
+    void store(Keyframe frame);
+    // Drops every keyframe after tick (a changed state starts a new future)
+    void truncateAfter(uint64_t tick);
+    void clear() { keyframes.clear(); }
+
+    /*--- Lookup (nullptr when there is none) ---*/
+    // Last keyframe at or before time, or the first one if time precedes them all
+    const Keyframe* findBefore(double time) const;
+    const Keyframe* findAfter(uint64_t tick) const;
+    const Keyframe* latest() const { return keyframes.empty() ? nullptr : &keyframes.back(); }
+    // Orbits of the latest keyframe when its generation matches, for sharing
+    std::shared_ptr<const std::unordered_map<int, Orbit>> reusableOrbits(uint64_t generation) const;
+
+    /*--- Info ---*/
+    const KeyframeConfig& getConfig() const { return config; }
+    size_t size() const { return keyframes.size(); }
+    size_t memoryBytes() const;
+};
+
+#endif // SOLARSYS_CORE_SIMULATION_KEYFRAME_HISTORY_H
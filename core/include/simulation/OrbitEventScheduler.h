@@ -0,0 +1,128 @@
+#ifndef SOLARSYS_CORE_SIMULATION_ORBIT_EVENT_SCHEDULER_H
+#define SOLARSYS_CORE_SIMULATION_ORBIT_EVENT_SCHEDULER_H
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+class SolarSystem;
+
+/*--- Analytically predictable orbit events ---*/
+enum class OrbitEventType : uint8_t {
+    PERIAPSIS,
+    APOAPSIS,               // elliptic orbits only
+    DISTANCE_INBOUND,       // crossing a watched distance moving inward
+    DISTANCE_OUTBOUND,      // crossing a watched distance moving outward
+    ASCENDING_NODE,         // inclined orbits only
+    DESCENDING_NODE
+};
+
+namespace OrbitEventMask {
+    constexpr uint32_t bit(OrbitEventType t) { return 1u << static_cast<uint32_t>(t); }
+
+    constexpr uint32_t APSIDES = bit(OrbitEventType::PERIAPSIS) | bit(OrbitEventType::APOAPSIS);
+    constexpr uint32_t NODES = bit(OrbitEventType::ASCENDING_NODE) | bit(OrbitEventType::DESCENDING_NODE);
+}
+
+struct OrbitEvent {
+    OrbitEventType type;
+    int bodyId;
+    double time;            // simulation seconds
+    double distance;        // threshold for DISTANCE_* events, else 0
+};
+
+/*--- Event queue over Keplerian orbits ---*/
+// Each watched (body, event) pair keeps exactly one prediction in a min-heap,
+// solved in closed form with Orbit::nextTimeAtTrueAnomaly. Popping an event
+// schedules its next occurrence. When elements change, the body's version is
+// bumped and its old heap entries are skipped lazily instead of searched for.
+// SolarSystem::getOrbitGeneration() is checked on every query, so setOrbit(),
+// reseedOrbitsFromStates() or edits through getOrbits() trigger re-prediction
+// from the current clock without any explicit call; so does every step in
+// secular mode (getSecularRevision()), which rewrites the elements.
+class OrbitEventScheduler {
+public:
+    using Listener = std::function<void(const OrbitEvent&)>;
+
+private:
+    struct DistanceWatch {
+        double distance;
+        bool inbound;
+        bool outbound;
+    };
+
+    struct Watch {
+        uint32_t mask = 0;
+        std::vector<DistanceWatch> distances;
+        uint64_t version = 0;
+    };
+
+    struct Entry {
+        double time;
+        int bodyId;
+        OrbitEventType type;
+        int32_t distanceIndex;  // -1 unless DISTANCE_*
+        uint64_t version;
+
+        // Min-heap on time; ties broken by body and type for reproducibility
+        bool operator>(const Entry& o) const {
+            if (time != o.time) return time > o.time;
+            if (bodyId != o.bodyId) return bodyId > o.bodyId;
+            return type > o.type;
+        }
+    };
+
+    std::unordered_map<int, Watch> watches;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    std::vector<int> dirty;         // bodies whose watches changed since the last query
+    uint64_t seenGeneration;
+    uint64_t seenSecularRevision;
+    uint64_t versionCounter;        // global, so a re-added watch never revives old entries
+    bool primed;
+
+public:
+    /*--- Constructors ---*/
+    OrbitEventScheduler() : seenGeneration(0), seenSecularRevision(0), versionCounter(0), primed(false) {}
+
+    /*--- Watches (predicted lazily on the next query) ---*/
+    void watch(int bodyId, uint32_t mask);
+    void watchDistance(int bodyId, double distance, bool inbound = true, bool outbound = true);
+    // CometActivity::TAIL_ACTIVATION_AU in both directions for every comet
+    void watchCometActivity(const SolarSystem& system);
+    void unwatch(int bodyId);
+    void clear();
+
+    /*--- Prediction ---*/
+    // Re-predicts every watch from the system clock
+    void rebuild(const SolarSystem& system);
+    // Re-predicts one body, e.g. after a manoeuvre changed its elements
+    void invalidate(const SolarSystem& system, int bodyId);
+
+    /*--- Queries ---*/
+    bool peek(const SolarSystem& system, OrbitEvent& out);
+    // Removes the earliest event and schedules that watch's next occurrence
+    bool pop(const SolarSystem& system, OrbitEvent& out);
+
+    /*--- Event-driven time advance (Keplerian mode) ---*/
+    // Jumps the clock from event to event up to endTime, setting the clock to
+    // each event before calling onEvent, then to endTime. Nothing between
+    // events is evaluated and jumps do not count as ticks. Listeners may change
+    // orbits; the remaining events are re-predicted. Returns the number of
+    // events delivered, or 0 without advancing if the system is in N-body mode.
+    size_t advanceTo(SolarSystem& system, double endTime, const Listener& onEvent);
+
+    size_t getWatchCount() const { return watches.size(); }
+    // Heap size, including stale entries not yet skipped
+    size_t getQueuedCount() const { return queue.size(); }
+
+private:
+    void sync(const SolarSystem& system);
+    void predictBody(const SolarSystem& system, int bodyId, double after);
+    void schedule(const SolarSystem& system, int bodyId, const Watch& w,
+                  OrbitEventType type, int32_t distanceIndex, double after);
+    void dropStale();
+};
+
+#endif // SOLARSYS_CORE_SIMULATION_ORBIT_EVENT_SCHEDULER_H
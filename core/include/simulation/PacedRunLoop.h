@@ -0,0 +1,109 @@
+#ifndef SOLARSYS_CORE_SIMULATION_PACED_RUN_LOOP_H
+#define SOLARSYS_CORE_SIMULATION_PACED_RUN_LOOP_H
+
+#include "../physics/Integrator.h"
+#include <cstdint>
+#include <functional>
+
+class SolarSystem;
+
+/*--- Wall-clock pacing for interactive sessions ---*/
+// Fixed-dt accumulator ("fix your timestep"): each frame adds
+// wallElapsed * simRate simulated seconds to the accumulator and runs whole
+// steps of stepSeconds while it lasts. At most maxStepsPerFrame steps run per
+// frame; anything beyond that is discarded (and reported as dropped) so a
+// slow step can't snowball into ever longer frames. The leftover fraction is
+// the interpolation alpha between the state before and after the last step.
+//
+// Clock and sleep are injectable so the loop can be driven deterministically.
+class PacedRunLoop {
+public:
+    using StepFunc = std::function<void()>;
+    using ClockFunc = std::function<double()>;         // monotonic seconds
+    using SleepFunc = std::function<void(double)>;     // seconds
+
+    struct FrameResult {
+        uint32_t steps = 0;         // steps run this frame
+        double alpha = 0.0;         // [0, 1): position between previous and current state
+        bool capped = false;        // hit maxStepsPerFrame and dropped the backlog
+    };
+
+    struct Metrics {
+        uint64_t frames = 0;
+        uint64_t steps = 0;
+        uint64_t droppedSteps = 0;      // steps discarded by the per-frame cap
+        double lastFrameSeconds = 0.0;  // wall time between the last two frames
+        double avgFrameSeconds = 0.0;   // exponential moving average
+        double maxFrameSeconds = 0.0;
+        double avgStepSeconds = 0.0;    // wall time per step, moving average
+        double stepLag = 0.0;           // backlog in steps before the cap was applied
+        double achievedRate = 0.0;      // simulated seconds per wall second, moving average
+    };
+
+private:
+    StepFunc stepFunc;
+    StepFunc snapshotFunc;
+    ClockFunc clock;
+    SleepFunc sleeper;
+
+    double stepSeconds;         // simulated seconds per step
+    double simRate;             // simulated seconds per wall second
+    uint32_t maxStepsPerFrame;
+    double targetFrameSeconds;  // 0 = run frames back to back
+    bool paused;
+
+    double accumulator;         // simulated seconds not yet stepped
+    double lastFrameTime;
+    bool started;
+    Metrics metrics;
+
+public:
+    /*--- Constructors ---*/
+    PacedRunLoop(StepFunc step, double stepSeconds_, double simRate_ = 1.0);
+
+    // Steps system.step() at its current time step (timeStep * timeScale)
+    static PacedRunLoop forSystem(SolarSystem& system, double simRate_ = 1.0);
+
+    /*--- Configuration ---*/
+    void setSimRate(double rate) { simRate = rate > 0.0 ? rate : 0.0; }
+    void setStepSeconds(double seconds) { if (seconds > 0.0) stepSeconds = seconds; }
+    void setMaxStepsPerFrame(uint32_t n) { maxStepsPerFrame = n > 0 ? n : 1; }
+    void setTargetFrameRate(double fps) { targetFrameSeconds = fps > 0.0 ? 1.0 / fps : 0.0; }
+    void setClock(ClockFunc c, SleepFunc s) { clock = std::move(c); sleeper = std::move(s); started = false; }
+
+    // Called right before the last step of a frame, so consumers can keep the
+    // "previous" state for interpolation without copying on every step
+    void setSnapshotHook(StepFunc hook) { snapshotFunc = std::move(hook); }
+
+    void pause() { paused = true; }
+    void resume() { paused = false; started = false; }  // don't bill the pause as lag
+    bool isPaused() const { return paused; }
+
+    /*--- Accessors ---*/
+    double getSimRate() const { return simRate; }
+    double getStepSeconds() const { return stepSeconds; }
+    double getAlpha() const { return stepSeconds > 0.0 ? accumulator / stepSeconds : 0.0; }
+    const Metrics& getMetrics() const { return metrics; }
+    void resetMetrics() { metrics = Metrics(); }
+
+    /*--- Driving ---*/
+    // One frame: measure wall time since the previous frame, run the steps it
+    // pays for and return the interpolation alpha. Does not sleep.
+    FrameResult runFrame();
+
+    // Wall seconds until the next frame is due (0 if already late)
+    double timeUntilNextFrame() const;
+
+    // Repeats runFrame(), hands the result to onFrame and sleeps until the next
+    // frame deadline (or yields when there is no frame rate target). Returns
+    // when onFrame returns false.
+    void run(const std::function<bool(const FrameResult&)>& onFrame);
+
+    /*--- Interpolation helper ---*/
+    // out[i].position/velocity = lerp(previous[i], current[i], alpha). Bodies are
+    // matched by index; if the layouts differ the current states are copied.
+    static void interpolate(const std::vector<BodyState>& previous, const std::vector<BodyState>& current,
+                            double alpha, std::vector<BodyState>& out);
+};
+
+#endif // SOLARSYS_CORE_SIMULATION_PACED_RUN_LOOP_H
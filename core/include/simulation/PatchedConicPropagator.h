@@ -0,0 +1,122 @@
+#ifndef SOLARSYS_CORE_SIMULATION_PATCHED_CONIC_PROPAGATOR_H
+#define SOLARSYS_CORE_SIMULATION_PATCHED_CONIC_PROPAGATOR_H
+
+#include "../physics/Orbit.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class SolarSystem;
+class ArtificialBody;
+class WorkStealingPool;
+
+/*--- Sphere-of-influence radius model ---*/
+enum class SoiModel {
+    LAPLACE,    // a * (m/M)^(2/5), the classic patched-conic radius
+    HILL        // Gravity::hillSphereRadius, larger and more conservative
+};
+
+struct PatchedConicConfig {
+    SoiModel soiModel = SoiModel::LAPLACE;
+    double minFrameMass = 1e20;         // kg; lighter bodies never capture a craft
+    double entryTolerance = 1e-9;       // crossing accuracy, fraction of R_soi
+    int maxRefineIterations = 60;
+};
+
+/*--- Frame change of one craft ---*/
+struct SoiTransition {
+    int craftId;
+    int fromBodyId;
+    int toBodyId;
+    double time;            // simulation seconds
+};
+
+/*--- Patched-conic spacecraft propagation ---*/
+// Every craft follows a Kepler arc relative to exactly one body: the star, or
+// a massive body from the system's (heliocentric) orbits while inside that
+// body's sphere of influence. Moons are not nested inside their planets.
+//
+// Leaving a planetary SOI is closed form (the outbound crossing of r = R_soi
+// on the relative conic). Entering one is found by conservative advancement
+// on f(t) = |r_craft - r_body| - R_soi: with relative speed v and a bound A
+// on the relative acceleration, f cannot reach zero sooner than the h that
+// solves h*(v + A*h) = f, so far from every planet a few large steps cover a
+// whole cruise. The bracketed crossing is refined with regula falsi.
+class PatchedConicPropagator {
+private:
+    /*--- Body with its own SOI, on a heliocentric Keplerian orbit ---*/
+    struct FrameBody {
+        int id;
+        double mass;
+        double soiRadius;
+        double maxAcceleration;     // star's pull at periapsis, bounds f''
+        Orbit orbit;
+    };
+
+    struct Craft {
+        int id;
+        int frame;                  // index into frames, -1 for the star
+        Orbit orbit;                // relative to the frame body
+        double time;
+        double maxAcceleration;     // only used while heliocentric
+        int excludedFrame;          // SOI just left; ignored until clear of it
+        std::vector<SoiTransition> pending;
+    };
+
+    PatchedConicConfig config;
+    int starId;
+    double starMass;
+    std::vector<FrameBody> frames;
+    std::vector<Craft> crafts;
+    std::unordered_map<int, size_t> craftIndex;
+    std::vector<SoiTransition> transitions;
+    WorkStealingPool* pool;
+
+public:
+    /*--- Constructors ---*/
+    // Frames are the star plus every orbit whose body is at least minFrameMass
+    explicit PatchedConicPropagator(const SolarSystem& system, const PatchedConicConfig& config = PatchedConicConfig(),
+                                    WorkStealingPool* pool = nullptr);
+
+    /*--- Craft management ---*/
+    // State relative to frameBodyId (the star id for heliocentric) at `time`.
+    // Returns false for an unknown frame or a duplicate craft id.
+    bool addCraft(int craftId, int frameBodyId, const Vec3& position, const Vec3& velocity, double time);
+    // Seeds from the body's stored a/e/i about its central body, at periapsis
+    // with zero node and argument of periapsis
+    bool addCraft(const ArtificialBody& body, double time);
+    bool removeCraft(int craftId);
+
+    /*--- Propagation ---*/
+    // Advances every craft to `time`, switching frames at SOI crossings
+    void propagateTo(double time);
+
+    // Heliocentric state at the craft's current time
+    bool getState(int craftId, Vec3& position, Vec3& velocity) const;
+    int getFrameBodyId(int craftId) const;
+    const Orbit* getOrbit(int craftId) const;
+
+    // Copies a/e/i and central body of each craft to the matching ArtificialBody
+    void writeBack(SolarSystem& system) const;
+
+    /*--- Transition log (ordered by time, appended by propagateTo) ---*/
+    const std::vector<SoiTransition>& getTransitions() const { return transitions; }
+    void clearTransitions() { transitions.clear(); }
+
+    /*--- Accessors ---*/
+    size_t getCraftCount() const { return crafts.size(); }
+    size_t getFrameCount() const { return frames.size(); }
+    double getSoiRadius(int bodyId) const;
+
+private:
+    void advance(Craft& craft, double endTime) const;
+    // Earliest SOI entry in (craft.time, endTime]; returns the frame index or -1
+    int findEntry(Craft& craft, double endTime, double& entryTime) const;
+    double entryResidual(const Craft& craft, const FrameBody& body, double t) const;
+    void switchFrame(Craft& craft, int newFrame, double time) const;
+    int frameIndexOf(int bodyId) const;       // -2 if bodyId has no frame
+    int frameBodyId(int frame) const { return frame < 0 ? starId : frames[frame].id; }
+    double frameMass(int frame) const { return frame < 0 ? starMass : frames[frame].mass; }
+};
+
+#endif // SOLARSYS_CORE_SIMULATION_PATCHED_CONIC_PROPAGATOR_H
@@ -0,0 +1,154 @@
+#ifndef SOLARSYS_CORE_SIMULATION_PIPELINED_RUN_LOOP_H
+#define SOLARSYS_CORE_SIMULATION_PIPELINED_RUN_LOOP_H
+
+#include "../physics/Integrator.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class SolarSystem;
+
+/*--- Immutable copy of the state after one step ---*/
+struct PipelineSnapshot {
+    uint64_t sequence = 0;      // step number within run(), from 1
+    uint64_t tick = 0;
+    double time = 0.0;
+    std::vector<BodyState> states;
+};
+
+/*--- What the stepping thread does when a stage's queue is full ---*/
+enum class QueuePolicy {
+    BLOCK,          // wait for the stage (lossless, may slow physics down)
+    DROP_NEWEST,    // skip this snapshot for the stage
+    DROP_OLDEST     // replace the oldest queued snapshot
+};
+
+struct PipelineStageConfig {
+    size_t capacity = 4;                    // queued snapshots, excluding the one in progress
+    QueuePolicy policy = QueuePolicy::BLOCK;
+    uint32_t stride = 1;                    // offer every stride-th step
+};
+
+/*--- Pipelined stepping ---*/
+// The calling thread only steps and captures: after step N it copies the
+// state into a free slot of a preallocated snapshot ring and offers the slot
+// to every stage, then goes on with step N+1 while each stage's own thread
+// consumes its bounded queue. A slot returns to the ring once every stage
+// that took it is done. The ring holds 1 + sum(capacity + 1) slots, enough
+// for every queue to be full and every stage busy, so with drop policies the
+// stepping thread never waits; BLOCK stages make it wait (counted as stall).
+//
+// With setPipelined(false) the stages run inline after each step instead,
+// which gives the serial baseline with identical stage work.
+class PipelinedRunLoop {
+public:
+    using StepFunc = std::function<void()>;
+    using CaptureFunc = std::function<void(PipelineSnapshot&)>;     // fill tick, time and states
+    using StageFunc = std::function<void(const PipelineSnapshot&)>;
+
+    struct StageStats {
+        std::string name;
+        uint64_t processed = 0;
+        uint64_t dropped = 0;
+        size_t maxDepth = 0;        // deepest the queue got
+        double busySeconds = 0.0;   // inside the stage function
+        double stallSeconds = 0.0;  // stepping thread blocked on this stage
+    };
+
+    struct Metrics {
+        uint64_t steps = 0;
+        double wallSeconds = 0.0;
+        double stepSeconds = 0.0;       // inside StepFunc
+        double captureSeconds = 0.0;    // copying into the ring
+        double stallSeconds = 0.0;      // waiting on BLOCK stages or for a free slot
+    };
+
+private:
+    struct Stage {
+        std::string name;
+        StageFunc func;
+        PipelineStageConfig config;
+
+        std::mutex mutex;
+        std::condition_variable notEmpty;
+        std::condition_variable notFull;
+        std::deque<size_t> queue;       // ring slots
+        bool closing = false;
+        std::thread thread;
+        StageStats stats;
+    };
+
+    StepFunc stepFunc;
+    CaptureFunc captureFunc;
+    std::vector<std::unique_ptr<Stage>> stages;
+    bool pipelined;
+
+    std::vector<PipelineSnapshot> ring;
+    std::unique_ptr<std::atomic<int>[]> references;
+    std::mutex ringMutex;
+    std::condition_variable slotFreed;
+    std::vector<size_t> freeSlots;
+
+    Metrics metrics;
+
+public:
+    /*--- Constructors & Destructors ---*/
+    PipelinedRunLoop(StepFunc step, CaptureFunc capture);
+    // system.step(), capturing getBodyStates() (synced from orbits in Keplerian mode)
+    explicit PipelinedRunLoop(SolarSystem& system);
+    ~PipelinedRunLoop() = default;
+
+    PipelinedRunLoop(const PipelinedRunLoop&) = delete;
+    PipelinedRunLoop& operator=(const PipelinedRunLoop&) = delete;
+
+    /*--- Configuration (between runs) ---*/
+    size_t addStage(const std::string& name, StageFunc func, const PipelineStageConfig& config = PipelineStageConfig());
+    void setPipelined(bool enabled) { pipelined = enabled; }
+    bool isPipelined() const { return pipelined; }
+
+    /*--- Driving ---*/
+    // Runs `steps` steps; returns once every stage has drained its queue
+    void run(uint64_t steps);
+
+    /*--- Accessors ---*/
+    const Metrics& getMetrics() const { return metrics; }
+    size_t getStageCount() const { return stages.size(); }
+    const StageStats& getStageStats(size_t stage) const { return stages[stage]->stats; }
+    size_t getRingSize() const { return ring.size(); }
+    void resetMetrics();
+
+private:
+    void prepareRing();
+    void runStage(Stage& stage);
+    void offer(Stage& stage, size_t slot);
+    void release(size_t slot);
+    size_t acquireSlot();
+};
+
+/*--- Ready-made stage functions ---*/
+namespace PipelineStages {
+    struct DiagnosticSample {
+        uint64_t tick;
+        double time;
+        double energy;
+        Vec3 angularMomentum;
+        Vec3 centerOfMass;
+    };
+
+    // IntegratorUtils conservation checks appended to `out` (stage thread only
+    // until run() returns)
+    PipelinedRunLoop::StageFunc diagnostics(std::vector<DiagnosticSample>& out);
+
+    // CSV rows "tick,time,id,x,y,z,vx,vy,vz" per body; writes the header first
+    PipelinedRunLoop::StageFunc trajectoryCsv(std::ostream& out);
+}
+
+#endif // SOLARSYS_CORE_SIMULATION_PIPELINED_RUN_LOOP_H
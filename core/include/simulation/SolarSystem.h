@@ -9,12 +9,26 @@
 #include "../celestial/DwarfPlanet.h"
 #include "../celestial/ArtificialBody.h"
 #include "../physics/Integrator.h"
+#include "../physics/EncounterRegularization.h"
 #include "../physics/Orbit.h"
+#include "../physics/SecularTheory.h"
+#include "KeyframeHistory.h"
 #include "../time/TimeSystem.h"
+#include "../diagnostics/Profiler.h"
 
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
+
+/*--- Per-body propagation inside Keplerian mode ---*/
+enum class PropagationMode { KEPLERIAN, NUMERICAL };
+
+// Keplerian bodies lighter than minSourceMass do not pull on the numerical
+// ones, so a Keplerian main belt stays out of the force loop
+struct HybridConfig {
+    double minSourceMass = 1e20;    // kg; Ceres, Vesta and Pallas still count
+};
 
 class SolarSystem {
 private:
@@ -40,10 +54,105 @@ private:
     IntegrationMethod integrationMethod;
     bool useKeplerianOrbits;    // true = analytical, false = N-body
 
+    /*--- Close-encounter regularization (N-body mode, off by default) ---*/
+    bool regularizeEncounters;
+    EncounterConfig encounterConfig;
+    EncounterStats encounterStats;
+    std::vector<EncounterPair> encounterPairs;      // scratch, rebuilt every step
+    std::vector<BodyState> encounterScratch;
+
+    /*--- Numerically integrated bodies inside Keplerian mode ---*/
+    std::unordered_set<int> numericalBodies;
+    HybridConfig hybridConfig;
+    struct HybridSource {
+        int id;
+        double mass;
+        const Orbit* orbit;
+    };
+    std::vector<HybridSource> hybridSources;        // massive Keplerian bodies, by id
+    bool hybridSourcesValid;
+    uint64_t hybridSourcesGeneration;
+    bool hybridAccelerationsStale;                  // stored accelerations predate an edit
+    std::vector<size_t> hybridIndices;              // scratch: bodyStates entries being integrated
+    std::vector<size_t> hybridMassive;              // scratch: positions in hybridIndices that pull
+    std::vector<Vec3> hybridSourcePositions;
+    std::vector<Vec3> hybridStages;
+
+    /*--- Orbit-averaged secular evolution of the Keplerian orbits (off by default) ---*/
+    std::shared_ptr<const SecularSystem> secular;   // immutable, shared by clones and keyframes
+    std::vector<OrbitalElements> secularElements;   // scratch
+
+    /*--- Keyframe history (off by default) ---*/
+    bool recordHistory;
+    bool historyDirty;              // state edited outside step(): the next step or seek re-bases the timeline
+    bool historyApproximate;        // reached by backward integration: the next step re-bases
+    uint64_t historyGeneration;     // orbitGeneration the history last saw
+    KeyframeHistory history;
+
+    /*--- Lazy Keplerian evaluation ---*/
+    // Keplerian bodies are evaluated only when queried; one Kepler solve per body
+    // per tick yields both position and velocity. Entries are keyed on the sample
+    // time, so advancing the clock invalidates them implicitly. Queries mutate this
+    // cache: concurrent readers need their own clone().
+    struct KeplerSample {
+        double time;
+        Vec3 position;
+        Vec3 velocity;
+    };
+    mutable std::unordered_map<int, KeplerSample> keplerCache;
+
+    // Bumped whenever orbital elements may have changed (event re-prediction)
+    uint64_t orbitGeneration;
+    // Bumped by every secular rewrite of the elements, which keeps
+    // orbitGeneration (history, caches) but must still reach event observers
+    uint64_t secularRevision = 0;
+
+    // Memoized orbit state at the current time, nullptr if the body has no orbit
+    const KeplerSample* sampleOrbit(int bodyId) const;
+
+    void integrateBody(BodyState& state, double dt) {
+        switch (integrationMethod) {
+            case IntegrationMethod::EULER:
+                Integrator::euler(state, dt, Integrator::nBodyAcceleration, bodyStates);
+                break;
+            case IntegrationMethod::SYMPLECTIC_EULER:
+                Integrator::symplecticEuler(state, dt, Integrator::nBodyAcceleration, bodyStates);
+                break;
+            case IntegrationMethod::VELOCITY_VERLET:
+                Integrator::velocityVerlet(state, dt, Integrator::nBodyAcceleration, bodyStates);
+                break;
+            case IntegrationMethod::RK4:
+                Integrator::rk4(state, dt, Integrator::nBodyAcceleration, bodyStates);
+                break;
+        }
+    }
+
+    // N-body step with encounterPairs advanced by EncounterRegularization (SolarSystem.cpp)
+    void stepWithEncounters(double dt);
+
+    // Numerical bodies of Keplerian mode, one synchronous step in the heliocentric frame (SolarSystem.cpp)
+    void stepHybrid(double dt);
+    void refreshHybridSources();
+    // Accelerations at `time` for the numerical bodies at `positions` (hybridIndices order)
+    void hybridAccelerations(double time, const Vec3* positions, Vec3* out);
+    void initializeHybridAccelerations();
+
+    // Rewrites the orbits of the secular bodies with their mean elements at
+    // the current time; no generation bump, the clock already invalidated the
+    // Kepler samples (SolarSystem.cpp)
+    void syncSecularOrbits();
+
+    // Keyframe of the current state; re-basing also drops the keyframes after it (SolarSystem.cpp)
+    void recordKeyframe();
+    void rebaseHistory();
+    void restoreKeyframe(const Keyframe& frame);
+
 public:
     SolarSystem() 
         : integrationMethod(IntegrationMethod::VELOCITY_VERLET),
-          useKeplerianOrbits(true) {}
+          useKeplerianOrbits(true), regularizeEncounters(false), hybridSourcesValid(false), hybridSourcesGeneration(0), hybridAccelerationsStale(false),
+          recordHistory(false), historyDirty(false),
+          historyApproximate(false), historyGeneration(0), orbitGeneration(0) {}
 
     /*--- Initialization ---*/
     void setStar(std::unique_ptr<Star> s) { star = std::move(s); }
@@ -54,49 +163,138 @@ public:
     void addComet(std::unique_ptr<Comet> c) { comets.push_back(std::move(c)); }
     void addArtificialBody(std::unique_ptr<ArtificialBody> ab) { artificialBodies.push_back(std::move(ab)); }
 
-    void setOrbit(int bodyId, const Orbit& orbit) { orbits[bodyId] = orbit; }
+    void setOrbit(int bodyId, const Orbit& orbit) {
+        orbits[bodyId] = orbit;
+        keplerCache.erase(bodyId);
+        ++orbitGeneration;
+    }
+    void setBodyStates(const std::vector<BodyState>& states) {
+        bodyStates = states;
+        historyDirty = true;
+        hybridAccelerationsStale = true;
+    }
+
+    /*--- State materialization (SolarSystem.cpp) ---*/
+    // Rebuilds bodyStates: star at the origin, then one entry per orbit sorted by
+    // id; numerical bodies keep their integrated state. Barycentric seeding
+    // shifts everything so the centre of mass is at rest at the origin and
+    // fills in the accelerations, ready for an N-body run.
+    void initializeBodyStates(bool barycentric = false);
+    // Rewrites positions/velocities of orbit-driven entries in place (no
+    // reallocation); numerical bodies are left alone
+    void syncBodyStatesFromOrbits();
+
+    /*--- Osculating elements (SolarSystem.cpp) ---*/
+    // Elements of every body state relative to centralBodyId with mu = G * (M + m),
+    // index-aligned with getBodyStates(); the central entry itself is NaN.
+    // Returns false if no body state has that id.
+    bool computeOsculatingElements(int centralBodyId, ElementArrays& out) const;
+    // Replaces the orbit of every other body state with its osculating orbit at the
+    // current time (e.g. to resume Keplerian mode after an N-body phase);
+    // numerical bodies keep their states, moved into the central body's frame
+    size_t reseedOrbitsFromStates(int centralBodyId);
+
+    /*--- Deep copy (independent bodies, orbits, states and clock) ---*/
+    SolarSystem clone() const {
+        SolarSystem copy;
+        if (star) copy.star = std::make_unique<Star>(*star);
+        for (const auto& p : planets) copy.planets.push_back(std::make_unique<Planet>(*p));
+        for (const auto& m : moons) copy.moons.push_back(std::make_unique<NaturalSatellite>(*m));
+        for (const auto& dp : dwarfPlanets) copy.dwarfPlanets.push_back(std::make_unique<DwarfPlanet>(*dp));
+        for (const auto& a : asteroids) copy.asteroids.push_back(std::make_unique<Asteroid>(*a));
+        for (const auto& c : comets) copy.comets.push_back(std::make_unique<Comet>(*c));
+        for (const auto& ab : artificialBodies) copy.artificialBodies.push_back(std::make_unique<ArtificialBody>(*ab));
+        copy.bodyStates = bodyStates;
+        copy.orbits = orbits;
+        copy.timeSystem = timeSystem;
+        copy.integrationMethod = integrationMethod;
+        copy.useKeplerianOrbits = useKeplerianOrbits;
+        copy.regularizeEncounters = regularizeEncounters;
+        copy.encounterConfig = encounterConfig;
+        copy.numericalBodies = numericalBodies;
+        copy.hybridConfig = hybridConfig;
+        copy.hybridAccelerationsStale = hybridAccelerationsStale;
+        copy.secular = secular;
+        copy.recordHistory = recordHistory;
+        copy.historyDirty = historyDirty;
+        copy.historyApproximate = historyApproximate;
+        copy.historyGeneration = historyGeneration;
+        copy.history = history;
+        copy.orbitGeneration = orbitGeneration;
+        copy.secularRevision = secularRevision;
+        return copy;
+    }
 
     /*--- Simulation step ---*/
     void step() {
+        SOLARSYS_PROFILE_SCOPE(STEP);
         double dt = timeSystem.getTimeStep();
+        // Before re-basing, so keyframes hold the accelerations the step uses
+        if (useKeplerianOrbits && hybridAccelerationsStale) initializeHybridAccelerations();
+        if (recordHistory && (historyDirty || historyApproximate || orbitGeneration != historyGeneration)) {
+            rebaseHistory();
+        }
 
         if (useKeplerianOrbits) {
-            // Analytical orbital propagation
-            for (auto& [id, orbit] : orbits) {
-                orbit.updateMeanAnomaly(dt);
-            }
+            // Analytical propagation is a pure function of time: advancing the
+            // clock is the whole step, positions are solved lazily on query.
+            // Only promoted bodies are integrated.
+            if (!numericalBodies.empty()) stepHybrid(dt);
         } else {
             // N-body numerical integration
-            for (auto& state : bodyStates) {
-                switch (integrationMethod) {
-                    case IntegrationMethod::EULER:
-                        Integrator::euler(state, dt, Integrator::nBodyAcceleration, bodyStates);
-                        break;
-                    case IntegrationMethod::SYMPLECTIC_EULER:
-                        Integrator::symplecticEuler(state, dt, Integrator::nBodyAcceleration, bodyStates);
-                        break;
-                    case IntegrationMethod::VELOCITY_VERLET:
-                        Integrator::velocityVerlet(state, dt, Integrator::nBodyAcceleration, bodyStates);
-                        break;
-                    case IntegrationMethod::RK4:
-                        Integrator::rk4(state, dt, Integrator::nBodyAcceleration, bodyStates);
-                        break;
-                }
+            SOLARSYS_PROFILE_SCOPE(NBODY_INTEGRATION);
+            SOLARSYS_PROFILE_COUNT(FORCE_EVALUATIONS,
+                bodyStates.size() * (integrationMethod == IntegrationMethod::RK4 ? 5 : 1));
+            SOLARSYS_PROFILE_COUNT(PAIR_INTERACTIONS,
+                bodyStates.size() * (bodyStates.size() - 1) * (integrationMethod == IntegrationMethod::RK4 ? 5 : 1));
+            if (regularizeEncounters) {
+                EncounterRegularization::findPairs(bodyStates, dt, encounterConfig, encounterPairs);
+                encounterStats.lastStepPairs = encounterPairs.size();
+            }
+            if (regularizeEncounters && !encounterPairs.empty()) {
+                stepWithEncounters(dt);
+            } else {
+                for (auto& state : bodyStates) integrateBody(state, dt);
             }
         }
 
         timeSystem.tick();
+        if (secular) syncSecularOrbits();
+        // Flares are scheduled events: a tick without one is a comparison
+        if (star) star->advanceActivity(timeSystem.getCurrentTime());
+        if (recordHistory && history.isDue(timeSystem.getTickCount())) recordKeyframe();
     }
 
+    /*--- Body lookup across all categories (nullptr if unknown) ---*/
+    const CelestialBody* findBody(int bodyId) const;
+
     /*--- Accessors ---*/
     TimeSystem& getTimeSystem() { return timeSystem; }
     const TimeSystem& getTimeSystem() const { return timeSystem; }
     Star* getStar() { return star.get(); }
+    const Star* getStar() const { return star.get(); }
     const std::vector<std::unique_ptr<Planet>>& getPlanets() const { return planets; }
+    const std::vector<std::unique_ptr<Comet>>& getComets() const { return comets; }
+    const std::vector<std::unique_ptr<ArtificialBody>>& getArtificialBodies() const { return artificialBodies; }
+
+    // Mutable access may change elements, so it drops every memoized sample
+    std::unordered_map<int, Orbit>& getOrbits() {
+        keplerCache.clear();
+        ++orbitGeneration;
+        return orbits;
+    }
+    const std::unordered_map<int, Orbit>& getOrbits() const { return orbits; }
+    uint64_t getOrbitGeneration() const { return orbitGeneration; }
+    // Changes on every secular step; observers of the elements watch both
+    uint64_t getSecularRevision() const { return secularRevision; }
+    // Edits through this reference are invisible to the history and to the
+    // stored accelerations of numerical bodies: follow them with markStateEdited()
+    std::vector<BodyState>& getBodyStates() { return bodyStates; }
+    const std::vector<BodyState>& getBodyStates() const { return bodyStates; }
     
     Vec3 getBodyPosition(int bodyId) const {
-        if (useKeplerianOrbits && orbits.count(bodyId)) {
-            return orbits.at(bodyId).getPositionAtTime(timeSystem.getCurrentTime());
+        if (useKeplerianOrbits && !numericalBodies.count(bodyId)) {
+            if (const KeplerSample* sample = sampleOrbit(bodyId)) return sample->position;
         }
         for (const auto& state : bodyStates) {
             if (state.id == bodyId) return state.position;
@@ -104,9 +302,99 @@ public:
         return Vec3();
     }
 
+    Vec3 getBodyVelocity(int bodyId) const {
+        if (useKeplerianOrbits && !numericalBodies.count(bodyId)) {
+            if (const KeplerSample* sample = sampleOrbit(bodyId)) return sample->velocity;
+        }
+        for (const auto& state : bodyStates) {
+            if (state.id == bodyId) return state.velocity;
+        }
+        return Vec3();
+    }
+
+    size_t getCachedKeplerSampleCount() const { return keplerCache.size(); }
+
     /*--- Configuration ---*/
-    void setIntegrationMethod(IntegrationMethod method) { integrationMethod = method; }
-    void setUseKeplerianOrbits(bool use) { useKeplerianOrbits = use; }
+    void setIntegrationMethod(IntegrationMethod method) {
+        integrationMethod = method;
+        historyDirty = true;
+    }
+    void setUseKeplerianOrbits(bool use) {
+        useKeplerianOrbits = use;
+        historyDirty = true;
+        hybridAccelerationsStale = true;
+    }
+    IntegrationMethod getIntegrationMethod() const { return integrationMethod; }
+    bool isUsingKeplerianOrbits() const { return useKeplerianOrbits; }
+    // Close pairs found at the start of each N-body step are integrated as
+    // regularized two-body subsystems; everything else keeps the chosen method
+    void setEncounterRegularization(bool enabled, const EncounterConfig& config = EncounterConfig()) {
+        regularizeEncounters = enabled;
+        encounterConfig = config;
+        encounterStats.lastStepPairs = 0;
+    }
+    bool isRegularizingEncounters() const { return regularizeEncounters; }
+    const EncounterConfig& getEncounterConfig() const { return encounterConfig; }
+    const EncounterStats& getEncounterStats() const { return encounterStats; }
+
+    /*--- Per-body propagation (SolarSystem.cpp) ---*/
+    // In Keplerian mode a promoted body is integrated with the chosen method in
+    // the heliocentric frame of the orbits: the star (fixed at the origin) and
+    // every other body of at least HybridConfig::minSourceMass pull on it, each
+    // with the indirect term of the star's reflex motion; numerical bodies do
+    // not pull back on the Keplerian ones. Promotion seeds the state from the
+    // orbit at the current time (or keeps the existing state of a body with no
+    // orbit); demotion replaces the orbit with the osculating one around the
+    // star. Both return false in N-body mode, where every body is integrated.
+    bool promoteToNumerical(int bodyId);
+    bool demoteToKeplerian(int bodyId);
+    PropagationMode getPropagationMode(int bodyId) const {
+        return !useKeplerianOrbits || numericalBodies.count(bodyId) ? PropagationMode::NUMERICAL
+                                                                     : PropagationMode::KEPLERIAN;
+    }
+    size_t getNumericalBodyCount() const { return numericalBodies.size(); }
+    void setHybridConfig(const HybridConfig& config) {
+        hybridConfig = config;
+        hybridSourcesValid = false;
+    }
+    const HybridConfig& getHybridConfig() const { return hybridConfig; }
+
+    /*--- Secular mode (SolarSystem.cpp) ---*/
+    // Evolves the orbital elements of the planets (heliocentric orbits of at
+    // least config.minPerturberMass) and of the listed minor bodies with
+    // Laplace-Lagrange secular theory, starting from their orbits now. The
+    // orbits are rewritten at every step, so a step may span thousands of
+    // years and positions still come from the Keplerian path (mean longitudes
+    // included). Other orbits are left alone. Needs a star and Keplerian
+    // mode; fails with a message otherwise. Disabling keeps the last elements.
+    // SecularSystem::compareWithDirect() gives the error against N-body.
+    bool setSecularMode(bool enabled, const std::vector<int>& minorBodyIds = {},
+                        const SecularConfig& config = SecularConfig(), std::string* error = nullptr);
+    bool isSecular() const { return secular != nullptr; }
+    const SecularSystem* getSecularSystem() const { return secular.get(); }
+
+    /*--- History seek (SolarSystem.cpp) ---*/
+    // Records a keyframe now and then every config.interval ticks from step().
+    // Edits made outside step() (setBodyStates, setOrbit, mode switches) re-base
+    // the timeline at the next step: a keyframe of the edited state replaces
+    // everything recorded after it.
+    void setHistoryRecording(bool enabled, const KeyframeConfig& config = KeyframeConfig());
+    bool isRecordingHistory() const { return recordHistory; }
+    const KeyframeHistory& getHistory() const { return history; }
+    void markStateEdited() {
+        historyDirty = true;
+        hybridAccelerationsStale = true;
+    }
+
+    // Moves the whole simulation to the recorded tick nearest `time`: restores
+    // the keyframe before it and replays step() (bit-identical to the original
+    // run), or integrates backward from the keyframe after it when that is
+    // closer. Backward needs velocity Verlet without encounter regularization;
+    // the in-place sweep is undone exactly up to rounding, and stepping on
+    // from such a state re-bases the timeline. Keplerian stretches are
+    // restored without integrating. Past the last keyframe the run is
+    // simulated forward, recording as usual.
+    SeekResult seekTo(double time);
     
     /*--- Statistics ---*/
     size_t getTotalBodyCount() const {
@@ -116,4 +404,10 @@ public:
     }
 };
 
+namespace SolarSystemUtils {
+    // Circular coplanar orbits of radii r1 -> r2 around mu
+    double hohmannTransferDeltaV(double mu, double r1, double r2);
+    double hohmannTransferTime(double mu, double r1, double r2);
+}
+
 #endif // SOLARSYS_CORE_SIMULATION_SOLARSYSTEM_H
\ No newline at end of file
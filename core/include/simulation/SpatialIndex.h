@@ -0,0 +1,136 @@
+#ifndef SOLARSYS_CORE_SIMULATION_SPATIAL_INDEX_H
+#define SOLARSYS_CORE_SIMULATION_SPATIAL_INDEX_H
+
+#include "../physics/Integrator.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SolarSystem;
+class WorkStealingPool;
+
+/*--- One query result ---*/
+struct SpatialHit {
+    int bodyId;
+    uint32_t stateIndex;    // index into the BodyState array the snapshot was built from
+    double distance;        // from the query point (cone: from the apex)
+};
+
+/*--- Cone query: bodies within range whose direction from apex is inside halfAngle ---*/
+struct SpatialCone {
+    Vec3 apex;
+    Vec3 direction;         // need not be normalized
+    double halfAngle;       // radians
+    double range;           // meters
+};
+
+/*--- Flattened batch results: hits of query i are hits[offsets[i] .. offsets[i+1]) ---*/
+struct SpatialQueryResults {
+    std::vector<size_t> offsets;
+    std::vector<SpatialHit> hits;
+
+    size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    const SpatialHit* begin(size_t query) const { return hits.data() + offsets[query]; }
+    const SpatialHit* end(size_t query) const { return hits.data() + offsets[query + 1]; }
+    size_t count(size_t query) const { return offsets[query + 1] - offsets[query]; }
+};
+
+/*--- Immutable k-d tree over body positions at one instant ---*/
+// Points are stored permuted into leaf order as SoA so leaf scans are flat
+// loops. Once published by SpatialIndex a snapshot is never written again, so
+// any number of threads may query it while the simulation steps on.
+class SpatialSnapshot {
+    friend class SpatialIndex;
+
+private:
+    struct Node {
+        double lo[3];
+        double hi[3];
+        uint32_t begin;
+        uint32_t end;
+        uint32_t left;          // right child is left + 1; 0 marks a leaf
+    };
+
+    std::vector<Node> nodes;
+    std::vector<double> px, py, pz;
+    std::vector<int> ids;
+    std::vector<uint32_t> order;        // leaf slot -> state index
+    double time = 0.0;
+    uint64_t tick = 0;
+    double builtExtent = 0.0;           // summed leaf box extents right after build
+
+public:
+    /*--- Queries (thread-safe) ---*/
+    // Unordered; a body at the query point itself is included with distance 0
+    void radius(const Vec3& center, double radius, std::vector<SpatialHit>& out) const;
+    // Up to k hits sorted by distance
+    void nearest(const Vec3& point, size_t k, std::vector<SpatialHit>& out) const;
+    // Unordered; the apex body itself is excluded (its direction is undefined)
+    void cone(const SpatialCone& query, std::vector<SpatialHit>& out) const;
+
+    /*--- Batch queries (optionally spread over a pool) ---*/
+    void radiusBatch(const std::vector<Vec3>& centers, double radius, SpatialQueryResults& out,
+                     WorkStealingPool* pool = nullptr) const;
+    void nearestBatch(const std::vector<Vec3>& points, size_t k, SpatialQueryResults& out,
+                      WorkStealingPool* pool = nullptr) const;
+    void coneBatch(const std::vector<SpatialCone>& queries, SpatialQueryResults& out,
+                   WorkStealingPool* pool = nullptr) const;
+
+    /*--- Accessors ---*/
+    size_t size() const { return ids.size(); }
+    double getTime() const { return time; }
+    uint64_t getTick() const { return tick; }
+
+private:
+    void build(const std::vector<BodyState>& states);
+    // Same layout, new positions: re-gather points and recompute boxes bottom-up
+    void refit(const SpatialSnapshot& topology, const std::vector<BodyState>& states);
+    void buildNode(uint32_t node, uint32_t begin, uint32_t end);
+    void computeBounds(Node& node) const;
+    double leafExtent() const;
+};
+
+/*--- Double-buffered publisher ---*/
+// update() runs on the stepping thread. It refits the previous tree when the
+// body layout is unchanged and the refitted leaf boxes have not grown past
+// rebuildThreshold times their built size, else rebuilds from scratch. The new
+// snapshot is published with an atomic shared_ptr store; readers that call
+// snapshot() keep their tree alive for as long as they hold it. The buffer
+// published two updates ago is recycled once no reader holds it: the deleter
+// of its published handle runs after the last release and sets the buffer's
+// retired flag (release), which update() checks (acquire) before writing.
+class SpatialIndex {
+private:
+    struct Buffer {
+        std::shared_ptr<SpatialSnapshot> tree;
+        std::shared_ptr<std::atomic<bool>> retired;     // no published handle left
+    };
+
+    std::shared_ptr<const SpatialSnapshot> current;     // atomic access only
+    Buffer front;
+    Buffer back;
+    double rebuildThreshold;
+    uint64_t rebuildCount;
+    uint64_t refitCount;
+
+public:
+    /*--- Constructors ---*/
+    explicit SpatialIndex(double rebuildThreshold_ = 1.5)
+        : rebuildThreshold(rebuildThreshold_ > 1.0 ? rebuildThreshold_ : 1.0),
+          rebuildCount(0), refitCount(0) {}
+
+    /*--- Updating (single writer) ---*/
+    void update(const std::vector<BodyState>& states, double time, uint64_t tick);
+    // Syncs Keplerian body states first, like EnvironmentPass
+    void update(SolarSystem& system);
+
+    /*--- Reading (any thread) ---*/
+    std::shared_ptr<const SpatialSnapshot> snapshot() const;
+
+    /*--- Statistics ---*/
+    uint64_t getRebuildCount() const { return rebuildCount; }
+    uint64_t getRefitCount() const { return refitCount; }
+};
+
+#endif // SOLARSYS_CORE_SIMULATION_SPATIAL_INDEX_H
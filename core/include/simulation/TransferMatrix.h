@@ -0,0 +1,137 @@
+#ifndef SOLARSYS_CORE_SIMULATION_TRANSFER_MATRIX_H
+#define SOLARSYS_CORE_SIMULATION_TRANSFER_MATRIX_H
+
+#include "../time/TimeSystem.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+class SolarSystem;
+
+/*--- Refresh schedule ---*/
+// A pair is re-evaluated after refreshFraction of its synodic period, and at
+// least twice as often as its next window is away, so window times sharpen
+// as a window approaches. Intervals are clamped to [minRefresh, maxRefresh].
+struct TransferMatrixConfig {
+    double refreshFraction = 0.05;
+    double minRefresh = TimeConstants::DAY;
+    double maxRefresh = TimeConstants::YEAR;
+};
+
+/*--- Cached cost of one direct transfer ---*/
+// Hohmann transfer between the bodies' osculating heliocentric semi-major
+// axes; the window is when the target leads the origin by the Hohmann phase
+// angle, extrapolated with the mean motions between refreshes.
+struct TransferLeg {
+    double deltaV = std::numeric_limits<double>::infinity();        // m/s
+    double transferTime = std::numeric_limits<double>::infinity();  // s
+    double synodicPeriod = std::numeric_limits<double>::infinity(); // s
+    double windowTime = std::numeric_limits<double>::infinity();    // next window at computation time
+    double computedAt = 0.0;
+    double refreshAt = 0.0;
+
+    // Time from t to the next window, assuming the mean motions hold
+    double waitAt(double t) const;
+};
+
+enum class RouteMetric { DELTA_V, TRANSFER_TIME };
+
+struct RouteQuery {
+    int from;
+    int to;
+};
+
+struct Route {
+    std::vector<int> bodies;    // from, stops..., to; empty when unreachable
+    double deltaV = 0.0;
+    double transferTime = 0.0;  // sum of leg transfer times (waits not chained)
+    bool found = false;
+};
+
+/*--- All-pairs transfer cost between colonizable bodies ---*/
+// update() only re-evaluates the pairs whose refresh time has come (kept in a
+// queue), and everything when the system's orbits were reseeded; lookups are
+// O(1). Body states are read heliocentric, relative to the system's star.
+//
+// Direct Hohmann legs rarely beat each other through a stop, so routing is
+// for ships with a per-leg delta-v budget: findRoutes() drops legs above
+// maxLegDeltaV and runs Floyd-Warshall over the rest, cached until a leg
+// changes or the metric/budget differs, so a batch of queries costs one
+// O(n^3) pass plus the path lengths.
+class TransferMatrix {
+private:
+    TransferMatrixConfig config;
+    std::vector<int> bodyIds;
+    std::unordered_map<int, size_t> bodyIndex;
+    std::vector<TransferLeg> legs;      // [from * n + to]
+
+    struct Due {
+        double time;
+        uint32_t from;
+        uint32_t to;                    // from < to; both directions refresh together
+        bool operator>(const Due& other) const { return time > other.time; }
+    };
+    std::priority_queue<Due, std::vector<Due>, std::greater<Due>> queue;
+
+    bool initialized;
+    uint64_t orbitGeneration;
+    uint64_t version;                   // bumps whenever a leg changes
+    uint64_t refreshes;
+    double lastUpdate;
+
+    /*--- Route cache ---*/
+    uint64_t routeVersion;
+    RouteMetric routeMetric;
+    double routeBudget;
+    std::vector<double> routeCost;      // [from * n + to]
+    std::vector<int32_t> routeNext;     // next stop on the best path, -1 when unreachable
+
+    struct BodySample {
+        double mu;                      // of the star and the body
+        double semiMajorAxis;
+        double longitude;               // ecliptic longitude
+        double meanMotion;              // rad/s
+    };
+    std::vector<BodySample> samples;
+    std::vector<double> sampleTime;     // time each sample was taken, NaN when stale
+
+public:
+    /*--- Constructors ---*/
+    explicit TransferMatrix(const std::vector<int>& bodyIds_,
+                            const TransferMatrixConfig& config_ = TransferMatrixConfig());
+
+    /*--- Maintenance ---*/
+    // Refreshes the due pairs; returns how many (unordered) pairs were evaluated
+    size_t update(const SolarSystem& system);
+    void refreshAll(const SolarSystem& system);
+
+    /*--- Lookup (O(1)); null / infinite for unknown bodies ---*/
+    const TransferLeg* find(int from, int to) const;
+    double getDeltaV(int from, int to) const;
+    double getTransferTime(int from, int to) const;
+    // Wait for the next window plus the transfer itself, departing no earlier than t
+    double getTravelTime(int from, int to, double t) const;
+
+    /*--- Multi-hop routes ---*/
+    void findRoutes(const std::vector<RouteQuery>& queries, std::vector<Route>& out,
+                    RouteMetric metric = RouteMetric::DELTA_V,
+                    double maxLegDeltaV = std::numeric_limits<double>::infinity());
+    Route findRoute(int from, int to, RouteMetric metric = RouteMetric::DELTA_V,
+                    double maxLegDeltaV = std::numeric_limits<double>::infinity());
+
+    /*--- Info ---*/
+    const std::vector<int>& getBodyIds() const { return bodyIds; }
+    const TransferMatrixConfig& getConfig() const { return config; }
+    uint64_t getVersion() const { return version; }
+    uint64_t getRefreshCount() const { return refreshes; }
+
+private:
+    const BodySample& sample(const SolarSystem& system, size_t body, double t);
+    void refreshPair(const SolarSystem& system, size_t i, size_t j, double t);
+    void solveRoutes(RouteMetric metric, double maxLegDeltaV);
+};
+
+#endif // SOLARSYS_CORE_SIMULATION_TRANSFER_MATRIX_H
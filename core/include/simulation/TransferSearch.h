@@ -0,0 +1,88 @@
+#ifndef SOLARSYS_CORE_SIMULATION_TRANSFER_SEARCH_H
+#define SOLARSYS_CORE_SIMULATION_TRANSFER_SEARCH_H
+
+#include "../physics/Lambert.h"
+#include "../physics/Orbit.h"
+#include <vector>
+
+class WorkStealingPool;
+
+/*--- Launch date x time-of-flight grid ---*/
+struct PorkchopConfig {
+    double launchStart = 0.0;       // simulation seconds
+    double launchEnd = 0.0;
+    size_t launchSteps = 100;
+    double tofMin = 0.0;            // seconds
+    double tofMax = 0.0;
+    size_t tofSteps = 100;
+    bool prograde = true;
+
+    double launchStep() const { return launchSteps > 1 ? (launchEnd - launchStart) / (launchSteps - 1) : 0.0; }
+    double tofStep() const { return tofSteps > 1 ? (tofMax - tofMin) / (tofSteps - 1) : 0.0; }
+};
+
+/*--- One evaluated transfer ---*/
+struct TransferCandidate {
+    double launchTime = 0.0;
+    double timeOfFlight = 0.0;
+    double departureVInf = 0.0;     // |v_transfer - v_planet| at departure (m/s); C3 = vInf^2
+    double arrivalVInf = 0.0;       // at arrival (m/s)
+    double totalDeltaV = 0.0;       // departureVInf + arrivalVInf
+    Vec3 departureVelocity;         // heliocentric transfer velocity at launch
+    bool valid = false;
+};
+
+/*--- Dense porkchop result, row-major [launch][tof]; NaN where Lambert failed ---*/
+struct PorkchopGrid {
+    PorkchopConfig config;
+    std::vector<double> departureVInf;
+    std::vector<double> arrivalVInf;
+
+    size_t index(size_t launch, size_t tof) const { return launch * config.tofSteps + tof; }
+    double launchTime(size_t launch) const { return config.launchStart + launch * config.launchStep(); }
+    double timeOfFlight(size_t tof) const { return config.tofMin + tof * config.tofStep(); }
+    double totalDeltaV(size_t launch, size_t tof) const {
+        size_t k = index(launch, tof);
+        return departureVInf[k] + arrivalVInf[k];
+    }
+};
+
+/*--- Lambert-based transfer window search between two heliocentric orbits ---*/
+// Unlike SolarSystemUtils::hohmannTransferDeltaV this uses the real (eccentric,
+// inclined) orbits and phasing, so it answers *when* to launch.
+//
+// computeGrid() evaluates every cell: departure states are solved once per
+// launch row, arrival states come from a Hermite-interpolated ephemeris table
+// (exact at the nodes, ~1e-11 relative in between), and each Lambert solve is
+// warm-started from its neighbour along the time-of-flight axis, which usually
+// converges in one or two Householder steps. Rows run on the pool when given.
+// findWindows() then refines the best local minima on successively finer
+// local grids around them.
+class TransferSearch {
+private:
+    Orbit departure;
+    Orbit arrival;
+    double mu;
+    WorkStealingPool* pool;
+
+public:
+    /*--- Constructors ---*/
+    // Both orbits must share the central body (mu is taken from `from`)
+    TransferSearch(const Orbit& from, const Orbit& to, WorkStealingPool* pool_ = nullptr);
+
+    /*--- Single transfer ---*/
+    TransferCandidate evaluate(double launchTime, double timeOfFlight, bool prograde = true) const;
+
+    /*--- Full grid ---*/
+    PorkchopGrid computeGrid(const PorkchopConfig& config) const;
+
+    /*--- Best windows: local minima of totalDeltaV, refined refineLevels times ---*/
+    std::vector<TransferCandidate> findWindows(const PorkchopConfig& config, size_t maxWindows = 3,
+                                               int refineLevels = 4) const;
+
+    // Same, reusing an already computed grid
+    std::vector<TransferCandidate> findWindows(const PorkchopGrid& grid, size_t maxWindows = 3,
+                                               int refineLevels = 4) const;
+};
+
+#endif // SOLARSYS_CORE_SIMULATION_TRANSFER_SEARCH_H
@@ -0,0 +1,71 @@
+#ifndef SOLARSYS_CORE_SIMULATION_WORK_STEALING_POOL_H
+#define SOLARSYS_CORE_SIMULATION_WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*--- Persistent thread pool with per-worker deques and work stealing ---*/
+// parallelFor() splits [0, count) into grain-sized chunks dealt round-robin to
+// the workers. A worker drains its own deque from the back and, once empty,
+// steals from the front of the others, so uneven chunks (runs that end early,
+// slow Lambert cells) rebalance automatically.
+// One parallelFor() at a time; calls from several threads must be serialized.
+class WorkStealingPool {
+public:
+    /*--- Task signature: half-open index range plus executing worker id ---*/
+    using Task = std::function<void(size_t begin, size_t end, unsigned worker)>;
+
+private:
+    /*--- A chunk carries its task so late workers never mix jobs ---*/
+    struct Chunk {
+        size_t begin;
+        size_t end;
+        const Task* task;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Chunk> chunks;
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+    /*--- Job hand-off ---*/
+    std::mutex jobMutex;
+    std::condition_variable jobReady;
+    std::condition_variable jobDone;
+    uint64_t generation;
+    std::atomic<size_t> remainingChunks;
+    std::exception_ptr firstError;
+    bool stopping;
+
+public:
+    /*--- Constructors & Destructors ---*/
+    explicit WorkStealingPool(unsigned threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /*--- Execution ---*/
+    void parallelFor(size_t count, size_t grain, const Task& task);
+
+    /*--- Accessors ---*/
+    unsigned getThreadCount() const { return static_cast<unsigned>(threads.size()); }
+
+private:
+    bool popLocal(unsigned worker, Chunk& out);
+    bool steal(unsigned worker, Chunk& out);
+    void workerLoop(unsigned worker);
+};
+
+#endif // SOLARSYS_CORE_SIMULATION_WORK_STEALING_POOL_H
@@ -55,6 +55,10 @@ public:
     double getHours() const { return currentTime / TimeConstants::HOUR; }
 
     /*--- Mutators ---*/
+    // Moves the clock without ticking (event-driven jumps in Keplerian mode)
+    void setCurrentTime(double time) { currentTime = time; }
+    // Rewinds the tick counter along with the clock (history seeks)
+    void setTickCount(uint64_t count) { tickCount = count; }
     void setTimeStep(double step) { timeStep = step; }
     void setTimeScale(double scale) { timeScale = scale; }
     void pause() { paused = true; }
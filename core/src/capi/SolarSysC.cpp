@@ -0,0 +1,270 @@
+#include "../../include/capi/SolarSysC.h"
+#include "../../include/io/ScenarioLoader.h"
+#include "../../include/simulation/EnvironmentPass.h"
+#include <algorithm>
+#include <cstddef>
+#include <string>
+
+static_assert(sizeof(int) == sizeof(int32_t), "environment ids are exported as int32");
+
+/*--- Handle: engine plus bookkeeping for view invalidation ---*/
+struct solarsys_system {
+    SolarSystem engine;
+    uint64_t generation = 0;
+    const BodyState* lastBase = nullptr;
+    size_t lastCount = 0;
+    bool statesInitialized = false;
+
+    EnvironmentPass environment;
+    bool environmentEnabled = false;
+    std::vector<EnvironmentEvent> environmentEvents;
+};
+
+namespace {
+
+    thread_local std::string lastError;
+
+    int fail(int status, const std::string& message) {
+        lastError = message;
+        return status;
+    }
+
+    // Keplerian runs keep no state array of their own; build it on first use
+    void ensureStates(solarsys_system* s) {
+        if (!s->statesInitialized) {
+            if (s->engine.getBodyStates().empty()) s->engine.initializeBodyStates(!s->engine.isUsingKeplerianOrbits());
+            s->statesInitialized = true;
+        }
+        if (s->engine.isUsingKeplerianOrbits()) s->engine.syncBodyStatesFromOrbits();
+    }
+
+    // Leaving Keplerian mode: rebuild from the orbits around the centre of
+    // mass with accelerations filled in, so the first N-body step neither
+    // drifts the whole system nor coasts without force
+    void seedNBody(solarsys_system* s) {
+        SolarSystem& engine = s->engine;
+        const Star* star = engine.getStar();
+        // Bodies from solarsys_add_body have no orbit to rebuild from
+        std::vector<BodyState> added;
+        for (const BodyState& state : engine.getBodyStates()) {
+            if (!engine.getOrbits().count(state.id) && !(star && state.id == star->getId())) added.push_back(state);
+        }
+        engine.initializeBodyStates(true);
+        s->statesInitialized = true;
+        if (added.empty()) return;
+
+        // They were given in the star-centred frame: move them with the star,
+        // then put the centre of mass back at rest
+        std::vector<BodyState>& states = engine.getBodyStates();
+        Vec3 starPosition, starVelocity;
+        if (star && !states.empty()) {
+            starPosition = states.front().position;
+            starVelocity = states.front().velocity;
+        }
+        for (BodyState& state : added) {
+            state.position += starPosition;
+            state.velocity += starVelocity;
+            states.push_back(state);
+        }
+        Vec3 com = IntegratorUtils::computeCenterOfMass(states);
+        Vec3 comVelocity = IntegratorUtils::computeCenterOfMassVelocity(states);
+        for (BodyState& state : states) {
+            state.position -= com;
+            state.velocity -= comVelocity;
+        }
+        for (BodyState& state : states) state.acceleration = Integrator::nBodyAcceleration(state, states);
+    }
+
+    void trackGeneration(solarsys_system* s) {
+        const auto& states = s->engine.getBodyStates();
+        if (states.data() != s->lastBase || states.size() != s->lastCount) {
+            ++s->generation;
+            s->lastBase = states.data();
+            s->lastCount = states.size();
+        }
+    }
+}
+
+extern "C" {
+
+int solarsys_abi_version(void) { return SOLARSYS_C_ABI_VERSION; }
+
+solarsys_system* solarsys_create(void) {
+    try {
+        return new solarsys_system();
+    } catch (...) {
+        lastError = "allocation failed";
+        return nullptr;
+    }
+}
+
+void solarsys_destroy(solarsys_system* system) { delete system; }
+
+const char* solarsys_last_error(void) { return lastError.c_str(); }
+
+int solarsys_load_planets_json(solarsys_system* system, const char* path) {
+    if (!system || !path) return fail(SOLARSYS_ERR_INVALID_ARGUMENT, "null argument");
+
+    JsonValue document;
+    std::string error;
+    if (!JsonValue::parseFile(path, document, &error)) {
+        bool io = error.rfind("cannot open", 0) == 0;
+        return fail(io ? SOLARSYS_ERR_IO : SOLARSYS_ERR_PARSE, error);
+    }
+    if (!ScenarioLoader::loadPlanets(system->engine, document, &error)) {
+        return fail(SOLARSYS_ERR_PARSE, error);
+    }
+
+    system->engine.initializeBodyStates();
+    system->statesInitialized = true;
+    trackGeneration(system);
+    return SOLARSYS_OK;
+}
+
+int solarsys_add_body(solarsys_system* system, int32_t id, double mass,
+                      const double position[3], const double velocity[3]) {
+    if (!system || !position || !velocity) return fail(SOLARSYS_ERR_INVALID_ARGUMENT, "null argument");
+
+    BodyState state;
+    state.id = id;
+    state.mass = mass;
+    state.position = Vec3(position[0], position[1], position[2]);
+    state.velocity = Vec3(velocity[0], velocity[1], velocity[2]);
+    // Seed the accelerations velocity Verlet reads on its next step: the new
+    // body's own and its pull on everyone else
+    std::vector<BodyState>& states = system->engine.getBodyStates();
+    state.acceleration = Integrator::nBodyAcceleration(state, states);
+    for (BodyState& other : states) {
+        if (other.id != id) other.acceleration += Gravity::computeAcceleration(mass, other.position, state.position);
+    }
+    states.push_back(state);
+    system->engine.markStateEdited();
+    system->statesInitialized = true;
+    trackGeneration(system);
+    return SOLARSYS_OK;
+}
+
+int solarsys_set_time_step(solarsys_system* system, double seconds) {
+    if (!system || !(seconds > 0.0)) return fail(SOLARSYS_ERR_INVALID_ARGUMENT, "time step must be positive");
+    system->engine.getTimeSystem().setTimeStep(seconds);
+    return SOLARSYS_OK;
+}
+
+int solarsys_set_integration_method(solarsys_system* system, int method) {
+    if (!system || method < SOLARSYS_EULER || method > SOLARSYS_RK4) {
+        return fail(SOLARSYS_ERR_INVALID_ARGUMENT, "unknown integration method");
+    }
+    system->engine.setIntegrationMethod(static_cast<IntegrationMethod>(method));
+    return SOLARSYS_OK;
+}
+
+int solarsys_set_keplerian(solarsys_system* system, int enabled) {
+    if (!system) return fail(SOLARSYS_ERR_INVALID_ARGUMENT, "null system");
+    if (!enabled && system->engine.isUsingKeplerianOrbits()) seedNBody(system);
+    system->engine.setUseKeplerianOrbits(enabled != 0);
+    trackGeneration(system);
+    return SOLARSYS_OK;
+}
+
+int solarsys_step_n(solarsys_system* system, uint64_t steps) {
+    if (!system) return fail(SOLARSYS_ERR_INVALID_ARGUMENT, "null system");
+    try {
+        for (uint64_t k = 0; k < steps; ++k) {
+            system->engine.step();
+            if (system->environmentEnabled) system->environment.update(system->engine);
+        }
+        // One state refresh per batch, not per tick
+        if (system->engine.isUsingKeplerianOrbits()) ensureStates(system);
+    } catch (const std::exception& e) {
+        return fail(SOLARSYS_ERR_STATE, e.what());
+    }
+    trackGeneration(system);
+    return SOLARSYS_OK;
+}
+
+double solarsys_get_time(const solarsys_system* system) {
+    return system ? system->engine.getTimeSystem().getCurrentTime() : 0.0;
+}
+
+uint64_t solarsys_get_tick(const solarsys_system* system) {
+    return system ? system->engine.getTimeSystem().getTickCount() : 0;
+}
+
+size_t solarsys_body_count(const solarsys_system* system) {
+    return system ? system->engine.getBodyStates().size() : 0;
+}
+
+int solarsys_get_state_view(solarsys_system* system, solarsys_state_view* out) {
+    if (!system || !out) return fail(SOLARSYS_ERR_INVALID_ARGUMENT, "null argument");
+    ensureStates(system);
+    trackGeneration(system);
+
+    const auto& states = system->engine.getBodyStates();
+    out->base = states.data();
+    out->count = states.size();
+    out->stride = sizeof(BodyState);
+    out->id_offset = offsetof(BodyState, id);
+    out->mass_offset = offsetof(BodyState, mass);
+    out->position_offset = offsetof(BodyState, position);
+    out->velocity_offset = offsetof(BodyState, velocity);
+    out->acceleration_offset = offsetof(BodyState, acceleration);
+    out->generation = system->generation;
+    return SOLARSYS_OK;
+}
+
+double solarsys_total_energy(const solarsys_system* system) {
+    if (!system) return 0.0;
+    return IntegratorUtils::computeTotalEnergy(system->engine.getBodyStates());
+}
+
+int solarsys_configure_environment(solarsys_system* system, uint32_t interval, double hysteresis) {
+    if (!system || hysteresis < 0.0) return fail(SOLARSYS_ERR_INVALID_ARGUMENT, "invalid environment settings");
+
+    system->environmentEnabled = interval > 0;
+    if (!system->environmentEnabled) return SOLARSYS_OK;
+
+    ensureStates(system);
+    trackGeneration(system);
+    system->environment.setInterval(interval);
+    system->environment.setHysteresis(hysteresis);
+    system->environment.setListener([system](const EnvironmentEvent& e) {
+        system->environmentEvents.push_back(e);
+    });
+    system->environment.rebuild(system->engine);
+    system->environment.update(system->engine);
+    return SOLARSYS_OK;
+}
+
+int solarsys_get_environment_view(solarsys_system* system, solarsys_environment_view* out) {
+    if (!system || !out) return fail(SOLARSYS_ERR_INVALID_ARGUMENT, "null argument");
+    if (!system->environmentEnabled) return fail(SOLARSYS_ERR_STATE, "environment pass not configured");
+
+    const EnvironmentPass& env = system->environment;
+    out->count = env.getBodyCount();
+    out->ids = reinterpret_cast<const int32_t*>(env.getIds().data());
+    out->distance = env.getDistances().data();
+    out->irradiance = env.getIrradiance().data();
+    out->coma_radius = env.getComaRadii().data();
+    out->active_tail = env.getActiveTails().data();
+    out->pending_events = system->environmentEvents.size();
+    return SOLARSYS_OK;
+}
+
+int solarsys_take_environment_events(solarsys_system* system, solarsys_environment_event* out,
+                                     size_t capacity, size_t* written) {
+    if (!system || (!out && capacity > 0)) return fail(SOLARSYS_ERR_INVALID_ARGUMENT, "null argument");
+
+    auto& events = system->environmentEvents;
+    size_t n = std::min(capacity, events.size());
+    for (size_t k = 0; k < n; ++k) {
+        out[k].body_id = events[k].bodyId;
+        out[k].activated = events[k].type == EnvironmentEvent::Type::TAIL_ACTIVATED ? 1 : 0;
+        out[k].time = events[k].time;
+        out[k].distance = events[k].distance;
+    }
+    events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(n));
+    if (written) *written = n;
+    return SOLARSYS_OK;
+}
+
+}
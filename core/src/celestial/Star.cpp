@@ -1,28 +1,145 @@
 #include "../../include/celestial/Star.h"
 #include "../../include/physics/Gravity.h"
+#include <algorithm>
 #include <cmath>
-#include <random>
-
-void Star::simulateFlareEvent() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_real_distribution<> dis(0.0, 1.0);
-
-    // Check if flare occurs based on probability
-    if (dis(gen) < flareProbability * activityLevel) {
-        // Flare occurred - temporarily increase activity
-        activityLevel = std::min(1.0, activityLevel + flareIntensity);
-        
-        // Flare intensity affects radiation reach temporarily
-        radiationReach *= (1.0 + flareIntensity * 0.5);
+
+namespace {
+
+    // Fraction of a flare's excess left after elapsed seconds
+    double flareDecay(double elapsed, double decayTime) {
+        return decayTime > 0.0 ? std::exp(-elapsed / decayTime) : 0.0;
+    }
+
+    // Time after a flare at which the integrated flare rate
+    //   L(t) = rate * (quiet * t + excess * tau * (1 - exp(-t / tau)))
+    // reaches target (an Exp(1) draw). L is increasing and concave, so Newton
+    // started below the root climbs to it without overshooting.
+    double flareWait(double target, double rate, double quiet, double excess, double tau) {
+        if (rate <= 0.0) return std::numeric_limits<double>::infinity();
+        if (tau <= 0.0) excess = 0.0;
+        if (quiet <= 0.0) {
+            // Only the decaying excess drives flares: finite total, closed form
+            double total = rate * excess * tau;
+            if (target >= total) return std::numeric_limits<double>::infinity();
+            return -tau * std::log1p(-target / total);
+        }
+        if (excess <= 0.0) return target / (rate * quiet);
+
+        double t = target / (rate * (quiet + excess));
+        for (int iteration = 0; iteration < 64; ++iteration) {
+            double decay = std::exp(-t / tau);
+            double f = rate * (quiet * t + excess * tau * (1.0 - decay)) - target;
+            double step = -f / (rate * (quiet + excess * decay));
+            t += step;
+            if (step <= 1e-12 * t) break;
+        }
+        return t;
     }
 }
 
+/*--- Activity ---*/
+
+double Star::getActivityLevel() const {
+    return quiescentActivity + flareExcess * flareDecay(activityTime - anchorTime, flareDecayTime);
+}
+
+double Star::getRadiationReach() const {
+    return radiationReach * (1.0 + reachBoost * flareDecay(activityTime - anchorTime, flareDecayTime));
+}
+
+void Star::updateActivityLevel(double newLevel) {
+    quiescentActivity = std::clamp(newLevel, 0.0, 1.0);
+    flareExcess = 0.0;
+    reachBoost = 0.0;
+    startActivity(activityTime);
+}
+
+void Star::setFlareModel(double rate, double intensity, double decayTime) {
+    flareRate = std::max(0.0, rate);
+    flareIntensity = std::max(0.0, intensity);
+    flareDecayTime = std::max(0.0, decayTime);
+    startActivity(activityTime);
+}
+
+void Star::startActivity(double time) {
+    // Carry the decayed state over to the new anchor
+    double decay = flareDecay(time - anchorTime, flareDecayTime);
+    flareExcess *= decay;
+    reachBoost *= decay;
+    anchorTime = activityTime = scheduleStart = time;
+    startExcess = flareExcess;
+    startBoost = reachBoost;
+    flareCount = 0;
+    ++scheduleGeneration;
+    activityRng.seekBlock(0);
+    scheduleNextFlare();
+}
+
+void Star::scheduleNextFlare() {
+    double target = -std::log(1.0 - activityRng.uniform());
+    nextFlareTime = anchorTime + flareWait(target, flareRate, quiescentActivity, flareExcess, flareDecayTime);
+}
+
+size_t Star::processFlares(double time) {
+    if (time < activityTime) {
+        // Replay from the schedule start: the same draws give the same flares
+        anchorTime = scheduleStart;
+        flareExcess = startExcess;
+        reachBoost = startBoost;
+        flareCount = 0;
+        activityRng.seekBlock(0);
+        scheduleNextFlare();
+        time = std::max(time, scheduleStart);
+    }
+
+    size_t flares = 0;
+    while (nextFlareTime <= time) {
+        // Flare occurred - temporarily increase activity and radiation reach
+        double decay = flareDecay(nextFlareTime - anchorTime, flareDecayTime);
+        double level = std::min(1.0, quiescentActivity + flareExcess * decay + flareIntensity);
+        flareExcess = level - quiescentActivity;
+        reachBoost = (1.0 + reachBoost * decay) * (1.0 + flareIntensity * 0.5) - 1.0;
+        anchorTime = nextFlareTime;
+        ++flareCount;
+        ++flares;
+        scheduleNextFlare();
+    }
+    activityTime = time;
+    return flares;
+}
+
+/*--- Schedule snapshots ---*/
+
+FlareScheduleState Star::saveFlareSchedule() const {
+    FlareScheduleState state;
+    state.generation = scheduleGeneration;
+    state.anchorTime = anchorTime;
+    state.flareExcess = flareExcess;
+    state.reachBoost = reachBoost;
+    state.activityTime = activityTime;
+    state.nextFlareTime = nextFlareTime;
+    state.flareCount = flareCount;
+    state.rng = activityRng;
+    return state;
+}
+
+bool Star::restoreFlareSchedule(const FlareScheduleState& state) {
+    if (state.generation != scheduleGeneration) return false;
+    anchorTime = state.anchorTime;
+    flareExcess = state.flareExcess;
+    reachBoost = state.reachBoost;
+    activityTime = state.activityTime;
+    nextFlareTime = state.nextFlareTime;
+    flareCount = state.flareCount;
+    activityRng = state.rng;
+    return true;
+}
+
 double Star::irradianceAtDistance(double distance) const {
     if (distance < 1e-10) return 0.0;
     
     double irradiance = luminosity / (4.0 * M_PI * distance * distance);
-    irradiance *= (1.0 + 0.001 * activityLevel);
+    irradiance *= (1.0 + 0.001 * getActivityLevel());
     
     return irradiance;
-}
\ No newline at end of file
+}
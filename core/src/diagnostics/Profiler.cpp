@@ -0,0 +1,218 @@
+#include "../../include/diagnostics/Profiler.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <new>
+
+std::atomic<uint32_t> Profiler::samplingInterval{16};
+std::atomic<bool> Profiler::traceEnabled{false};
+
+namespace {
+
+    // Profiles outlive their threads so results can be queried after a pool
+    // exits; a retired profile keeps its totals and goes to the next new thread
+    std::mutex& registryMutex() {
+        static std::mutex m;
+        return m;
+    }
+
+    std::vector<std::unique_ptr<ThreadProfile>>& registry() {
+        static std::vector<std::unique_ptr<ThreadProfile>> profiles;
+        return profiles;
+    }
+
+    // Non-registering view for the allocation hook (must not allocate itself)
+    thread_local ThreadProfile* allocationProfile = nullptr;
+
+    uint64_t traceEpoch() {
+        static const uint64_t epoch = Profiler::nowNanos();
+        return epoch;
+    }
+}
+
+namespace {
+    // Retires the thread's profile when the thread exits
+    struct ThreadExitHook {
+        bool armed = false;
+        ~ThreadExitHook() {
+            if (armed) Profiler::retireThread();
+        }
+    };
+}
+
+ThreadProfile* Profiler::registerThread() {
+    ThreadProfile* raw = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        for (auto& profile : registry()) {
+            if (!profile->retired) continue;
+            // The mutex orders the old owner's last writes before ours
+            raw = profile.get();
+            raw->retired = false;
+            raw->depth = 0;
+            raw->sampling = false;
+            raw->framesUntilSample = 1;
+            break;
+        }
+        if (!raw) {
+            auto profile = std::make_unique<ThreadProfile>();
+            raw = profile.get();
+            raw->threadIndex = static_cast<uint32_t>(registry().size());
+            registry().push_back(std::move(profile));
+        }
+    }
+    traceEpoch();
+    allocationProfile = raw;
+    static thread_local ThreadExitHook exitHook;
+    exitHook.armed = true;
+    return raw;
+}
+
+void Profiler::retireThread() {
+    ThreadProfile* profile = currentProfile;
+    if (!profile) return;
+    currentProfile = nullptr;
+    allocationProfile = nullptr;
+    std::lock_guard<std::mutex> lock(registryMutex());
+    profile->retired = true;
+}
+
+void Profiler::recordTrace(ThreadProfile& profile, ProfilePhase phase, uint64_t start, uint64_t end) {
+    std::lock_guard<std::mutex> lock(profile.traceMutex);
+    profile.trace.push_back(ThreadProfile::TraceEvent{phase, start, end - start});
+}
+
+ProfileReport Profiler::snapshot() {
+    ProfileReport report;
+    std::lock_guard<std::mutex> lock(registryMutex());
+
+    for (const auto& profile : registry()) {
+        ProfileReport::ThreadStats t;
+        t.threadIndex = profile->threadIndex;
+        for (size_t c = 0; c < PROFILE_COUNTER_COUNT; ++c) {
+            t.counters[c] = profile->counters[c].load(std::memory_order_relaxed);
+            report.total.counters[c] += t.counters[c];
+        }
+        for (size_t p = 0; p < PROFILE_PHASE_COUNT; ++p) {
+            t.phases[p].calls = profile->phaseCalls[p].load(std::memory_order_relaxed);
+            t.phases[p].sampledCalls = profile->phaseSampledCalls[p].load(std::memory_order_relaxed);
+            t.phases[p].sampledNanos = profile->phaseSampledNanos[p].load(std::memory_order_relaxed);
+            report.total.phases[p].calls += t.phases[p].calls;
+            report.total.phases[p].sampledCalls += t.phases[p].sampledCalls;
+            report.total.phases[p].sampledNanos += t.phases[p].sampledNanos;
+        }
+        report.threads.push_back(t);
+    }
+    return report;
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (auto& profile : registry()) {
+        for (auto& c : profile->counters) c.store(0, std::memory_order_relaxed);
+        for (size_t p = 0; p < PROFILE_PHASE_COUNT; ++p) {
+            profile->phaseCalls[p].store(0, std::memory_order_relaxed);
+            profile->phaseSampledCalls[p].store(0, std::memory_order_relaxed);
+            profile->phaseSampledNanos[p].store(0, std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> traceLock(profile->traceMutex);
+        profile->trace.clear();
+    }
+}
+
+void Profiler::printReport(std::ostream& os) {
+    ProfileReport report = snapshot();
+
+    os << "--- Profile (" << report.threads.size() << " threads, timing sampled 1/"
+       << getSamplingInterval() << ") ---\n";
+    for (size_t p = 0; p < PROFILE_PHASE_COUNT; ++p) {
+        const auto& s = report.total.phases[p];
+        if (s.calls == 0) continue;
+        os << std::left << std::setw(20) << phaseName(static_cast<ProfilePhase>(p))
+           << " calls " << std::setw(12) << s.calls
+           << " mean " << std::setw(10) << std::fixed << std::setprecision(1) << s.meanNanos() << " ns"
+           << "  total~ " << std::setprecision(3) << s.estimatedTotalNanos() * 1e-9 << " s\n";
+    }
+    for (size_t c = 0; c < PROFILE_COUNTER_COUNT; ++c) {
+        if (report.total.counters[c] == 0) continue;
+        os << std::left << std::setw(20) << counterName(static_cast<ProfileCounter>(c))
+           << " " << report.total.counters[c] << "\n";
+    }
+    os.unsetf(std::ios::floatfield);
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    // Chrome trace-event format: load in chrome://tracing or ui.perfetto.dev
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    uint64_t epoch = traceEpoch();
+
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (const auto& profile : registry()) {
+        std::lock_guard<std::mutex> traceLock(profile->traceMutex);
+        for (const auto& ev : profile->trace) {
+            if (!first) out << ",";
+            first = false;
+            char buffer[192];
+            std::snprintf(buffer, sizeof(buffer),
+                          "\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                          phaseName(ev.phase), profile->threadIndex,
+                          (ev.startNanos - epoch) * 1e-3, ev.durationNanos * 1e-3);
+            out << buffer;
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    return static_cast<bool>(out);
+}
+
+const char* Profiler::phaseName(ProfilePhase p) {
+    switch (p) {
+        case ProfilePhase::STEP: return "step";
+        case ProfilePhase::KEPLER_PROPAGATION: return "kepler_propagation";
+        case ProfilePhase::NBODY_INTEGRATION: return "nbody_integration";
+        case ProfilePhase::FORCE_EVALUATION: return "force_evaluation";
+        case ProfilePhase::ENSEMBLE_STEP: return "ensemble_step";
+        case ProfilePhase::ENVIRONMENT: return "environment";
+        case ProfilePhase::DIAGNOSTICS: return "diagnostics";
+        case ProfilePhase::OUTPUT: return "output";
+        case ProfilePhase::COUNT: break;
+    }
+    return "unknown";
+}
+
+const char* Profiler::counterName(ProfileCounter c) {
+    switch (c) {
+        case ProfileCounter::FORCE_EVALUATIONS: return "force_evaluations";
+        case ProfileCounter::PAIR_INTERACTIONS: return "pair_interactions";
+        case ProfileCounter::KEPLER_SOLVES: return "kepler_solves";
+        case ProfileCounter::KEPLER_ITERATIONS: return "kepler_iterations";
+        case ProfileCounter::ALLOCATIONS: return "allocations";
+        case ProfileCounter::ALLOCATED_BYTES: return "allocated_bytes";
+        case ProfileCounter::COUNT: break;
+    }
+    return "unknown";
+}
+
+#ifdef SOLARSYS_ENABLE_PROFILING
+
+/*--- Allocation hook (profiling builds only) ---*/
+// Counts operator new on threads that have touched the profiler. Replacing the
+// global operator is program-wide, which is why it is tied to the opt-in flag.
+void* operator new(std::size_t size) {
+    if (ThreadProfile* profile = allocationProfile) {
+        ThreadProfile::bump(profile->counters[static_cast<size_t>(ProfileCounter::ALLOCATIONS)], 1);
+        ThreadProfile::bump(profile->counters[static_cast<size_t>(ProfileCounter::ALLOCATED_BYTES)], size);
+    }
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+#endif
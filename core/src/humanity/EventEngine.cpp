@@ -0,0 +1,481 @@
+#include "../../include/humanity/EventEngine.h"
+#include "../../include/random/CounterRng.h"
+#include "../../include/time/TimeSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace {
+
+    constexpr double INF = std::numeric_limits<double>::infinity();
+
+    // Draw `draw` of a colony: one Philox block per draw, 53 bits of it
+    double philoxUniform(const uint32_t key[2], uint64_t colony, uint64_t draw) {
+        uint32_t ctr[4] = {
+            static_cast<uint32_t>(draw), static_cast<uint32_t>(draw >> 32),
+            static_cast<uint32_t>(colony), static_cast<uint32_t>(colony >> 32)
+        };
+        uint32_t out[4];
+        CounterRng::philox(ctr, key, out);
+        uint64_t bits = (static_cast<uint64_t>(out[1]) << 32) | out[0];
+        return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    void setKey(uint32_t key[2], uint64_t seed) {
+        uint64_t mixed = CounterRng::mixSeed(seed, RandomDomain::HUMANITY_EVENTS);
+        key[0] = static_cast<uint32_t>(mixed);
+        key[1] = static_cast<uint32_t>(mixed >> 32);
+    }
+
+    using IdIndex = std::unordered_map<std::string, uint32_t>;
+
+    bool indexIds(const JsonValue& list, const char* what, IdIndex& index, std::string* error) {
+        if (!list.isArray()) {
+            if (error) *error = std::string(what) + " data must be a JSON array";
+            return false;
+        }
+        for (size_t k = 0; k < list.size(); ++k) {
+            const JsonValue& entry = list[k];
+            const JsonValue* id = entry.isObject() ? entry.find("id") : nullptr;
+            if (!id || !id->isString() || id->asString().empty()) {
+                if (error) *error = std::string(what) + " entry " + std::to_string(k) + " needs a string id";
+                return false;
+            }
+            if (!index.emplace(id->asString(), static_cast<uint32_t>(k)).second) {
+                if (error) *error = std::string(what) + " id '" + id->asString() + "' is defined twice";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Sets the bits of every listed tech id; an absent key means none
+    bool readTechSet(const JsonValue& entry, const char* key, const IdIndex& techIndex,
+                     const std::string& owner, uint64_t* words, std::string* error) {
+        const JsonValue* list = entry.find(key);
+        if (!list) return true;
+        if (!list->isArray()) {
+            if (error) *error = owner + ": '" + key + "' must be an array of technology ids";
+            return false;
+        }
+        for (const JsonValue& id : list->getArray()) {
+            auto it = id.isString() ? techIndex.find(id.asString()) : techIndex.end();
+            if (it == techIndex.end()) {
+                if (error) *error = owner + " names unknown technology '" + (id.isString() ? id.asString() : "?") + "'";
+                return false;
+            }
+            words[it->second / 64] |= uint64_t(1) << (it->second % 64);
+        }
+        return true;
+    }
+
+    struct ColonySpec {
+        ColonyInfo info;
+        double population;
+        double stability;
+        size_t techBegin;
+    };
+}
+
+/*--- Constructors ---*/
+
+EventEngine::EventEngine(uint64_t seed) : techWords(0), time(0.0) {
+    setKey(key, seed);
+}
+
+/*--- Definitions ---*/
+
+bool EventEngine::compile(const JsonValue& technologies, const JsonValue& eventList, std::string* error) {
+    IdIndex techIndex, eventIndex;
+    if (!indexIds(technologies, "technology", techIndex, error)) return false;
+    if (!indexIds(eventList, "event", eventIndex, error)) return false;
+
+    const size_t T = technologies.size();
+    const size_t E = eventList.size();
+    const size_t W = std::max<size_t>(1, (T + 63) / 64);
+
+    std::vector<TechDefinition> newTechs(T);
+    std::vector<uint64_t> newTechRequires(T * W, 0);
+    std::vector<double> newTechMultiplier(T * E, 1.0);
+    for (size_t t = 0; t < T; ++t) {
+        const JsonValue& entry = technologies[t];
+        TechDefinition& def = newTechs[t];
+        def.id = entry.getString("id");
+        def.name = entry.getString("name", def.id);
+        def.cost = entry.getNumber("cost");
+        const std::string owner = "technology '" + def.id + "'";
+        if (!(def.cost >= 0.0)) {
+            if (error) *error = owner + " has a negative cost";
+            return false;
+        }
+        if (!readTechSet(entry, "requires", techIndex, owner, &newTechRequires[t * W], error)) return false;
+
+        if (const JsonValue* effects = entry.find("effects")) {
+            if (!effects->isObject()) {
+                if (error) *error = owner + ": 'effects' must map event ids to rate multipliers";
+                return false;
+            }
+            for (const auto& [eventId, factor] : effects->getObject()) {
+                auto it = eventIndex.find(eventId);
+                if (it == eventIndex.end() || !factor.isNumber() || factor.asNumber() < 0.0) {
+                    if (error) *error = owner + " has a bad multiplier for event '" + eventId + "'";
+                    return false;
+                }
+                newTechMultiplier[t * E + it->second] *= factor.asNumber();
+            }
+        }
+    }
+
+    std::vector<EventDefinition> newEvents(E);
+    std::vector<uint64_t> newEventRequires(E * W, 0);
+    for (size_t e = 0; e < E; ++e) {
+        const JsonValue& entry = eventList[e];
+        EventDefinition& def = newEvents[e];
+        def.id = entry.getString("id");
+        def.name = entry.getString("name", def.id);
+        def.ratePerYear = entry.getNumber("rate");
+        def.minPopulation = entry.getNumber("minPopulation");
+        def.minStability = entry.getNumber("minStability", 0.0);
+        def.maxStability = entry.getNumber("maxStability", 1.0);
+        def.repeatable = entry.getBool("repeatable", true);
+        const std::string owner = "event '" + def.id + "'";
+        if (!(def.ratePerYear >= 0.0)) {
+            if (error) *error = owner + " has a negative rate";
+            return false;
+        }
+        if (!readTechSet(entry, "requires", techIndex, owner, &newEventRequires[e * W], error)) return false;
+
+        if (const JsonValue* effects = entry.find("effects")) {
+            def.effect.population = effects->getNumber("population");
+            def.effect.stability = effects->getNumber("stability");
+            def.effect.research = effects->getNumber("research");
+            def.effect.collapse = effects->getBool("collapse");
+        }
+    }
+
+    techs = std::move(newTechs);
+    events = std::move(newEvents);
+    techWords = W;
+    techRequires = std::move(newTechRequires);
+    techMultiplier = std::move(newTechMultiplier);
+    eventRequires = std::move(newEventRequires);
+
+    eventRate.resize(E);
+    eventMinPopulation.resize(E);
+    eventMinStability.resize(E);
+    eventMaxStability.resize(E);
+    eventOnce.resize(E);
+    for (size_t e = 0; e < E; ++e) {
+        eventRate[e] = events[e].ratePerYear / TimeConstants::YEAR;
+        eventMinPopulation[e] = events[e].minPopulation;
+        eventMinStability[e] = events[e].minStability;
+        eventMaxStability[e] = events[e].maxStability;
+        eventOnce[e] = events[e].repeatable ? 0 : 1;
+    }
+    eventCounts.assign(E, 0);
+
+    clearColonies();
+    return true;
+}
+
+bool EventEngine::loadDefinitions(const std::string& technologiesPath, const std::string& eventsPath,
+                                  std::string* error) {
+    JsonValue technologies, eventList;
+    if (!JsonValue::parseFile(technologiesPath, technologies, error)) return false;
+    if (!JsonValue::parseFile(eventsPath, eventList, error)) return false;
+    return compile(technologies, eventList, error);
+}
+
+int EventEngine::findTech(const std::string& id) const {
+    for (size_t t = 0; t < techs.size(); ++t) {
+        if (techs[t].id == id) return static_cast<int>(t);
+    }
+    return -1;
+}
+
+int EventEngine::findEvent(const std::string& id) const {
+    for (size_t e = 0; e < events.size(); ++e) {
+        if (events[e].id == id) return static_cast<int>(e);
+    }
+    return -1;
+}
+
+/*--- Colonies ---*/
+
+void EventEngine::clearColonies() {
+    civilizationNames.clear();
+    civilizationResearchRate.clear();
+    colonies.clear();
+    population.clear();
+    stability.clear();
+    research.clear();
+    researchUpdated.clear();
+    researchTarget.clear();
+    alive.clear();
+    known.clear();
+    fired.clear();
+    multiplier.clear();
+    rates.clear();
+    totalRate.clear();
+    nextEvent.clear();
+    nextUnlock.clear();
+    draws.clear();
+    generation.clear();
+    queue = decltype(queue)();
+    history.clear();
+}
+
+bool EventEngine::loadCivilizations(const std::string& path, size_t replicas, std::string* error) {
+    JsonValue document;
+    if (!JsonValue::parseFile(path, document, error)) return false;
+    return loadCivilizations(document, replicas, error);
+}
+
+bool EventEngine::loadCivilizations(const JsonValue& civilizations, size_t replicas, std::string* error) {
+    if (!civilizations.isArray()) {
+        if (error) *error = "civilization data must be a JSON array";
+        return false;
+    }
+
+    // Validate everything before touching the engine
+    IdIndex techIndex;
+    for (size_t t = 0; t < techs.size(); ++t) techIndex.emplace(techs[t].id, static_cast<uint32_t>(t));
+
+    const uint32_t civBase = static_cast<uint32_t>(civilizationNames.size());
+    std::vector<std::string> names;
+    std::vector<double> researchRates;
+    std::vector<ColonySpec> specs;
+    std::vector<uint64_t> civTechs;
+    for (size_t k = 0; k < civilizations.size(); ++k) {
+        const JsonValue& civ = civilizations[k];
+        const JsonValue* list = civ.isObject() ? civ.find("colonies") : nullptr;
+        if (!list || !list->isArray()) {
+            if (error) *error = "civilization entry " + std::to_string(k) + " needs a colonies array";
+            return false;
+        }
+        std::string name = civ.getString("name", "Civilization " + std::to_string(civBase + k));
+        size_t techBegin = civTechs.size();
+        civTechs.resize(techBegin + techWords, 0);
+        if (!readTechSet(civ, "technologies", techIndex, "civilization '" + name + "'",
+                         civTechs.data() + techBegin, error)) return false;
+
+        for (size_t j = 0; j < list->size(); ++j) {
+            const JsonValue& entry = (*list)[j];
+            if (!entry.isObject()) {
+                if (error) *error = "civilization '" + name + "' colony " + std::to_string(j) + " must be an object";
+                return false;
+            }
+            ColonySpec spec;
+            spec.info.name = entry.getString("name", name + " " + std::to_string(j));
+            spec.info.bodyId = static_cast<int>(entry.getNumber("body", -1.0));
+            spec.info.civilization = civBase + static_cast<uint32_t>(k);
+            spec.population = std::max(0.0, entry.getNumber("population"));
+            spec.stability = std::clamp(entry.getNumber("stability", 1.0), 0.0, 1.0);
+            spec.techBegin = techBegin;
+            specs.push_back(spec);
+        }
+        names.push_back(name);
+        researchRates.push_back(std::max(0.0, civ.getNumber("researchRate")) / TimeConstants::YEAR);
+    }
+
+    civilizationNames.insert(civilizationNames.end(), names.begin(), names.end());
+    civilizationResearchRate.insert(civilizationResearchRate.end(), researchRates.begin(), researchRates.end());
+
+    const size_t E = events.size();
+    const size_t W = techWords;
+    const size_t begin = colonies.size();
+    const size_t end = begin + specs.size() * replicas;
+    colonies.reserve(end);
+    population.resize(end);
+    stability.resize(end);
+    research.resize(end, 0.0);
+    researchUpdated.resize(end, time);
+    researchTarget.resize(end, -1);
+    alive.resize(end, 1);
+    known.resize(end * W, 0);
+    fired.resize(end * E, 0);
+    multiplier.resize(end * E, 1.0);
+    rates.resize(end * E, 0.0);
+    totalRate.resize(end, 0.0);
+    nextEvent.resize(end, INF);
+    nextUnlock.resize(end, INF);
+    draws.resize(end, 0);
+    generation.resize(end, 0);
+
+    size_t c = begin;
+    for (size_t r = 0; r < replicas; ++r) {
+        for (const ColonySpec& spec : specs) {
+            colonies.push_back(spec.info);
+            population[c] = spec.population;
+            stability[c] = spec.stability;
+            alive[c] = spec.population > 0.0 ? 1 : 0;
+            std::copy(civTechs.begin() + spec.techBegin, civTechs.begin() + spec.techBegin + W, known.begin() + c * W);
+            for (size_t t = 0; t < techs.size(); ++t) {
+                if (!knowsTech(c, t)) continue;
+                for (size_t e = 0; e < E; ++e) multiplier[c * E + e] *= techMultiplier[t * E + e];
+            }
+            ++c;
+        }
+    }
+
+    scheduleBatch(begin, end, time);
+    return true;
+}
+
+/*--- Scheduling ---*/
+
+void EventEngine::syncResearch(size_t colony, double now) {
+    if (alive[colony]) {
+        research[colony] += civilizationResearchRate[colonies[colony].civilization] * (now - researchUpdated[colony]);
+    }
+    researchUpdated[colony] = now;
+}
+
+void EventEngine::evaluateRates(size_t colony) {
+    const size_t E = events.size();
+    const size_t W = techWords;
+    const uint64_t* have = &known[colony * W];
+    const uint8_t* once = &fired[colony * E];
+    const double* factor = &multiplier[colony * E];
+    double* row = &rates[colony * E];
+    const double pop = population[colony];
+    const double stab = stability[colony];
+    const bool live = alive[colony] != 0;
+
+    double total = 0.0;
+    for (size_t e = 0; e < E; ++e) {
+        bool active = live && pop >= eventMinPopulation[e] && stab >= eventMinStability[e] &&
+                      stab <= eventMaxStability[e] && !(eventOnce[e] && once[e]);
+        const uint64_t* need = &eventRequires[e * W];
+        for (size_t w = 0; w < W; ++w) active = active && (need[w] & ~have[w]) == 0;
+        row[e] = active ? eventRate[e] * factor[e] : 0.0;
+        total += row[e];
+    }
+    totalRate[colony] = total;
+}
+
+void EventEngine::chooseResearchTarget(size_t colony) {
+    const size_t W = techWords;
+    const uint64_t* have = &known[colony * W];
+    researchTarget[colony] = -1;
+    for (size_t t = 0; t < techs.size(); ++t) {
+        if (knowsTech(colony, t)) continue;
+        const uint64_t* need = &techRequires[t * W];
+        bool ready = true;
+        for (size_t w = 0; w < W; ++w) ready = ready && (need[w] & ~have[w]) == 0;
+        if (ready) {
+            researchTarget[colony] = static_cast<int32_t>(t);
+            return;
+        }
+    }
+}
+
+// Next firing from uniform u (memoryless, so resampling from now whenever
+// the rates change is exact), next unlock from the research still needed
+void EventEngine::schedule(size_t colony, double now, double u) {
+    ++generation[colony];
+    nextEvent[colony] = alive[colony] && totalRate[colony] > 0.0 ? now - std::log1p(-u) / totalRate[colony] : INF;
+
+    nextUnlock[colony] = INF;
+    int32_t target = researchTarget[colony];
+    double rate = civilizationResearchRate[colonies[colony].civilization];
+    if (alive[colony] && target >= 0) {
+        double remaining = techs[target].cost - research[colony];
+        if (remaining <= 0.0) nextUnlock[colony] = now;
+        else if (rate > 0.0) nextUnlock[colony] = now + remaining / rate;
+    }
+
+    double due = std::min(nextEvent[colony], nextUnlock[colony]);
+    if (due < INF) queue.push({due, static_cast<uint32_t>(colony), generation[colony]});
+}
+
+void EventEngine::scheduleBatch(size_t begin, size_t end, double now) {
+    // Flat passes over the colony range: trigger rows, then one uniform per
+    // colony (independent Philox blocks), then the queue pushes
+    for (size_t c = begin; c < end; ++c) {
+        syncResearch(c, now);
+        evaluateRates(c);
+        chooseResearchTarget(c);
+    }
+    uniformScratch.resize(end - begin);
+    for (size_t c = begin; c < end; ++c) uniformScratch[c - begin] = philoxUniform(key, c, draws[c]);
+    for (size_t c = begin; c < end; ++c) {
+        ++draws[c];
+        schedule(c, now, uniformScratch[c - begin]);
+    }
+}
+
+double EventEngine::drawUniform(size_t colony) {
+    return philoxUniform(key, colony, draws[colony]++);
+}
+
+void EventEngine::reseed(uint64_t seed) {
+    setKey(key, seed);
+    std::fill(draws.begin(), draws.end(), 0);
+    queue = decltype(queue)();
+    scheduleBatch(0, colonies.size(), time);
+}
+
+/*--- Driving ---*/
+
+void EventEngine::unlock(size_t colony, size_t tech) {
+    const size_t E = events.size();
+    known[colony * techWords + tech / 64] |= uint64_t(1) << (tech % 64);
+    const double* factor = &techMultiplier[tech * E];
+    double* row = &multiplier[colony * E];
+    for (size_t e = 0; e < E; ++e) row[e] *= factor[e];
+}
+
+void EventEngine::process(size_t colony, double now) {
+    syncResearch(colony, now);
+
+    if (nextUnlock[colony] <= nextEvent[colony]) {
+        size_t tech = static_cast<size_t>(researchTarget[colony]);
+        research[colony] = std::max(0.0, research[colony] - techs[tech].cost);
+        unlock(colony, tech);
+        history.push_back({now, static_cast<uint32_t>(colony), HistoryKind::TECHNOLOGY, static_cast<uint32_t>(tech)});
+    } else {
+        // Which event: proportional to its share of the colony's total rate
+        const size_t E = events.size();
+        const double* row = &rates[colony * E];
+        double pick = drawUniform(colony) * totalRate[colony];
+        size_t event = E;
+        for (size_t e = 0; e < E; ++e) {
+            if (row[e] <= 0.0) continue;
+            event = e;
+            pick -= row[e];
+            if (pick < 0.0) break;
+        }
+
+        const EventEffect& effect = events[event].effect;
+        population[colony] *= std::max(0.0, 1.0 + effect.population);
+        stability[colony] = std::clamp(stability[colony] + effect.stability, 0.0, 1.0);
+        research[colony] = std::max(0.0, research[colony] + effect.research);
+        fired[colony * E + event] = 1;
+        ++eventCounts[event];
+        history.push_back({now, static_cast<uint32_t>(colony), HistoryKind::EVENT, static_cast<uint32_t>(event)});
+
+        if (effect.collapse || !(population[colony] > 0.0)) {
+            alive[colony] = 0;
+            history.push_back({now, static_cast<uint32_t>(colony), HistoryKind::COLLAPSE, static_cast<uint32_t>(event)});
+        }
+    }
+
+    evaluateRates(colony);
+    chooseResearchTarget(colony);
+    schedule(colony, now, drawUniform(colony));
+}
+
+size_t EventEngine::advance(double dt) {
+    const double target = time + dt;
+    const size_t before = history.size();
+    while (!queue.empty() && queue.top().time <= target) {
+        Due due = queue.top();
+        queue.pop();
+        if (due.generation != generation[due.colony]) continue;
+        process(due.colony, due.time);
+    }
+    time = target;
+    return history.size() - before;
+}
@@ -0,0 +1,178 @@
+#include "../../include/io/Json.h"
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+    class JsonParser {
+    private:
+        const std::string& text;
+        size_t pos;
+        std::string error;
+
+    public:
+        explicit JsonParser(const std::string& t) : text(t), pos(0) {}
+
+        bool parseDocument(JsonValue& out) {
+            skipWhitespace();
+            if (!parseValue(out, 0)) return false;
+            skipWhitespace();
+            if (pos != text.size()) return fail("trailing characters");
+            return true;
+        }
+
+        const std::string& getError() const { return error; }
+
+    private:
+        static constexpr int MAX_DEPTH = 256;
+
+        bool fail(const std::string& message) {
+            if (error.empty()) error = message + " at offset " + std::to_string(pos);
+            return false;
+        }
+
+        void skipWhitespace() {
+            while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+        }
+
+        bool consume(char c) {
+            skipWhitespace();
+            if (pos < text.size() && text[pos] == c) { ++pos; return true; }
+            return false;
+        }
+
+        bool matchLiteral(const char* literal) {
+            size_t n = std::char_traits<char>::length(literal);
+            if (text.compare(pos, n, literal) == 0) { pos += n; return true; }
+            return false;
+        }
+
+        bool parseValue(JsonValue& out, int depth) {
+            if (depth > MAX_DEPTH) return fail("nesting too deep");
+            skipWhitespace();
+            if (pos >= text.size()) return fail("unexpected end of input");
+
+            char c = text[pos];
+            if (c == '{') return parseObject(out, depth);
+            if (c == '[') return parseArray(out, depth);
+            if (c == '"') {
+                std::string s;
+                if (!parseString(s)) return false;
+                out = JsonValue(s);
+                return true;
+            }
+            if (matchLiteral("true")) { out = JsonValue(true); return true; }
+            if (matchLiteral("false")) { out = JsonValue(false); return true; }
+            if (matchLiteral("null")) { out = JsonValue(); return true; }
+            return parseNumber(out);
+        }
+
+        bool parseNumber(JsonValue& out) {
+            const char* start = text.c_str() + pos;
+            char* end = nullptr;
+            double value = std::strtod(start, &end);
+            if (end == start) return fail("invalid value");
+            pos += static_cast<size_t>(end - start);
+            out = JsonValue(value);
+            return true;
+        }
+
+        static void appendUtf8(std::string& s, unsigned code) {
+            if (code < 0x80) {
+                s += static_cast<char>(code);
+            } else if (code < 0x800) {
+                s += static_cast<char>(0xC0 | (code >> 6));
+                s += static_cast<char>(0x80 | (code & 0x3F));
+            } else {
+                s += static_cast<char>(0xE0 | (code >> 12));
+                s += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                s += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+
+        bool parseString(std::string& out) {
+            ++pos;  // opening quote
+            while (pos < text.size()) {
+                char c = text[pos++];
+                if (c == '"') return true;
+                if (c != '\\') { out += c; continue; }
+
+                if (pos >= text.size()) break;
+                char esc = text[pos++];
+                switch (esc) {
+                    case '"': out += '"'; break;
+                    case '\\': out += '\\'; break;
+                    case '/': out += '/'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    case 'u': {
+                        if (pos + 4 > text.size()) return fail("truncated \\u escape");
+                        unsigned code = static_cast<unsigned>(std::strtoul(text.substr(pos, 4).c_str(), nullptr, 16));
+                        pos += 4;
+                        appendUtf8(out, code);
+                        break;
+                    }
+                    default: return fail("invalid escape");
+                }
+            }
+            return fail("unterminated string");
+        }
+
+        bool parseArray(JsonValue& out, int depth) {
+            ++pos;
+            out = JsonValue::makeArray();
+            if (consume(']')) return true;
+
+            do {
+                JsonValue item;
+                if (!parseValue(item, depth + 1)) return false;
+                out.push(std::move(item));
+            } while (consume(','));
+
+            return consume(']') ? true : fail("expected ',' or ']'");
+        }
+
+        bool parseObject(JsonValue& out, int depth) {
+            ++pos;
+            out = JsonValue::makeObject();
+            if (consume('}')) return true;
+
+            do {
+                skipWhitespace();
+                if (pos >= text.size() || text[pos] != '"') return fail("expected member name");
+                std::string key;
+                if (!parseString(key)) return false;
+                if (!consume(':')) return fail("expected ':'");
+
+                JsonValue value;
+                if (!parseValue(value, depth + 1)) return false;
+                out.set(key, std::move(value));
+            } while (consume(','));
+
+            return consume('}') ? true : fail("expected ',' or '}'");
+        }
+    };
+}
+
+bool JsonValue::parse(const std::string& text, JsonValue& out, std::string* error) {
+    JsonParser parser(text);
+    if (parser.parseDocument(out)) return true;
+    if (error) *error = parser.getError();
+    return false;
+}
+
+bool JsonValue::parseFile(const std::string& path, JsonValue& out, std::string* error) {
+    std::ifstream in(path);
+    if (!in) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return parse(buffer.str(), out, error);
+}
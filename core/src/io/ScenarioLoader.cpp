@@ -0,0 +1,69 @@
+#include "../../include/io/ScenarioLoader.h"
+
+namespace {
+
+    std::unique_ptr<Star> makeDefaultSun() {
+        auto sun = std::make_unique<Star>(
+            0, "Sun", CelestialBody::BodyType::STAR,
+            PhysicsConstants::SOLAR_MASS, 6.96e8
+        );
+        sun->setLuminosity(3.828e26);
+        sun->setSurfaceTemperature(5778);
+        sun->setSpectralType(SpectralType::G);
+        sun->setEvolutionaryStage(EvolutionaryStage::MAIN_SEQUENCE);
+        sun->updateActivityLevel(0.0);
+        return sun;
+    }
+}
+
+bool ScenarioLoader::loadPlanets(SolarSystem& system, const std::string& path, std::string* error) {
+    JsonValue document;
+    if (!JsonValue::parseFile(path, document, error)) return false;
+    return loadPlanets(system, document, error);
+}
+
+bool ScenarioLoader::loadPlanets(SolarSystem& system, const JsonValue& planets, std::string* error) {
+    if (!planets.isArray()) {
+        if (error) *error = "planet data must be a JSON array";
+        return false;
+    }
+
+    if (!system.getStar()) system.setStar(makeDefaultSun());
+    double centralMass = system.getStar()->getMass();
+
+    for (size_t k = 0; k < planets.size(); ++k) {
+        const JsonValue& entry = planets[k];
+        if (!entry.isObject() || !entry.find("semiMajorAxis") || !entry.find("mass")) {
+            if (error) *error = "planet entry " + std::to_string(k) + " needs mass and semiMajorAxis";
+            return false;
+        }
+
+        int id = static_cast<int>(entry.getNumber("id", static_cast<double>(k + 1)));
+        auto planet = std::make_unique<Planet>(
+            id, entry.getString("name", "Planet " + std::to_string(id)), CelestialBody::BodyType::PLANET,
+            entry.getNumber("mass"), entry.getNumber("radius")
+        );
+        planet->setSemiMajorAxis(entry.getNumber("semiMajorAxis"));
+        planet->setEccentricity(entry.getNumber("eccentricity"));
+        planet->setOrbitalPeriod(entry.getNumber("orbitalPeriod"));
+        planet->setInclination(entry.getNumber("inclination"));
+        planet->setAtmosphericPressure(entry.getNumber("atmosphericPressure"));
+        planet->setAverageTemperature(entry.getNumber("averageTemperature"));
+        planet->setHasRings(entry.getBool("hasRings"));
+        planet->setNumberOfMoons(static_cast<int>(entry.getNumber("numberOfMoons")));
+
+        OrbitalElements elements;
+        elements.semiMajorAxis = entry.getNumber("semiMajorAxis");
+        elements.eccentricity = entry.getNumber("eccentricity");
+        elements.inclination = entry.getNumber("inclination");
+        elements.longitudeOfAscNode = entry.getNumber("longitudeOfAscNode");
+        elements.argumentOfPeriapsis = entry.getNumber("argumentOfPeriapsis");
+        elements.trueAnomaly = 0.0;
+        elements.meanAnomaly = entry.getNumber("meanAnomaly");
+        elements.epoch = system.getTimeSystem().getCurrentTime();
+
+        system.addPlanet(std::move(planet));
+        system.setOrbit(id, Orbit(elements, centralMass));
+    }
+    return true;
+}
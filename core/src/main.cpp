@@ -1,8 +1,149 @@
 #include "../include/simulation/SolarSystem.h"
+#include "../include/io/ScenarioLoader.h"
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
+#include <string>
+
+#ifndef SOLARSYS_DATA_DIR
+#define SOLARSYS_DATA_DIR "../data"
+#endif
+
+#ifdef SOLARSYS_HAS_NET
+#include "../include/net/ParticleShards.h"
+#include "../include/net/StateStreamServer.h"
+#include "../include/simulation/PacedRunLoop.h"
+
+namespace {
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void onSignal(int) { stopRequested = 1; }
+
+    void printUsage(const char* program) {
+        std::cerr << "usage: " << program << " [--serve [PORT] [--data FILE] [--rate DAYS_PER_SECOND]]\n"
+                  << "       " << program << " --shard-worker unix:PATH | tcp:HOST:PORT\n"
+                  << "  PORT is 0..65535 (0 picks a free one, default 8765); --rate must be positive" << std::endl;
+    }
+
+    // Whole-string numeric parsing; false on junk, trailing text or overflow
+    bool parsePort(const char* text, uint16_t& port) {
+        char* end = nullptr;
+        errno = 0;
+        long value = std::strtol(text, &end, 10);
+        if (end == text || *end != '\0' || errno == ERANGE || value < 0 || value > 65535) return false;
+        port = static_cast<uint16_t>(value);
+        return true;
+    }
+
+    bool parsePositive(const char* text, double& out) {
+        char* end = nullptr;
+        errno = 0;
+        double value = std::strtod(text, &end);
+        if (end == text || *end != '\0' || errno == ERANGE || !(value > 0.0) || !std::isfinite(value)) return false;
+        out = value;
+        return true;
+    }
+
+    // Streams the planet.json system to the browser until Ctrl+C.
+    // One simulated day per step, paced at daysPerSecond (see visualization/src/stateStream.js)
+    int runServer(uint16_t port, const std::string& dataPath, double daysPerSecond) {
+        SolarSystem solarSystem;
+        std::string error;
+        if (!ScenarioLoader::loadPlanets(solarSystem, dataPath, &error)) {
+            std::cerr << "Cannot load " << dataPath << ": " << error << std::endl;
+            return 1;
+        }
+        solarSystem.getTimeSystem().setTimeStep(TimeConstants::DAY);
+        solarSystem.setUseKeplerianOrbits(true);
+        solarSystem.initializeBodyStates();
+
+        StateStreamServer server;
+        if (!server.start(port, "127.0.0.1", &error)) {
+            std::cerr << "Cannot start state server: " << error << std::endl;
+            return 1;
+        }
+        std::cout << "Streaming " << solarSystem.getBodyStates().size()
+                  << " bodies on ws://127.0.0.1:" << server.getPort()
+                  << " at " << daysPerSecond << " days/s (Ctrl+C to stop)" << std::endl;
+
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+
+        std::vector<BodyState> previous = solarSystem.getBodyStates();
+        std::vector<BodyState> blended;
+
+        PacedRunLoop loop = PacedRunLoop::forSystem(solarSystem, daysPerSecond * TimeConstants::DAY);
+        loop.setMaxStepsPerFrame(32);
+        // Keplerian steps leave bodyStates alone, so bring them up to the step
+        // before the last one of the frame first
+        loop.setSnapshotHook([&]() {
+            solarSystem.syncBodyStatesFromOrbits();
+            previous = solarSystem.getBodyStates();
+        });
+        loop.run([&](const PacedRunLoop::FrameResult& frame) {
+            if (frame.steps > 0) solarSystem.syncBodyStatesFromOrbits();
+
+            // Publish the blend between the last two steps so motion stays smooth
+            // when a frame covers a fraction of a step
+            PacedRunLoop::interpolate(previous, solarSystem.getBodyStates(), frame.alpha, blended);
+            double time = solarSystem.getTimeSystem().getCurrentTime() - (1.0 - frame.alpha) * loop.getStepSeconds();
+            server.publish(time, blended);
+            return !stopRequested;
+        });
+
+        const PacedRunLoop::Metrics& metrics = loop.getMetrics();
+        std::cout << "\nSteps: " << metrics.steps << ", dropped: " << metrics.droppedSteps
+                  << ", avg frame: " << metrics.avgFrameSeconds * 1e3 << " ms"
+                  << ", achieved: " << metrics.achievedRate / TimeConstants::DAY << " days/s" << std::endl;
+
+        StateStreamServer::Stats stats = server.getStats();
+        std::cout << "Frames sent: " << stats.framesSent << ", dropped: " << stats.framesDropped
+                  << ", bytes: " << stats.bytesSent << std::endl;
+        return 0;
+    }
+}
+#endif
+
+int main(int argc, char** argv) {
+#ifdef SOLARSYS_HAS_NET
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--serve") == 0) {
+            uint16_t port = 8765;
+            std::string dataPath = SOLARSYS_DATA_DIR "/solar-system/planet.json";
+            double daysPerSecond = 30.0;
+            if (i + 1 < argc && argv[i + 1][0] != '-' && !parsePort(argv[++i], port)) {
+                std::cerr << "Invalid port: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+            for (int j = i + 1; j < argc; ++j) {
+                bool data = std::strcmp(argv[j], "--data") == 0;
+                bool rate = std::strcmp(argv[j], "--rate") == 0;
+                if (!data && !rate) continue;
+                if (j + 1 >= argc || (rate && !parsePositive(argv[j + 1], daysPerSecond))) {
+                    std::cerr << "Invalid " << argv[j] << (j + 1 < argc ? std::string(" value: ") + argv[j + 1] : " (missing value)") << std::endl;
+                    printUsage(argv[0]);
+                    return 1;
+                }
+                if (data) dataPath = argv[j + 1];
+                ++j;
+            }
+            return runServer(port, dataPath, daysPerSecond);
+        }
+        // Test-particle shard for a coordinator listening on unix:/path or tcp:host:port
+        if (std::strcmp(argv[i], "--shard-worker") == 0 && i + 1 < argc) {
+            return ParticleShards::runWorker(argv[i + 1]);
+        }
+    }
+#else
+    (void)argc;
+    (void)argv;
+#endif
 
-int main() {
     std::cout << "=== Solar System Conquest Simulator ===" << std::endl;
     std::cout << "Initializing simulation..." << std::endl;
 
@@ -75,5 +216,9 @@ int main() {
               << " years" << std::endl;
     std::cout << "Total ticks: " << solarSystem.getTimeSystem().getTickCount() << std::endl;
 
+    if (Profiler::isCompiledIn()) {
+        Profiler::printReport(std::cout);
+    }
+
     return 0;
 }
\ No newline at end of file
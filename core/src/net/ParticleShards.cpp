@@ -0,0 +1,437 @@
+#include "../../include/net/ParticleShards.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+    /*--- Little-endian writers (same layout as StateStreamServer) ---*/
+    void putU8(std::vector<uint8_t>& out, uint8_t v) { out.push_back(v); }
+
+    void putU32(std::vector<uint8_t>& out, uint32_t v) {
+        for (int k = 0; k < 4; ++k) out.push_back(static_cast<uint8_t>(v >> (8 * k)));
+    }
+
+    void putI32(std::vector<uint8_t>& out, int32_t v) { putU32(out, static_cast<uint32_t>(v)); }
+
+    void putF64(std::vector<uint8_t>& out, double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        for (int k = 0; k < 8; ++k) out.push_back(static_cast<uint8_t>(bits >> (8 * k)));
+    }
+
+    void putHeader(std::vector<uint8_t>& out, uint8_t type) {
+        out.clear();
+        putU32(out, ShardMessage::MAGIC);
+        putU8(out, type);
+        putU8(out, 0);
+        putU8(out, 0);
+        putU8(out, 0);
+    }
+
+    /*--- Bounds-checked reader; every get leaves ok false past the end ---*/
+    struct Reader {
+        const uint8_t* data;
+        size_t size;
+        size_t offset = 0;
+        bool ok = true;
+
+        Reader(const std::vector<uint8_t>& message) : data(message.data()), size(message.size()) {}
+
+        bool take(size_t bytes) {
+            ok = ok && offset + bytes <= size;
+            return ok;
+        }
+        uint8_t u8() {
+            if (!take(1)) return 0;
+            return data[offset++];
+        }
+        uint32_t u32() {
+            if (!take(4)) return 0;
+            uint32_t v = 0;
+            for (int k = 0; k < 4; ++k) v |= static_cast<uint32_t>(data[offset++]) << (8 * k);
+            return v;
+        }
+        int32_t i32() { return static_cast<int32_t>(u32()); }
+        double f64() {
+            if (!take(8)) return 0.0;
+            uint64_t bits = 0;
+            for (int k = 0; k < 8; ++k) bits |= static_cast<uint64_t>(data[offset++]) << (8 * k);
+            double v;
+            std::memcpy(&v, &bits, sizeof(v));
+            return v;
+        }
+        // Guards element counts against the bytes actually present
+        bool fits(uint64_t count, size_t bytesEach) {
+            ok = ok && count <= (size - offset) / bytesEach;
+            return ok;
+        }
+        // Returns the message type, or 0xFF if the header is wrong
+        uint8_t header() {
+            if (u32() != ShardMessage::MAGIC) ok = false;
+            uint8_t type = u8();
+            u8(); u8(); u8();
+            return ok ? type : 0xFF;
+        }
+    };
+
+    constexpr size_t BODY_BYTES = 4 + 5 * 8;
+    constexpr size_t STATE_BYTES = 4 + 6 * 8;
+    constexpr size_t ENCOUNTER_BYTES = 4 + 4 + 2 * 8;
+
+    void putState(std::vector<uint8_t>& out, const BodyState& s) {
+        putI32(out, s.id);
+        putF64(out, s.position.x); putF64(out, s.position.y); putF64(out, s.position.z);
+        putF64(out, s.velocity.x); putF64(out, s.velocity.y); putF64(out, s.velocity.z);
+    }
+}
+
+/*--- ParticleShardWorker ---*/
+
+bool ParticleShardWorker::serve(ShardChannel& channel) {
+    std::vector<uint8_t> request, reply;
+    while (channel.receive(request)) {
+        bool shutdown = false;
+        if (!handle(request, reply, shutdown)) return false;
+        if (shutdown) return true;
+        if (!channel.send(reply)) return false;
+    }
+    return true;
+}
+
+bool ParticleShardWorker::handle(const std::vector<uint8_t>& request, std::vector<uint8_t>& reply, bool& shutdown) {
+    Reader in(request);
+    uint8_t type = in.header();
+    shutdown = false;
+    reply.clear();
+
+    if (type == ShardMessage::SHUTDOWN) {
+        shutdown = true;
+        return true;
+    }
+
+    if (type == ShardMessage::ASSIGN) {
+        shard = in.u32();
+        precision = in.u8() == 1 ? ForcePrecision::MIXED : ForcePrecision::DOUBLE;
+        mixed.pairTolerance = in.f64();
+        time = in.f64();
+
+        uint32_t bodies = in.u32();
+        if (!in.fits(bodies, BODY_BYTES)) return false;
+        bodyIds.resize(bodies);
+        encounterRadius.resize(bodies);
+        sources.x.resize(bodies); sources.y.resize(bodies); sources.z.resize(bodies); sources.gm.resize(bodies);
+        for (uint32_t j = 0; j < bodies; ++j) {
+            bodyIds[j] = in.i32();
+            sources.gm[j] = in.f64();
+            encounterRadius[j] = in.f64();
+            sources.x[j] = in.f64(); sources.y[j] = in.f64(); sources.z[j] = in.f64();
+        }
+
+        uint32_t count = in.u32();
+        if (!in.fits(count, STATE_BYTES)) return false;
+        ids.resize(count);
+        for (auto* v : {&x, &y, &z, &vx, &vy, &vz, &ax, &ay, &az}) v->resize(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            ids[i] = in.i32();
+            x[i] = in.f64(); y[i] = in.f64(); z[i] = in.f64();
+            vx[i] = in.f64(); vy[i] = in.f64(); vz[i] = in.f64();
+        }
+        if (!in.ok) return false;
+
+        // Particles starting inside a radius do not report an encounter for it
+        inside.assign(static_cast<size_t>(count) * bodies, 0);
+        encounters.clear();
+        detectEncounters();
+        encounters.clear();
+        computeAccelerations();
+        writeResult(reply, false);
+        return true;
+    }
+
+    if (type == ShardMessage::ADVANCE) {
+        double dt = in.f64();
+        uint32_t steps = in.u32();
+        bool wantStates = in.u8() != 0;
+        uint32_t bodies = in.u32();
+        if (!in.ok || bodies != bodyIds.size() || !in.fits(static_cast<uint64_t>(steps) * bodies, 24)) return false;
+
+        const size_t n = ids.size();
+        const double half = 0.5 * dt;
+        for (uint32_t s = 0; s < steps; ++s) {
+            for (size_t i = 0; i < n; ++i) {
+                vx[i] += ax[i] * half; vy[i] += ay[i] * half; vz[i] += az[i] * half;
+                x[i] += vx[i] * dt; y[i] += vy[i] * dt; z[i] += vz[i] * dt;
+            }
+            for (uint32_t j = 0; j < bodies; ++j) {
+                sources.x[j] = in.f64(); sources.y[j] = in.f64(); sources.z[j] = in.f64();
+            }
+            computeAccelerations();
+            for (size_t i = 0; i < n; ++i) {
+                vx[i] += ax[i] * half; vy[i] += ay[i] * half; vz[i] += az[i] * half;
+            }
+            time += dt;
+            detectEncounters();
+        }
+        writeResult(reply, wantStates);
+        encounters.clear();
+        return true;
+    }
+
+    return false;
+}
+
+void ParticleShardWorker::computeAccelerations() {
+    ParticleGravity::accelerations(sources, x.data(), y.data(), z.data(), ids.size(),
+                                   ax.data(), ay.data(), az.data(), nullptr, precision, mixed);
+}
+
+void ParticleShardWorker::detectEncounters() {
+    const size_t n = ids.size();
+    const size_t m = bodyIds.size();
+    for (size_t j = 0; j < m; ++j) {
+        double r = encounterRadius[j];
+        if (!(r > 0.0)) continue;
+        double r2 = r * r;
+        for (size_t i = 0; i < n; ++i) {
+            double dx = x[i] - sources.x[j], dy = y[i] - sources.y[j], dz = z[i] - sources.z[j];
+            double d2 = dx*dx + dy*dy + dz*dz;
+            uint8_t& flag = inside[i * m + j];
+            uint8_t now = d2 < r2;
+            if (now && !flag) encounters.push_back(ShardEncounter{ids[i], bodyIds[j], time, std::sqrt(d2)});
+            flag = now;
+        }
+    }
+}
+
+void ParticleShardWorker::writeResult(std::vector<uint8_t>& out, bool withStates) {
+    putHeader(out, ShardMessage::RESULT);
+    putU32(out, shard);
+    putF64(out, time);
+    putU32(out, static_cast<uint32_t>(encounters.size()));
+    for (const ShardEncounter& e : encounters) {
+        putI32(out, e.particleId);
+        putI32(out, e.bodyId);
+        putF64(out, e.time);
+        putF64(out, e.distance);
+    }
+
+    size_t n = withStates ? ids.size() : 0;
+    putU32(out, static_cast<uint32_t>(n));
+    out.reserve(out.size() + n * STATE_BYTES);
+    for (size_t i = 0; i < n; ++i) {
+        putI32(out, ids[i]);
+        putF64(out, x[i]); putF64(out, y[i]); putF64(out, z[i]);
+        putF64(out, vx[i]); putF64(out, vy[i]); putF64(out, vz[i]);
+    }
+}
+
+/*--- ParticleShardCoordinator ---*/
+
+void ParticleShardCoordinator::addWorker(std::unique_ptr<ShardChannel> channel) {
+    workers.push_back(std::move(channel));
+    shardSizes.push_back(0);
+}
+
+size_t ParticleShardCoordinator::getParticleCount() const {
+    size_t total = 0;
+    for (size_t n : shardSizes) total += n;
+    return total;
+}
+
+bool ParticleShardCoordinator::distribute(const std::vector<BodyState>& particles, const std::vector<BodyState>& massive,
+                                          const std::vector<double>& encounterRadii, double time_,
+                                          const ShardConfig& config) {
+    if (workers.empty()) return fail("no workers");
+    if (encounterRadii.size() != massive.size()) return fail("encounterRadii must match the massive bodies");
+
+    time = time_;
+    bodyIds.resize(massive.size());
+    for (size_t j = 0; j < massive.size(); ++j) bodyIds[j] = massive[j].id;
+
+    // Contiguous, near-equal shards keep distribute() order recoverable
+    size_t count = workers.size();
+    std::vector<std::vector<uint8_t>> requests(count);
+    size_t begin = 0;
+    for (size_t k = 0; k < count; ++k) {
+        size_t end = begin + (particles.size() - begin) / (count - k);
+        shardSizes[k] = end - begin;
+
+        std::vector<uint8_t>& out = requests[k];
+        putHeader(out, ShardMessage::ASSIGN);
+        putU32(out, static_cast<uint32_t>(k));
+        putU8(out, config.precision == ForcePrecision::MIXED ? 1 : 0);
+        putF64(out, config.mixed.pairTolerance);
+        putF64(out, time);
+        putU32(out, static_cast<uint32_t>(massive.size()));
+        for (size_t j = 0; j < massive.size(); ++j) {
+            putI32(out, massive[j].id);
+            putF64(out, PhysicsConstants::G * massive[j].mass);
+            putF64(out, encounterRadii[j]);
+            putF64(out, massive[j].position.x); putF64(out, massive[j].position.y); putF64(out, massive[j].position.z);
+        }
+        putU32(out, static_cast<uint32_t>(end - begin));
+        out.reserve(out.size() + (end - begin) * STATE_BYTES);
+        for (size_t i = begin; i < end; ++i) putState(out, particles[i]);
+        begin = end;
+    }
+    return exchange(requests, nullptr);
+}
+
+bool ParticleShardCoordinator::advance(const std::vector<std::vector<BodyState>>& samples, double dt) {
+    if (workers.empty()) return fail("no workers");
+
+    std::vector<uint8_t> request;
+    putHeader(request, ShardMessage::ADVANCE);
+    putF64(request, dt);
+    putU32(request, static_cast<uint32_t>(samples.size()));
+    putU8(request, 0);
+    putU32(request, static_cast<uint32_t>(bodyIds.size()));
+    for (const auto& massive : samples) {
+        if (massive.size() != bodyIds.size()) return fail("massive body count changed since distribute()");
+        for (size_t j = 0; j < massive.size(); ++j) {
+            if (massive[j].id != bodyIds[j]) return fail("massive body order changed since distribute()");
+            putF64(request, massive[j].position.x);
+            putF64(request, massive[j].position.y);
+            putF64(request, massive[j].position.z);
+        }
+    }
+    return exchange(std::vector<std::vector<uint8_t>>(workers.size(), request), nullptr);
+}
+
+bool ParticleShardCoordinator::gather(std::vector<BodyState>& particles) {
+    std::vector<uint8_t> request;
+    putHeader(request, ShardMessage::ADVANCE);
+    putF64(request, 0.0);
+    putU32(request, 0);
+    putU8(request, 1);
+    putU32(request, static_cast<uint32_t>(bodyIds.size()));
+    particles.clear();
+    particles.reserve(getParticleCount());
+    return exchange(std::vector<std::vector<uint8_t>>(workers.size(), request), &particles);
+}
+
+void ParticleShardCoordinator::shutdown() {
+    std::vector<uint8_t> request;
+    putHeader(request, ShardMessage::SHUTDOWN);
+    for (auto& worker : workers) {
+        worker->send(request);
+        worker->close();
+    }
+    workers.clear();
+    shardSizes.clear();
+}
+
+void ParticleShardCoordinator::detachWorkers() {
+    for (auto& worker : workers) worker->close();
+    workers.clear();
+    shardSizes.clear();
+}
+
+bool ParticleShardCoordinator::exchange(const std::vector<std::vector<uint8_t>>& requests,
+                                        std::vector<BodyState>* states) {
+    for (size_t k = 0; k < workers.size(); ++k) {
+        if (!workers[k]->send(requests[k])) return fail("worker " + std::to_string(k) + " is gone");
+    }
+
+    // Replies are read in shard order, which is also the particle order
+    size_t firstNew = encounters.size();
+    bool first = true;
+    for (size_t k = 0; k < workers.size(); ++k) {
+        if (!workers[k]->receive(buffer)) return fail("worker " + std::to_string(k) + " is gone");
+        Reader in(buffer);
+        if (in.header() != ShardMessage::RESULT || in.u32() != k) return fail("bad reply from worker " + std::to_string(k));
+
+        double shardTime = in.f64();
+        if (first) time = shardTime;
+        first = false;
+
+        uint32_t count = in.u32();
+        if (!in.fits(count, ENCOUNTER_BYTES)) return fail("truncated reply from worker " + std::to_string(k));
+        for (uint32_t e = 0; e < count; ++e) {
+            ShardEncounter encounter;
+            encounter.particleId = in.i32();
+            encounter.bodyId = in.i32();
+            encounter.time = in.f64();
+            encounter.distance = in.f64();
+            encounters.push_back(encounter);
+        }
+
+        uint32_t stateCount = in.u32();
+        if (!in.fits(stateCount, STATE_BYTES)) return fail("truncated reply from worker " + std::to_string(k));
+        for (uint32_t i = 0; states && i < stateCount; ++i) {
+            BodyState s{};
+            s.id = in.i32();
+            s.position.x = in.f64(); s.position.y = in.f64(); s.position.z = in.f64();
+            s.velocity.x = in.f64(); s.velocity.y = in.f64(); s.velocity.z = in.f64();
+            states->push_back(s);
+        }
+        if (!in.ok) return fail("truncated reply from worker " + std::to_string(k));
+    }
+
+    // Shards report in shard order; keep the whole log in time order
+    auto byTime = [](const ShardEncounter& a, const ShardEncounter& b) { return a.time < b.time; };
+    std::stable_sort(encounters.begin() + firstNew, encounters.end(), byTime);
+    std::inplace_merge(encounters.begin(), encounters.begin() + firstNew, encounters.end(), byTime);
+    return true;
+}
+
+bool ParticleShardCoordinator::fail(const std::string& message) {
+    lastError = message;
+    return false;
+}
+
+/*--- Local workers ---*/
+
+bool ParticleShards::spawnLocalWorkers(ParticleShardCoordinator& coordinator, size_t count,
+                                       std::vector<pid_t>& pids, std::string* error) {
+    for (size_t k = 0; k < count; ++k) {
+        std::unique_ptr<SocketChannel> parentEnd, childEnd;
+        if (!SocketChannel::pair(parentEnd, childEnd, error)) return false;
+
+        std::cout.flush();
+        pid_t pid = fork();
+        if (pid < 0) {
+            if (error) *error = std::string("fork: ") + std::strerror(errno);
+            return false;
+        }
+        if (pid == 0) {
+            // Child: drop the coordinator's end and every earlier worker's channel
+            parentEnd.reset();
+            coordinator.detachWorkers();
+            ParticleShardWorker worker;
+            bool ok = worker.serve(*childEnd);
+            childEnd.reset();
+            _exit(ok ? 0 : 1);
+        }
+        childEnd.reset();
+        pids.push_back(pid);
+        coordinator.addWorker(std::move(parentEnd));
+    }
+    return true;
+}
+
+void ParticleShards::waitForWorkers(std::vector<pid_t>& pids) {
+    for (pid_t pid : pids) {
+        int status;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+    }
+    pids.clear();
+}
+
+int ParticleShards::runWorker(const std::string& address) {
+    std::string error;
+    std::unique_ptr<SocketChannel> channel = SocketChannel::connect(address, &error);
+    if (!channel) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    ParticleShardWorker worker;
+    return worker.serve(*channel) ? 0 : 1;
+}
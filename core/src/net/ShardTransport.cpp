@@ -0,0 +1,263 @@
+#include "../../include/net/ShardTransport.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+    struct ParsedAddress {
+        bool isUnix = false;
+        std::string path;       // unix
+        std::string host;       // tcp
+        std::string port;
+    };
+
+    bool parseAddress(const std::string& address, ParsedAddress& out, std::string* error) {
+        if (address.rfind("unix:", 0) == 0) {
+            out.isUnix = true;
+            out.path = address.substr(5);
+            if (!out.path.empty() && out.path.size() < sizeof(sockaddr_un{}.sun_path)) return true;
+            if (error) *error = "bad unix socket path in '" + address + "'";
+            return false;
+        }
+        if (address.rfind("tcp:", 0) == 0) {
+            size_t colon = address.rfind(':');
+            if (colon > 4) {
+                out.host = address.substr(4, colon - 4);
+                out.port = address.substr(colon + 1);
+                // tcp:[::1]:port as well as tcp:::1:port
+                if (out.host.size() > 2 && out.host.front() == '[' && out.host.back() == ']') {
+                    out.host = out.host.substr(1, out.host.size() - 2);
+                }
+                if (!out.host.empty() && !out.port.empty()) return true;
+            }
+        }
+        if (error) *error = "expected unix:/path or tcp:host:port, got '" + address + "'";
+        return false;
+    }
+
+    sockaddr_un unixAddress(const std::string& path) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        return addr;
+    }
+
+    void setNoDelay(int fd) {
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    }
+
+    bool writeAll(int fd, const uint8_t* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool readAll(int fd, uint8_t* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::recv(fd, data, size, 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+}
+
+/*--- SocketChannel ---*/
+
+std::unique_ptr<SocketChannel> SocketChannel::connect(const std::string& address, std::string* error) {
+    ParsedAddress parsed;
+    if (!parseAddress(address, parsed, error)) return nullptr;
+
+    if (parsed.isUnix) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr = unixAddress(parsed.path);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            if (error) *error = "cannot connect to " + address + ": " + std::strerror(errno);
+            if (fd >= 0) ::close(fd);
+            return nullptr;
+        }
+        return std::make_unique<SocketChannel>(fd);
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* results = nullptr;
+    if (int rc = getaddrinfo(parsed.host.c_str(), parsed.port.c_str(), &hints, &results); rc != 0) {
+        if (error) *error = "cannot resolve " + address + ": " + gai_strerror(rc);
+        return nullptr;
+    }
+    int fd = -1;
+    for (addrinfo* ai = results; ai && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd >= 0 && ::connect(fd, ai->ai_addr, ai->ai_addrlen) < 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(results);
+    if (fd < 0) {
+        if (error) *error = "cannot connect to " + address + ": " + std::strerror(errno);
+        return nullptr;
+    }
+    setNoDelay(fd);
+    return std::make_unique<SocketChannel>(fd);
+}
+
+bool SocketChannel::pair(std::unique_ptr<SocketChannel>& a, std::unique_ptr<SocketChannel>& b, std::string* error) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+        if (error) *error = std::string("socketpair: ") + std::strerror(errno);
+        return false;
+    }
+    a = std::make_unique<SocketChannel>(fds[0]);
+    b = std::make_unique<SocketChannel>(fds[1]);
+    return true;
+}
+
+bool SocketChannel::send(const std::vector<uint8_t>& message) {
+    if (fd < 0 || message.size() > MAX_MESSAGE_BYTES) return false;
+    uint32_t size = static_cast<uint32_t>(message.size());
+    uint8_t prefix[4];
+    for (int k = 0; k < 4; ++k) prefix[k] = static_cast<uint8_t>(size >> (8 * k));
+    return writeAll(fd, prefix, 4) && writeAll(fd, message.data(), message.size());
+}
+
+bool SocketChannel::receive(std::vector<uint8_t>& message) {
+    uint8_t prefix[4];
+    if (fd < 0 || !readAll(fd, prefix, 4)) return false;
+    uint32_t size = 0;
+    for (int k = 0; k < 4; ++k) size |= static_cast<uint32_t>(prefix[k]) << (8 * k);
+    if (size > MAX_MESSAGE_BYTES) return false;
+    message.resize(size);
+    return readAll(fd, message.data(), size);
+}
+
+void SocketChannel::close() {
+    if (fd < 0) return;
+    ::close(fd);
+    fd = -1;
+}
+
+/*--- ShardListener ---*/
+
+bool ShardListener::listen(const std::string& address_, std::string* error) {
+    close();
+    ParsedAddress parsed;
+    if (!parseAddress(address_, parsed, error)) return false;
+
+    if (parsed.isUnix) {
+        listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr = unixAddress(parsed.path);
+        ::unlink(parsed.path.c_str());
+        if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            ::listen(listenFd, 64) < 0) {
+            if (error) *error = "cannot listen on " + address_ + ": " + std::strerror(errno);
+            close();
+            return false;
+        }
+        unixPath = parsed.path;
+        address = address_;
+        return true;
+    }
+
+    char* end = nullptr;
+    unsigned long portNumber = std::strtoul(parsed.port.c_str(), &end, 10);
+    if (*end != '\0' || portNumber > 65535) {
+        if (error) *error = "bad port in '" + address_ + "'";
+        return false;
+    }
+
+    // Same resolution as SocketChannel::connect, so both sides accept names
+    // (localhost) and IPv6 literals alike
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+    addrinfo* results = nullptr;
+    if (int rc = getaddrinfo(parsed.host.c_str(), parsed.port.c_str(), &hints, &results); rc != 0) {
+        if (error) *error = "cannot resolve " + address_ + ": " + gai_strerror(rc);
+        return false;
+    }
+    int lastErrno = 0;
+    for (addrinfo* ai = results; ai && listenFd < 0; ai = ai->ai_next) {
+        listenFd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (listenFd < 0) {
+            lastErrno = errno;
+            continue;
+        }
+        int yes = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        if (bind(listenFd, ai->ai_addr, ai->ai_addrlen) < 0 || ::listen(listenFd, 64) < 0) {
+            lastErrno = errno;
+            ::close(listenFd);
+            listenFd = -1;
+        }
+    }
+    freeaddrinfo(results);
+    if (listenFd < 0) {
+        if (error) *error = "cannot listen on " + address_ + ": " + std::strerror(lastErrno);
+        return false;
+    }
+
+    // Port 0 binds an ephemeral port; report the real one
+    sockaddr_storage bound{};
+    socklen_t len = sizeof(bound);
+    getsockname(listenFd, reinterpret_cast<sockaddr*>(&bound), &len);
+    uint16_t port = bound.ss_family == AF_INET6 ? reinterpret_cast<sockaddr_in6*>(&bound)->sin6_port
+                                                : reinterpret_cast<sockaddr_in*>(&bound)->sin_port;
+    address = "tcp:" + parsed.host + ":" + std::to_string(ntohs(port));
+    return true;
+}
+
+std::unique_ptr<SocketChannel> ShardListener::accept(double timeoutSeconds, std::string* error) {
+    if (listenFd < 0) {
+        if (error) *error = "not listening";
+        return nullptr;
+    }
+    pollfd pfd{listenFd, POLLIN, 0};
+    int timeoutMs = timeoutSeconds < 0.0 ? -1 : static_cast<int>(timeoutSeconds * 1000.0);
+    int ready;
+    do {
+        ready = poll(&pfd, 1, timeoutMs);
+    } while (ready < 0 && errno == EINTR);
+    if (ready <= 0) {
+        if (error) *error = ready == 0 ? "timed out waiting for a worker" : std::strerror(errno);
+        return nullptr;
+    }
+
+    int fd = ::accept(listenFd, nullptr, nullptr);
+    if (fd < 0) {
+        if (error) *error = std::strerror(errno);
+        return nullptr;
+    }
+    if (unixPath.empty()) setNoDelay(fd);
+    return std::make_unique<SocketChannel>(fd);
+}
+
+void ShardListener::close() {
+    if (listenFd >= 0) ::close(listenFd);
+    listenFd = -1;
+    if (!unixPath.empty()) ::unlink(unixPath.c_str());
+    unixPath.clear();
+    address.clear();
+}
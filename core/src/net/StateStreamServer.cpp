@@ -0,0 +1,262 @@
+#include "../../include/net/StateStreamServer.h"
+#include "../../include/io/Json.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+    void putU32(std::vector<uint8_t>& out, uint32_t v) {
+        for (int k = 0; k < 4; ++k) out.push_back(static_cast<uint8_t>(v >> (8 * k)));
+    }
+
+    void putU16(std::vector<uint8_t>& out, uint16_t v) {
+        out.push_back(static_cast<uint8_t>(v));
+        out.push_back(static_cast<uint8_t>(v >> 8));
+    }
+
+    void putF64(std::vector<uint8_t>& out, double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        for (int k = 0; k < 8; ++k) out.push_back(static_cast<uint8_t>(bits >> (8 * k)));
+    }
+
+    void putF32(std::vector<uint8_t>& out, float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        putU32(out, bits);
+    }
+}
+
+/*--- StreamClientSettings ---*/
+
+bool StreamClientSettings::applyJson(const std::string& text) {
+    JsonValue doc;
+    if (!JsonValue::parse(text, doc) || !doc.isObject()) return false;
+
+    if (const JsonValue* o = doc.find("origin"); o && o->isArray() && o->size() == 3) {
+        origin = Vec3((*o)[0].asNumber(), (*o)[1].asNumber(), (*o)[2].asNumber());
+    }
+    lodDistance = std::max(0.0, doc.getNumber("lodDistance", lodDistance));
+    farStride = static_cast<uint32_t>(std::clamp(doc.getNumber("farStride", farStride), 1.0, 1024.0));
+    quantum = std::max(1e-3, doc.getNumber("quantum", quantum));
+    keyframeInterval = static_cast<uint32_t>(std::clamp(doc.getNumber("keyframeInterval", keyframeInterval), 1.0, 1e6));
+    return true;
+}
+
+/*--- StreamSnapshot ---*/
+
+void StreamSnapshot::assign(double time_, const std::vector<BodyState>& states) {
+    time = time_;
+    ids.resize(states.size());
+    positions.resize(states.size() * 3);
+    for (size_t i = 0; i < states.size(); ++i) {
+        ids[i] = states[i].id;
+        positions[3*i]     = states[i].position.x;
+        positions[3*i + 1] = states[i].position.y;
+        positions[3*i + 2] = states[i].position.z;
+    }
+}
+
+/*--- StreamFrameEncoder ---*/
+
+void StreamFrameEncoder::setSettings(const StreamClientSettings& s) {
+    // Reconstructed positions are origin-relative, so a new origin needs a keyframe
+    if (s.origin.x != settings.origin.x || s.origin.y != settings.origin.y || s.origin.z != settings.origin.z) {
+        needKeyframe = true;
+    }
+    settings = s;
+}
+
+void StreamFrameEncoder::writeHeader(std::vector<uint8_t>& out, uint8_t type, uint32_t count,
+                                     double time, double quantum) {
+    out.clear();
+    putU32(out, StreamFrame::MAGIC);
+    out.push_back(type);
+    out.push_back(0);
+    putU16(out, 0);
+    putU32(out, sequence++);
+    putU32(out, count);
+    putF64(out, time);
+    putF64(out, settings.origin.x);
+    putF64(out, settings.origin.y);
+    putF64(out, settings.origin.z);
+    putF64(out, quantum);
+}
+
+void StreamFrameEncoder::encodeKeyframe(const StreamSnapshot& snapshot, std::vector<uint8_t>& out) {
+    size_t n = snapshot.ids.size();
+    writeHeader(out, StreamFrame::KEYFRAME, static_cast<uint32_t>(n), snapshot.time, 0.0);
+    out.reserve(StreamFrame::HEADER_BYTES + n * 16);
+
+    for (int id : snapshot.ids) putU32(out, static_cast<uint32_t>(id));
+
+    ids = snapshot.ids;
+    reconstructed.resize(3 * n);
+    const double origin[3] = {settings.origin.x, settings.origin.y, settings.origin.z};
+    for (size_t k = 0; k < 3 * n; ++k) {
+        float rel = static_cast<float>(snapshot.positions[k] - origin[k % 3]);
+        putF32(out, rel);
+        reconstructed[k] = rel;     // what the client will hold
+    }
+
+    needKeyframe = false;
+    framesSinceKey = 0;
+}
+
+bool StreamFrameEncoder::encode(const StreamSnapshot& snapshot, std::vector<uint8_t>& out) {
+    if (needKeyframe || snapshot.ids != ids || ++framesSinceKey >= settings.keyframeInterval) {
+        encodeKeyframe(snapshot, out);
+        return true;
+    }
+
+    size_t n = ids.size();
+    const double origin[3] = {settings.origin.x, settings.origin.y, settings.origin.z};
+    const double lod2 = settings.lodDistance * settings.lodDistance;
+    const uint32_t phase = sequence % settings.farStride;
+
+    // Level of detail: bodies past lodDistance only refresh on their round-robin slot
+    auto selected = [&](size_t i) {
+        if (settings.lodDistance <= 0.0 || settings.farStride <= 1) return true;
+        const double* r = &reconstructed[3*i];
+        if (r[0]*r[0] + r[1]*r[1] + r[2]*r[2] <= lod2) return true;
+        return i % settings.farStride == phase;
+    };
+
+    // Pick a quantum that keeps every selected delta inside int16
+    double maxDelta = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        if (!selected(i)) continue;
+        for (int c = 0; c < 3; ++c) {
+            double d = snapshot.positions[3*i + c] - origin[c] - reconstructed[3*i + c];
+            maxDelta = std::max(maxDelta, std::abs(d));
+        }
+    }
+    double quantum = std::max(settings.quantum, maxDelta / 32767.0);
+    if (!std::isfinite(quantum)) {
+        encodeKeyframe(snapshot, out);
+        return true;
+    }
+
+    writeHeader(out, StreamFrame::DELTA, 0, snapshot.time, quantum);
+    uint32_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (!selected(i)) continue;
+
+        int16_t q[3];
+        for (int c = 0; c < 3; ++c) {
+            double d = snapshot.positions[3*i + c] - origin[c] - reconstructed[3*i + c];
+            q[c] = static_cast<int16_t>(std::clamp(std::lround(d / quantum), -32767L, 32767L));
+        }
+        if (q[0] == 0 && q[1] == 0 && q[2] == 0) continue;
+
+        putU32(out, static_cast<uint32_t>(i));
+        for (int c = 0; c < 3; ++c) {
+            putU16(out, static_cast<uint16_t>(q[c]));
+            reconstructed[3*i + c] += q[c] * quantum;
+        }
+        ++count;
+    }
+
+    if (count == 0) {
+        --sequence;     // nothing sent, keep the client's sequence contiguous
+        return false;
+    }
+
+    // Patch the count field (offset 12) now that it is known
+    for (int k = 0; k < 4; ++k) out[12 + k] = static_cast<uint8_t>(count >> (8 * k));
+    return true;
+}
+
+/*--- StateStreamServer ---*/
+
+StateStreamServer::StateStreamServer(double maxFramesPerSecond_)
+    : maxFramesPerSecond(maxFramesPerSecond_), hasPending(false),
+      published(0), throttled(0), framesSent(0), framesDropped(0), bytesSent(0) {}
+
+bool StateStreamServer::start(uint16_t port, const std::string& bindAddress, std::string* error) {
+    WebSocketServer::Handlers handlers;
+    handlers.onOpen = [this](WebSocketServer::ClientId id) { onOpen(id); };
+    handlers.onText = [this](WebSocketServer::ClientId id, const std::string& text) { onText(id, text); };
+    handlers.onClose = [this](WebSocketServer::ClientId id) { encoders.erase(id); };
+    handlers.onWake = [this]() { onWake(); };
+    return server.start(port, handlers, bindAddress, error);
+}
+
+bool StateStreamServer::publish(double time, const std::vector<BodyState>& states) {
+    if (server.getClientCount() == 0) return false;
+
+    auto now = std::chrono::steady_clock::now();
+    if (maxFramesPerSecond > 0.0 &&
+        std::chrono::duration<double>(now - lastPublish).count() < 1.0 / maxFramesPerSecond) {
+        throttled.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    lastPublish = now;
+
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        pending.assign(time, states);
+        hasPending = true;
+    }
+    published.fetch_add(1, std::memory_order_relaxed);
+    server.wake();
+    return true;
+}
+
+StateStreamServer::Stats StateStreamServer::getStats() const {
+    Stats s;
+    s.published = published.load(std::memory_order_relaxed);
+    s.throttled = throttled.load(std::memory_order_relaxed);
+    s.framesSent = framesSent.load(std::memory_order_relaxed);
+    s.framesDropped = framesDropped.load(std::memory_order_relaxed);
+    s.bytesSent = bytesSent.load(std::memory_order_relaxed);
+    s.clients = server.getClientCount();
+    return s;
+}
+
+void StateStreamServer::onOpen(WebSocketServer::ClientId id) {
+    encoders[id] = StreamFrameEncoder();
+    // Late joiners get the latest state right away
+    if (!current.ids.empty()) sendTo(id, encoders[id]);
+}
+
+void StateStreamServer::onText(WebSocketServer::ClientId id, const std::string& text) {
+    auto it = encoders.find(id);
+    if (it == encoders.end()) return;
+
+    StreamClientSettings settings = it->second.getSettings();
+    if (settings.applyJson(text)) {
+        it->second.setSettings(settings);
+    } else if (text == "keyframe") {
+        it->second.requestKeyframe();
+    }
+}
+
+void StateStreamServer::onWake() {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        if (!hasPending) return;
+        std::swap(current, pending);
+        hasPending = false;
+    }
+
+    for (auto& [id, encoder] : encoders) {
+        // Backpressure: a client still draining its last frame skips this one.
+        // Deltas are closed-loop, so skipping never corrupts its state.
+        if (!server.isWritable(id)) {
+            framesDropped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        sendTo(id, encoder);
+    }
+}
+
+void StateStreamServer::sendTo(WebSocketServer::ClientId id, StreamFrameEncoder& encoder) {
+    if (!encoder.encode(current, frameBuffer)) return;
+    if (server.sendBinary(id, frameBuffer)) {
+        framesSent.fetch_add(1, std::memory_order_relaxed);
+        bytesSent.fetch_add(frameBuffer.size(), std::memory_order_relaxed);
+    }
+}
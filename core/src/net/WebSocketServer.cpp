@@ -0,0 +1,416 @@
+#include "../../include/net/WebSocketServer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+    /*--- SHA-1 (FIPS 180-4), only needed for Sec-WebSocket-Accept ---*/
+    std::string sha1(const std::string& message) {
+        uint32_t h[5] = {0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u, 0xC3D2E1F0u};
+
+        std::string data = message;
+        uint64_t bitLength = static_cast<uint64_t>(message.size()) * 8;
+        data += static_cast<char>(0x80);
+        while (data.size() % 64 != 56) data += static_cast<char>(0);
+        for (int k = 7; k >= 0; --k) data += static_cast<char>((bitLength >> (8 * k)) & 0xFF);
+
+        auto rotl = [](uint32_t v, int s) { return (v << s) | (v >> (32 - s)); };
+
+        for (size_t chunk = 0; chunk < data.size(); chunk += 64) {
+            uint32_t w[80];
+            for (int t = 0; t < 16; ++t) {
+                const auto* p = reinterpret_cast<const unsigned char*>(&data[chunk + 4 * t]);
+                w[t] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+            }
+            for (int t = 16; t < 80; ++t) w[t] = rotl(w[t-3] ^ w[t-8] ^ w[t-14] ^ w[t-16], 1);
+
+            uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+            for (int t = 0; t < 80; ++t) {
+                uint32_t f, k;
+                if (t < 20)      { f = (b & c) | (~b & d);           k = 0x5A827999u; }
+                else if (t < 40) { f = b ^ c ^ d;                    k = 0x6ED9EBA1u; }
+                else if (t < 60) { f = (b & c) | (b & d) | (c & d);  k = 0x8F1BBCDCu; }
+                else             { f = b ^ c ^ d;                    k = 0xCA62C1D6u; }
+                uint32_t temp = rotl(a, 5) + f + e + k + w[t];
+                e = d; d = c; c = rotl(b, 30); b = a; a = temp;
+            }
+            h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+        }
+
+        std::string digest;
+        for (uint32_t v : h) {
+            for (int k = 3; k >= 0; --k) digest += static_cast<char>((v >> (8 * k)) & 0xFF);
+        }
+        return digest;
+    }
+
+    std::string base64(const std::string& in) {
+        static const char* table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string out;
+        size_t i = 0;
+        for (; i + 2 < in.size(); i += 3) {
+            uint32_t v = (uint8_t(in[i]) << 16) | (uint8_t(in[i+1]) << 8) | uint8_t(in[i+2]);
+            out += table[(v >> 18) & 63]; out += table[(v >> 12) & 63];
+            out += table[(v >> 6) & 63];  out += table[v & 63];
+        }
+        if (i + 1 == in.size()) {
+            uint32_t v = uint8_t(in[i]) << 16;
+            out += table[(v >> 18) & 63]; out += table[(v >> 12) & 63]; out += "==";
+        } else if (i + 2 == in.size()) {
+            uint32_t v = (uint8_t(in[i]) << 16) | (uint8_t(in[i+1]) << 8);
+            out += table[(v >> 18) & 63]; out += table[(v >> 12) & 63];
+            out += table[(v >> 6) & 63];  out += '=';
+        }
+        return out;
+    }
+
+    std::string lowercase(std::string s) {
+        std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+        return s;
+    }
+
+    // Header value by case-insensitive name; empty if missing
+    std::string headerValue(const std::string& request, const std::string& name) {
+        std::string lower = lowercase(request);
+        std::string key = "\r\n" + lowercase(name) + ":";
+        size_t pos = lower.find(key);
+        if (pos == std::string::npos) return "";
+        size_t start = pos + key.size();
+        size_t end = request.find("\r\n", start);
+        std::string value = request.substr(start, end - start);
+        value.erase(0, value.find_first_not_of(" \t"));
+        value.erase(value.find_last_not_of(" \t") + 1);
+        return value;
+    }
+
+    void setNonBlocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+}
+
+WebSocketServer::WebSocketServer()
+    : listenFd(-1), wakePipe{-1, -1}, port(0), running(false), clientCount(0), nextClientId(1) {}
+
+WebSocketServer::~WebSocketServer() { stop(); }
+
+bool WebSocketServer::start(uint16_t port_, const Handlers& handlers_,
+                            const std::string& bindAddress, std::string* error) {
+    if (running) return true;
+    handlers = handlers_;
+
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        if (error) *error = std::strerror(errno);
+        return false;
+    }
+    int yes = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port_);
+    if (inet_pton(AF_INET, bindAddress.c_str(), &addr.sin_addr) != 1 ||
+        bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(listenFd, 16) < 0 || pipe(wakePipe) < 0) {
+        if (error) *error = "cannot listen on " + bindAddress + ":" + std::to_string(port_) + ": " + std::strerror(errno);
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    socklen_t len = sizeof(addr);
+    getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &len);
+    port = ntohs(addr.sin_port);
+
+    setNonBlocking(listenFd);
+    setNonBlocking(wakePipe[0]);
+    setNonBlocking(wakePipe[1]);
+
+    running = true;
+    ioThread = std::thread(&WebSocketServer::run, this);
+    return true;
+}
+
+void WebSocketServer::stop() {
+    if (!running.exchange(false)) return;
+    wake();
+    if (ioThread.joinable()) ioThread.join();
+
+    for (auto& [id, client] : clients) close(client.fd);
+    clients.clear();
+    clientCount = 0;
+    close(listenFd);
+    close(wakePipe[0]);
+    close(wakePipe[1]);
+    listenFd = wakePipe[0] = wakePipe[1] = -1;
+}
+
+void WebSocketServer::wake() {
+    // A full pipe already guarantees a pending wake-up, so EAGAIN is fine
+    char byte = 1;
+    if (wakePipe[1] >= 0) {
+        ssize_t ignored = write(wakePipe[1], &byte, 1);
+        (void)ignored;
+    }
+}
+
+bool WebSocketServer::isWritable(ClientId id) const {
+    auto it = clients.find(id);
+    return it != clients.end() && it->second.handshakeDone && !it->second.closing
+        && it->second.outOffset >= it->second.outBuffer.size();
+}
+
+bool WebSocketServer::sendBinary(ClientId id, const std::vector<uint8_t>& payload) {
+    auto it = clients.find(id);
+    if (it == clients.end() || !it->second.handshakeDone) return false;
+    queueFrame(it->second, 0x2, payload.data(), payload.size());
+    return true;
+}
+
+bool WebSocketServer::sendText(ClientId id, const std::string& text) {
+    auto it = clients.find(id);
+    if (it == clients.end() || !it->second.handshakeDone) return false;
+    queueFrame(it->second, 0x1, reinterpret_cast<const uint8_t*>(text.data()), text.size());
+    return true;
+}
+
+std::vector<WebSocketServer::ClientId> WebSocketServer::getClientIds() const {
+    std::vector<ClientId> ids;
+    for (const auto& [id, client] : clients) {
+        if (client.handshakeDone && !client.closing) ids.push_back(id);
+    }
+    return ids;
+}
+
+void WebSocketServer::run() {
+    std::vector<pollfd> fds;
+    std::vector<ClientId> ids;
+
+    while (running) {
+        fds.clear();
+        ids.clear();
+        fds.push_back({listenFd, POLLIN, 0});
+        fds.push_back({wakePipe[0], POLLIN, 0});
+        for (auto& [id, client] : clients) {
+            short events = POLLIN;
+            if (client.outOffset < client.outBuffer.size()) events |= POLLOUT;
+            fds.push_back({client.fd, events, 0});
+            ids.push_back(id);
+        }
+
+        if (poll(fds.data(), fds.size(), 250) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) acceptClients();
+
+        if (fds[1].revents & POLLIN) {
+            char drain[64];
+            while (read(wakePipe[0], drain, sizeof(drain)) > 0) {}
+            if (running && handlers.onWake) handlers.onWake();
+        }
+
+        for (size_t k = 2; k < fds.size(); ++k) {
+            auto it = clients.find(ids[k - 2]);
+            if (it == clients.end()) continue;
+            Client& client = it->second;
+
+            if (fds[k].revents & (POLLERR | POLLHUP | POLLNVAL)) client.closing = true;
+            if (fds[k].revents & POLLIN) readClient(it->first, client);
+            if (fds[k].revents & POLLOUT) flush(client);
+        }
+
+        // Reap closed clients once their close frame (if any) is out
+        std::vector<ClientId> dead;
+        for (auto& [id, client] : clients) {
+            if (client.closing && client.outOffset >= client.outBuffer.size()) dead.push_back(id);
+        }
+        for (ClientId id : dead) closeClient(id);
+    }
+}
+
+void WebSocketServer::acceptClients() {
+    while (true) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) return;
+        setNonBlocking(fd);
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+        Client client;
+        client.fd = fd;
+        clients.emplace(nextClientId++, std::move(client));
+    }
+}
+
+void WebSocketServer::readClient(ClientId id, Client& client) {
+    char buffer[4096];
+    while (true) {
+        ssize_t n = recv(client.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            client.inBuffer.append(buffer, static_cast<size_t>(n));
+            if (client.inBuffer.size() > 4 * MAX_MESSAGE_BYTES) { client.closing = true; return; }
+            continue;
+        }
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) client.closing = true;
+        break;
+    }
+
+    if (!client.handshakeDone) {
+        if (!processHandshake(client)) return;
+        ++clientCount;
+        if (handlers.onOpen) handlers.onOpen(id);
+    }
+    processFrames(id, client);
+}
+
+bool WebSocketServer::processHandshake(Client& client) {
+    size_t end = client.inBuffer.find("\r\n\r\n");
+    if (end == std::string::npos) {
+        if (client.inBuffer.size() > 8192) client.closing = true;
+        return false;
+    }
+
+    std::string request = client.inBuffer.substr(0, end + 2);
+    client.inBuffer.erase(0, end + 4);
+
+    std::string key = headerValue(request, "Sec-WebSocket-Key");
+    if (request.compare(0, 4, "GET ") != 0 || key.empty()) {
+        static const std::string reply = "HTTP/1.1 400 Bad Request\r\nConnection: close\r\n\r\n";
+        client.outBuffer.assign(reply.begin(), reply.end());
+        client.closing = true;
+        flush(client);
+        return false;
+    }
+
+    std::string accept = base64(sha1(key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"));
+    std::string reply =
+        "HTTP/1.1 101 Switching Protocols\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Accept: " + accept + "\r\n\r\n";
+    client.outBuffer.insert(client.outBuffer.end(), reply.begin(), reply.end());
+    client.handshakeDone = true;
+    flush(client);
+    return true;
+}
+
+void WebSocketServer::processFrames(ClientId id, Client& client) {
+    while (!client.closing) {
+        const auto* p = reinterpret_cast<const uint8_t*>(client.inBuffer.data());
+        size_t available = client.inBuffer.size();
+        if (available < 2) return;
+
+        bool fin = p[0] & 0x80;
+        uint8_t opcode = p[0] & 0x0F;
+        bool masked = p[1] & 0x80;
+        uint64_t length = p[1] & 0x7F;
+        size_t offset = 2;
+
+        if (length == 126) {
+            if (available < 4) return;
+            length = (uint64_t(p[2]) << 8) | p[3];
+            offset = 4;
+        } else if (length == 127) {
+            if (available < 10) return;
+            length = 0;
+            for (int k = 0; k < 8; ++k) length = (length << 8) | p[2 + k];
+            offset = 10;
+        }
+
+        // Clients must mask (RFC 6455 5.1); oversized messages are refused
+        if (!masked || length > MAX_MESSAGE_BYTES) { client.closing = true; return; }
+        if (available < offset + 4 + length) return;
+
+        const uint8_t* mask = p + offset;
+        std::string payload(static_cast<size_t>(length), '\0');
+        for (size_t k = 0; k < length; ++k) payload[k] = static_cast<char>(p[offset + 4 + k] ^ mask[k % 4]);
+        client.inBuffer.erase(0, offset + 4 + static_cast<size_t>(length));
+
+        switch (opcode) {
+            case 0x0:   // continuation
+            case 0x1:   // text
+                client.fragment += payload;
+                if (client.fragment.size() > MAX_MESSAGE_BYTES) { client.closing = true; return; }
+                if (fin) {
+                    if (handlers.onText) handlers.onText(id, client.fragment);
+                    client.fragment.clear();
+                }
+                break;
+            case 0x8:   // close: echo and hang up
+                queueFrame(client, 0x8, reinterpret_cast<const uint8_t*>(payload.data()),
+                           std::min<size_t>(payload.size(), 2));
+                client.closing = true;
+                break;
+            case 0x9:   // ping
+                queueFrame(client, 0xA, reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+                break;
+            default:    // binary input and pongs are ignored
+                break;
+        }
+    }
+}
+
+void WebSocketServer::queueFrame(Client& client, uint8_t opcode, const uint8_t* data, size_t size) {
+    // Compact the already-sent prefix before appending
+    if (client.outOffset > 0 && client.outOffset >= client.outBuffer.size()) {
+        client.outBuffer.clear();
+        client.outOffset = 0;
+    }
+
+    auto& out = client.outBuffer;
+    out.push_back(static_cast<uint8_t>(0x80 | opcode));
+    if (size < 126) {
+        out.push_back(static_cast<uint8_t>(size));
+    } else if (size <= 0xFFFF) {
+        out.push_back(126);
+        out.push_back(static_cast<uint8_t>(size >> 8));
+        out.push_back(static_cast<uint8_t>(size));
+    } else {
+        out.push_back(127);
+        for (int k = 7; k >= 0; --k) out.push_back(static_cast<uint8_t>(uint64_t(size) >> (8 * k)));
+    }
+    out.insert(out.end(), data, data + size);
+    flush(client);
+}
+
+void WebSocketServer::flush(Client& client) {
+    while (client.outOffset < client.outBuffer.size()) {
+        ssize_t n = send(client.fd, client.outBuffer.data() + client.outOffset,
+                         client.outBuffer.size() - client.outOffset, MSG_NOSIGNAL);
+        if (n > 0) {
+            client.outOffset += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        client.closing = true;
+        client.outOffset = client.outBuffer.size();
+        return;
+    }
+    client.outBuffer.clear();
+    client.outOffset = 0;
+}
+
+void WebSocketServer::closeClient(ClientId id) {
+    auto it = clients.find(id);
+    if (it == clients.end()) return;
+    bool wasOpen = it->second.handshakeDone;
+    close(it->second.fd);
+    clients.erase(it);
+    if (wasOpen) {
+        --clientCount;
+        if (handlers.onClose) handlers.onClose(id);
+    }
+}
@@ -0,0 +1,163 @@
+#include "../../include/physics/EncounterRegularization.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    // Relative motion in LogH form; t is physical time since the step began
+    struct RelativeState {
+        Vec3 r;
+        Vec3 v;
+        double binding;     // B = mu / r - v^2 / 2, constant for an isolated pair
+        double t;
+    };
+
+    // Yoshida triple-jump weights: w1, w0, w1 composes a symmetric second-order
+    // step into a fourth-order one
+    const double CBRT2 = std::cbrt(2.0);
+    const double W1 = 1.0 / (2.0 - CBRT2);
+    const double W0 = -CBRT2 / (2.0 - CBRT2);
+
+    void drift(RelativeState& s, double h, double mu) {
+        double w = 0.5 * s.v.magnitudeSquared() + s.binding;
+        // T + B equals mu / r along the exact motion; guard against rounding
+        // on a nearly parabolic pass
+        if (!(w > 0.0)) w = mu / s.r.magnitude();
+        double dt = h / w;
+        s.r += s.v * dt;
+        s.t += dt;
+    }
+
+    // ds * r / mu of physical time at acceleration -mu r / r^3
+    void kick(RelativeState& s, double h) {
+        double r = s.r.magnitude();
+        s.v += s.r * (-h / (r * r));
+    }
+
+    void leapfrog(RelativeState& s, double h, double mu) {
+        drift(s, 0.5 * h, mu);
+        kick(s, h);
+        drift(s, 0.5 * h, mu);
+    }
+
+    void composedStep(RelativeState& s, double h, double mu) {
+        leapfrog(s, W1 * h, mu);
+        leapfrog(s, W0 * h, mu);
+        leapfrog(s, W1 * h, mu);
+    }
+
+    constexpr int KICKS_PER_STEP = 3;
+    constexpr int LANDING_ITERATIONS = 8;
+    constexpr double LANDING_TOLERANCE = 1e-14;
+    constexpr double PLUNGE_SPEED2 = 1.5;       // v^2 r / mu at half the semi-major axis
+}
+
+void EncounterRegularization::findPairs(const std::vector<BodyState>& bodies, double dt,
+                                        const EncounterConfig& config, std::vector<EncounterPair>& out) {
+    out.clear();
+    const size_t n = bodies.size();
+    if (n < 2 || dt <= 0.0) return;
+
+    size_t central = 0;
+    for (size_t k = 1; k < n; ++k) {
+        if (bodies[k].mass > bodies[central].mass) central = k;
+    }
+    const Vec3 centre = bodies[central].position;
+    const double centralMass = bodies[central].mass;
+
+    std::vector<EncounterPair> candidates;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            double mu = PhysicsConstants::G * (bodies[i].mass + bodies[j].mass);
+            if (mu <= 0.0) continue;
+            double r = (bodies[j].position - bodies[i].position).magnitude();
+
+            double severity = dt / std::sqrt(r * r * r / mu);
+            if (i == central || j == central) {
+                // Only a plunge counts: inside half the semi-major axis
+                // (v^2 > 1.5 mu / r), which bound orbits below e = 0.5 never
+                // reach, so a planet with a short period is left to the global step
+                double v2 = (bodies[j].velocity - bodies[i].velocity).magnitudeSquared();
+                if (!(severity > config.stepFraction) || !(v2 * r > PLUNGE_SPEED2 * mu)) continue;
+            } else {
+                double mutualHill = std::cbrt((bodies[i].mass + bodies[j].mass) / (3.0 * centralMass)) * 0.5 *
+                                    ((bodies[i].position - centre).magnitude() + (bodies[j].position - centre).magnitude());
+                if (!(r < config.hillFactor * mutualHill)) continue;
+            }
+            candidates.push_back({i, j, severity});
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+              [](const EncounterPair& a, const EncounterPair& b) { return a.severity > b.severity; });
+    std::vector<char> taken(n, 0);
+    for (const EncounterPair& pair : candidates) {
+        if (taken[pair.first] || taken[pair.second]) continue;
+        taken[pair.first] = taken[pair.second] = 1;
+        out.push_back(pair);
+    }
+}
+
+uint32_t EncounterRegularization::advancePair(BodyState& a, BodyState& b, const Vec3& externalA,
+                                              const Vec3& externalB, double dt, const EncounterConfig& config) {
+    const double totalMass = a.mass + b.mass;
+    const double mu = PhysicsConstants::G * totalMass;
+    const double wa = a.mass / totalMass;
+    const double wb = b.mass / totalMass;
+
+    /*--- Opening half kick from the external field (completePair() closes) ---*/
+    a.velocity += externalA * (0.5 * dt);
+    b.velocity += externalB * (0.5 * dt);
+
+    /*--- Isolated pair: centre of mass drifts, relative motion by LogH landing on dt ---*/
+    Vec3 com = a.position * wa + b.position * wb;
+    Vec3 comVelocity = a.velocity * wa + b.velocity * wb;
+    com += comVelocity * dt;
+
+    RelativeState s;
+    s.r = b.position - a.position;
+    s.v = b.velocity - a.velocity;
+    s.binding = mu / s.r.magnitude() - 0.5 * s.v.magnitudeSquared();
+    s.t = 0.0;
+
+    // Fictitious step sized from the start-of-step pace ds/dt = mu / r
+    const double h = dt * (mu / s.r.magnitude()) / std::max<uint32_t>(1, config.substeps);
+    const uint32_t maxSteps = std::max<uint32_t>(1, config.maxSubsteps);
+    uint32_t steps = 0;
+    for (;;) {
+        RelativeState next = s;
+        composedStep(next, h, mu);
+        ++steps;
+        if (next.t < dt && steps < maxSteps) {
+            s = next;
+            continue;
+        }
+
+        // Physical time per step is smooth in h (about h * r / mu), so a few
+        // rescalings pin the last step to the remaining time
+        const double remaining = dt - s.t;
+        double hk = h * remaining / (next.t - s.t);
+        for (int iter = 0; iter < LANDING_ITERATIONS; ++iter) {
+            next = s;
+            composedStep(next, hk, mu);
+            ++steps;
+            double taken = next.t - s.t;
+            if (std::abs(taken - remaining) <= LANDING_TOLERANCE * dt || !(taken > 0.0)) break;
+            hk *= remaining / taken;
+        }
+        s = next;
+        break;
+    }
+
+    a.position = com - s.r * wb;
+    b.position = com + s.r * wa;
+    a.velocity = comVelocity - s.v * wb;
+    b.velocity = comVelocity + s.v * wa;
+    return steps * KICKS_PER_STEP;
+}
+
+void EncounterRegularization::completePair(BodyState& a, BodyState& b, const Vec3& externalA,
+                                           const Vec3& externalB, double dt) {
+    a.velocity += externalA * (0.5 * dt);
+    b.velocity += externalB * (0.5 * dt);
+}
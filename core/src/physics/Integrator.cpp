@@ -3,10 +3,156 @@
 // Integrator class is header-only with static methods
 // Additional integration utilities go here
 
+#include "../../include/diagnostics/Profiler.h"
+#include <algorithm>
+
+namespace {
+
+    // y[k] = x[k] + a * d[k] over a whole ensemble array (contiguous, vectorizes)
+    void axpyInto(double* y, const double* x, double a, const double* d, size_t n) {
+        for (size_t k = 0; k < n; ++k) y[k] = x[k] + a * d[k];
+    }
+
+    void axpy(double* y, double a, const double* d, size_t n) {
+        for (size_t k = 0; k < n; ++k) y[k] += a * d[k];
+    }
+
+    // One body pair across all lanes. Rows i and j never overlap, and saying so
+    // through restrict parameters is what lets the lane loop vectorize.
+    void pairLanes(const double* __restrict xi, const double* __restrict yi, const double* __restrict zi,
+                   const double* __restrict xj, const double* __restrict yj, const double* __restrict zj,
+                   const double* __restrict mi, const double* __restrict mj,
+                   double* __restrict axi, double* __restrict ayi, double* __restrict azi,
+                   double* __restrict axj, double* __restrict ayj, double* __restrict azj, size_t lanes) {
+        for (size_t l = 0; l < lanes; ++l) {
+            double dx = xj[l] - xi[l];
+            double dy = yj[l] - yi[l];
+            double dz = zj[l] - zi[l];
+            double distSq = dx*dx + dy*dy + dz*dz;
+
+            // Same cutoff as Gravity::computeAcceleration, written as a select
+            bool coincident = distSq < 1e-10;
+            double safeSq = coincident ? 1.0 : distSq;
+            double invR3 = PhysicsConstants::G / (safeSq * std::sqrt(safeSq));
+            invR3 = coincident ? 0.0 : invR3;
+
+            double si = invR3 * mj[l];
+            double sj = invR3 * mi[l];
+            axi[l] += dx * si; ayi[l] += dy * si; azi[l] += dz * si;
+            axj[l] -= dx * sj; ayj[l] -= dy * sj; azj[l] -= dz * sj;
+        }
+    }
+}
+
+void Integrator::ensembleAcceleration(const EnsembleState& ensemble,
+                                      const double* px, const double* py, const double* pz,
+                                      double* ax, double* ay, double* az) {
+    SOLARSYS_PROFILE_SCOPE(FORCE_EVALUATION);
+    const size_t lanes = ensemble.laneCount;
+    const size_t bodies = ensemble.bodyCount;
+    const double* mass = ensemble.mass.data();
+    SOLARSYS_PROFILE_COUNT(FORCE_EVALUATIONS, bodies * lanes);
+    SOLARSYS_PROFILE_COUNT(PAIR_INTERACTIONS, bodies * (bodies - 1) * lanes);
+
+    std::fill(ax, ax + bodies * lanes, 0.0);
+    std::fill(ay, ay + bodies * lanes, 0.0);
+    std::fill(az, az + bodies * lanes, 0.0);
+
+    // Each pair is visited once; the lane loop is the vectorized dimension
+    for (size_t i = 0; i < bodies; ++i) {
+        const size_t bi = i * lanes;
+        for (size_t j = i + 1; j < bodies; ++j) {
+            const size_t bj = j * lanes;
+            pairLanes(px + bi, py + bi, pz + bi, px + bj, py + bj, pz + bj, mass + bi, mass + bj,
+                      ax + bi, ay + bi, az + bi, ax + bj, ay + bj, az + bj, lanes);
+        }
+    }
+}
+
+void Integrator::stepEnsemble(EnsembleState& e, double dt, IntegrationMethod method) {
+    SOLARSYS_PROFILE_SCOPE(ENSEMBLE_STEP);
+    const size_t n = e.bodyCount * e.laneCount;
+    if (n == 0) return;
+
+    double* px = e.px.data(); double* py = e.py.data(); double* pz = e.pz.data();
+    double* vx = e.vx.data(); double* vy = e.vy.data(); double* vz = e.vz.data();
+    double* ax = e.ax.data(); double* ay = e.ay.data(); double* az = e.az.data();
+
+    switch (method) {
+        case IntegrationMethod::EULER:
+            ensembleAcceleration(e, px, py, pz, ax, ay, az);
+            axpy(px, dt, vx, n); axpy(py, dt, vy, n); axpy(pz, dt, vz, n);
+            axpy(vx, dt, ax, n); axpy(vy, dt, ay, n); axpy(vz, dt, az, n);
+            break;
+
+        case IntegrationMethod::SYMPLECTIC_EULER:
+            ensembleAcceleration(e, px, py, pz, ax, ay, az);
+            axpy(vx, dt, ax, n); axpy(vy, dt, ay, n); axpy(vz, dt, az, n);
+            axpy(px, dt, vx, n); axpy(py, dt, vy, n); axpy(pz, dt, vz, n);
+            break;
+
+        case IntegrationMethod::VELOCITY_VERLET:
+            // Kick-drift-kick form; equivalent to the per-body method
+            if (!e.accelerationValid) ensembleAcceleration(e, px, py, pz, ax, ay, az);
+            axpy(vx, 0.5 * dt, ax, n); axpy(vy, 0.5 * dt, ay, n); axpy(vz, 0.5 * dt, az, n);
+            axpy(px, dt, vx, n); axpy(py, dt, vy, n); axpy(pz, dt, vz, n);
+            ensembleAcceleration(e, px, py, pz, ax, ay, az);
+            axpy(vx, 0.5 * dt, ax, n); axpy(vy, 0.5 * dt, ay, n); axpy(vz, 0.5 * dt, az, n);
+            break;
+
+        case IntegrationMethod::RK4: {
+            // Scratch layout: temp position (3), temp velocity (3), stage accel (3),
+            // accumulated dx (3), accumulated dv (3)
+            e.scratch.resize(15 * n);
+            double* tp[3]  = { &e.scratch[0 * n], &e.scratch[1 * n], &e.scratch[2 * n] };
+            double* tv[3]  = { &e.scratch[3 * n], &e.scratch[4 * n], &e.scratch[5 * n] };
+            double* ka[3]  = { &e.scratch[6 * n], &e.scratch[7 * n], &e.scratch[8 * n] };
+            double* sumR[3] = { &e.scratch[9 * n], &e.scratch[10 * n], &e.scratch[11 * n] };
+            double* sumV[3] = { &e.scratch[12 * n], &e.scratch[13 * n], &e.scratch[14 * n] };
+            double* p[3] = { px, py, pz };
+            double* v[3] = { vx, vy, vz };
+
+            // k1: derivatives at the start point
+            ensembleAcceleration(e, px, py, pz, ka[0], ka[1], ka[2]);
+            for (int c = 0; c < 3; ++c) {
+                std::copy(v[c], v[c] + n, sumR[c]);
+                std::copy(ka[c], ka[c] + n, sumV[c]);
+            }
+
+            // k2, k3 at the midpoint, k4 at the end
+            const double stageStep[3] = { 0.5 * dt, 0.5 * dt, dt };
+            const double stageWeight[3] = { 2.0, 2.0, 1.0 };
+            for (int stage = 0; stage < 3; ++stage) {
+                for (int c = 0; c < 3; ++c) {
+                    // Stage velocity is the previous stage's (v + h*a); position uses it
+                    double* prevV = (stage == 0) ? v[c] : tv[c];
+                    axpyInto(tp[c], p[c], stageStep[stage], prevV, n);
+                    axpyInto(tv[c], v[c], stageStep[stage], ka[c], n);
+                }
+                ensembleAcceleration(e, tp[0], tp[1], tp[2], ka[0], ka[1], ka[2]);
+                for (int c = 0; c < 3; ++c) {
+                    axpy(sumR[c], stageWeight[stage], tv[c], n);
+                    axpy(sumV[c], stageWeight[stage], ka[c], n);
+                }
+            }
+
+            for (int c = 0; c < 3; ++c) {
+                axpy(p[c], dt / 6.0, sumR[c], n);
+                axpy(v[c], dt / 6.0, sumV[c], n);
+            }
+            ensembleAcceleration(e, px, py, pz, ax, ay, az);
+            break;
+        }
+    }
+
+    e.accelerationValid = (method == IntegrationMethod::VELOCITY_VERLET || method == IntegrationMethod::RK4);
+}
+
 namespace IntegratorUtils {
 
     // Compute total system energy (kinetic + potential)
     double computeTotalEnergy(const std::vector<BodyState>& bodies) {
+        SOLARSYS_PROFILE_SCOPE(DIAGNOSTICS);
         double totalEnergy = 0.0;
         
         for (size_t i = 0; i < bodies.size(); ++i) {
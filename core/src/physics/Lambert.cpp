@@ -0,0 +1,166 @@
+#include "../../include/physics/Lambert.h"
+#include <cmath>
+
+namespace {
+
+    // Battin's hypergeometric series 2F1(3, 1, 5/2, z) near the parabola
+    double hypergeometricF(double z, double tolerance) {
+        double sum = 1.0, term = 1.0;
+        for (int j = 0; j < 60; ++j) {
+            term = term * (3.0 + j) * (1.0 + j) / (2.5 + j) * z / (j + 1);
+            sum += term;
+            if (std::abs(term) < tolerance) break;
+        }
+        return sum;
+    }
+
+    // First three derivatives of T(x) (Izzo eq. 22)
+    void timeDerivatives(double x, double T, double lambda, double& d1, double& d2, double& d3) {
+        double l2 = lambda * lambda;
+        double l3 = l2 * lambda;
+        double umx2 = 1.0 - x * x;
+        double y = std::sqrt(1.0 - l2 * umx2);
+        double y2 = y * y;
+        double y3 = y2 * y;
+        d1 = (3.0 * T * x - 2.0 + 2.0 * l3 * x / y) / umx2;
+        d2 = (3.0 * T + 5.0 * x * d1 + 2.0 * (1.0 - l2) * l3 / y3) / umx2;
+        d3 = (7.0 * x * d2 + 8.0 * d1 - 6.0 * (1.0 - l2) * l2 * l3 * x / (y3 * y2)) / umx2;
+    }
+
+    Vec3 cross(const Vec3& a, const Vec3& b) {
+        return Vec3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+    }
+}
+
+double LambertSolver::timeOfFlight(double x, double lambda) {
+    const double battin = 0.01;
+    const double lagrange = 0.2;
+    double dist = std::abs(x - 1.0);
+
+    // Lagrange's expression away from the parabola but not too far
+    if (dist < lagrange && dist > battin) {
+        double a = 1.0 / (1.0 - x * x);
+        if (a > 0.0) {
+            double alpha = 2.0 * std::acos(x);
+            double beta = 2.0 * std::asin(std::sqrt(lambda * lambda / a));
+            if (lambda < 0.0) beta = -beta;
+            return a * std::sqrt(a) * ((alpha - std::sin(alpha)) - (beta - std::sin(beta))) / 2.0;
+        }
+        double alpha = 2.0 * std::acosh(x);
+        double beta = 2.0 * std::asinh(std::sqrt(-lambda * lambda / a));
+        if (lambda < 0.0) beta = -beta;
+        return -a * std::sqrt(-a) * ((beta - std::sinh(beta)) - (alpha - std::sinh(alpha))) / 2.0;
+    }
+
+    double K = lambda * lambda;
+    double E = x * x - 1.0;
+    double rho = std::abs(E);
+    double z = std::sqrt(1.0 + K * E);
+
+    // Battin's series near x = 1
+    if (dist < battin) {
+        double eta = z - lambda * x;
+        double S1 = 0.5 * (1.0 - lambda - x * eta);
+        double Q = 4.0 / 3.0 * hypergeometricF(S1, 1e-11);
+        return (eta * eta * eta * Q + 4.0 * lambda * eta) / 2.0;
+    }
+
+    // Lancaster's expression elsewhere
+    double y = std::sqrt(rho);
+    double g = x * z - lambda * E;
+    double d = E < 0.0 ? std::acos(g) : std::log(y * (z - lambda * x) + g);
+    return (x - lambda * z - d / y) / E;
+}
+
+LambertSolution LambertSolver::solve(const Vec3& r1, const Vec3& r2, double tof, double mu,
+                                     bool prograde, double warmStart, bool useWarmStart) {
+    LambertSolution result;
+    result.x = 0.0;
+    result.iterations = 0;
+    result.valid = false;
+
+    double r1n = r1.magnitude();
+    double r2n = r2.magnitude();
+    Vec3 chord = r2 - r1;
+    double c = chord.magnitude();
+    if (!(tof > 0.0) || !(mu > 0.0) || r1n <= 0.0 || r2n <= 0.0 || c <= 0.0) return result;
+
+    double s = 0.5 * (r1n + r2n + c);
+    Vec3 ir1 = r1 * (1.0 / r1n);
+    Vec3 ir2 = r2 * (1.0 / r2n);
+    Vec3 ih = cross(ir1, ir2);
+    double ihn = ih.magnitude();
+    if (ihn < 1e-12) return result;    // 0 or 180 degrees: transfer plane undefined
+    ih = ih * (1.0 / ihn);
+
+    double lambda2 = 1.0 - c / s;
+    double lambda = std::sqrt(std::max(0.0, lambda2));
+
+    // Transfer direction: prograde means angular momentum along +z
+    Vec3 it1, it2;
+    bool flip = prograde ? ih.z < 0.0 : ih.z >= 0.0;
+    if (flip) {
+        lambda = -lambda;
+        it1 = cross(ir1, ih);
+        it2 = cross(ir2, ih);
+    } else {
+        it1 = cross(ih, ir1);
+        it2 = cross(ih, ir2);
+    }
+    it1 = it1 * (1.0 / it1.magnitude());
+    it2 = it2 * (1.0 / it2.magnitude());
+
+    double T = std::sqrt(2.0 * mu / (s * s * s)) * tof;
+
+    // Izzo's initial guess (eq. 30) unless a neighbour's x is supplied
+    double x;
+    if (useWarmStart && warmStart > -1.0) {
+        x = warmStart;
+    } else {
+        double T0 = std::acos(lambda) + lambda * std::sqrt(1.0 - lambda2);
+        double T1 = 2.0 / 3.0 * (1.0 - lambda2 * lambda);
+        if (T >= T0) {
+            x = std::pow(T0 / T, 2.0 / 3.0) - 1.0;
+        } else if (T < T1) {
+            x = 2.5 * T1 / T * (T1 - T) / (1.0 - lambda2 * lambda2 * lambda) + 1.0;
+        } else {
+            x = std::pow(T0 / T, 1.0 / std::log2(T0 / T1)) - 1.0;
+        }
+    }
+
+    // Householder iterations on T(x) - T
+    int it = 0;
+    double err = 1.0;
+    while (err > 1e-11 && it < MAX_ITERATIONS) {
+        double t = timeOfFlight(x, lambda);
+        double d1, d2, d3;
+        timeDerivatives(x, t, lambda, d1, d2, d3);
+        double delta = t - T;
+        double d1sq = d1 * d1;
+        double xNew = x - delta * (d1sq - delta * d2 / 2.0)
+                        / (d1 * (d1sq - delta * d2) + d3 * delta * delta / 6.0);
+        if (!std::isfinite(xNew)) return result;
+        if (xNew <= -1.0) xNew = 0.5 * (x - 1.0);  // stay in the domain x > -1
+        err = std::abs(x - xNew);
+        x = xNew;
+        ++it;
+    }
+    if (err > 1e-8) return result;
+
+    // Velocities from x (Izzo Algorithm 1, last block)
+    double gamma = std::sqrt(mu * s / 2.0);
+    double rho = (r1n - r2n) / c;
+    double sigma = std::sqrt(std::max(0.0, 1.0 - rho * rho));
+    double y = std::sqrt(1.0 - lambda2 + lambda2 * x * x);
+
+    double vr1 = gamma * ((lambda * y - x) - rho * (lambda * y + x)) / r1n;
+    double vr2 = -gamma * ((lambda * y - x) + rho * (lambda * y + x)) / r2n;
+    double vt = gamma * sigma * (y + lambda * x);
+
+    result.departureVelocity = ir1 * vr1 + it1 * (vt / r1n);
+    result.arrivalVelocity = ir2 * vr2 + it2 * (vt / r2n);
+    result.x = x;
+    result.iterations = it;
+    result.valid = true;
+    return result;
+}
@@ -3,68 +3,164 @@
 // Orbit class is mostly header-only
 // Additional orbit utilities go here
 
+namespace {
+
+    constexpr double TWO_PI = 2.0 * M_PI;
+    constexpr double CIRCULAR_ECCENTRICITY = 1e-10;
+    constexpr double EQUATORIAL_SIN_INCLINATION = 1e-10;
+
+    inline double wrapAngle(double angle) { return angle < 0.0 ? angle + TWO_PI : angle; }
+
+    // Pass 1: pure arithmetic, no libm calls besides sqrt, so it vectorizes.
+    // Every angle is emitted as an unnormalized (sin-like, cos-like) pair for
+    // pass 2; degenerate frames are chosen by selects rather than branches.
+    void geometryKernel(const double* __restrict px, const double* __restrict py, const double* __restrict pz,
+                        const double* __restrict vx, const double* __restrict vy, const double* __restrict vz,
+                        const double* __restrict mu,
+                        double* __restrict semiMajorAxis, double* __restrict eccentricity,
+                        double* __restrict incS, double* __restrict incC,
+                        double* __restrict nodeS, double* __restrict nodeC,
+                        double* __restrict periS, double* __restrict periC,
+                        double* __restrict nuS, double* __restrict nuC,
+                        double* __restrict anomS, double* __restrict anomC,
+                        size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            double x = px[i], y = py[i], z = pz[i];
+            double u = vx[i], v = vy[i], w = vz[i];
+            double m = mu[i];
+
+            double hx = y*w - z*v, hy = z*u - x*w, hz = x*v - y*u;
+            double hMag = std::sqrt(hx*hx + hy*hy + hz*hz);
+            double r = std::sqrt(x*x + y*y + z*z);
+            double v2 = u*u + v*v + w*w;
+            double rv = x*u + y*v + z*w;
+
+            // Eccentricity vector and vis-viva semi-major axis (a < 0 if hyperbolic)
+            double c1 = (v2 - m / r) / m, c2 = rv / m;
+            double ex = c1*x - c2*u, ey = c1*y - c2*v, ez = c1*z - c2*w;
+            double e = std::sqrt(ex*ex + ey*ey + ez*ez);
+            semiMajorAxis[i] = -0.5 * m / (0.5 * v2 - m / r);
+            eccentricity[i] = e;
+
+            // Node unit vector n = z x h; equatorial orbits use +x
+            double nMag = std::sqrt(hx*hx + hy*hy);
+            bool equatorial = nMag <= EQUATORIAL_SIN_INCLINATION * hMag;
+            double invN = 1.0 / (equatorial ? 1.0 : nMag);
+            double nx = equatorial ? 1.0 : -hy * invN;
+            double ny = equatorial ? 0.0 : hx * invN;
+            incS[i] = nMag;
+            incC[i] = hz;
+            nodeS[i] = ny;
+            nodeC[i] = nx;
+
+            // In-plane basis (n, q) with q = h_hat x n
+            double invH = 1.0 / hMag;
+            double qx = -hz * ny * invH, qy = hz * nx * invH, qz = (hx*ny - hy*nx) * invH;
+
+            // Periapsis direction; circular orbits put it on the node
+            bool circular = e <= CIRCULAR_ECCENTRICITY;
+            double invE = 1.0 / (circular ? 1.0 : e);
+            double cosW = circular ? 1.0 : (ex*nx + ey*ny) * invE;
+            double sinW = circular ? 0.0 : (ex*qx + ey*qy + ez*qz) * invE;
+            periS[i] = sinW;
+            periC[i] = cosW;
+
+            // True anomaly = argument of latitude - argument of periapsis
+            double invR = 1.0 / r;
+            double cosU = (x*nx + y*ny) * invR;
+            double sinU = (x*qx + y*qy + z*qz) * invR;
+            double cosNu = cosU*cosW + sinU*sinW;
+            double sinNu = sinU*cosW - cosU*sinW;
+            nuS[i] = sinNu;
+            nuC[i] = cosNu;
+
+            // sin E, cos E (elliptic) or sinh H, cosh H (hyperbolic) share one form
+            double invD = 1.0 / (1.0 + e * cosNu);
+            double oneMinusE2 = 1.0 - e*e;
+            anomS[i] = std::sqrt(oneMinusE2 < 0.0 ? -oneMinusE2 : oneMinusE2) * sinNu * invD;
+            anomC[i] = (e + cosNu) * invD;
+        }
+    }
+
+    // Pass 2: angle recovery. Each loop is one libm call per body and a select.
+    void angleKernel(const double* __restrict eccentricity,
+                     double* __restrict inclination, const double* __restrict incC,
+                     double* __restrict node, const double* __restrict nodeC,
+                     double* __restrict peri, const double* __restrict periC,
+                     double* __restrict nu, const double* __restrict nuC,
+                     double* __restrict meanAnomaly, const double* __restrict anomC,
+                     size_t count) {
+        for (size_t i = 0; i < count; ++i) inclination[i] = std::atan2(inclination[i], incC[i]);
+        for (size_t i = 0; i < count; ++i) node[i] = wrapAngle(std::atan2(node[i], nodeC[i]));
+        for (size_t i = 0; i < count; ++i) peri[i] = wrapAngle(std::atan2(peri[i], periC[i]));
+        for (size_t i = 0; i < count; ++i) nu[i] = wrapAngle(std::atan2(nu[i], nuC[i]));
+        for (size_t i = 0; i < count; ++i) {
+            double e = eccentricity[i], s = meanAnomaly[i], c = anomC[i];
+            double elliptic = wrapAngle(std::atan2(s, c) - e * s);
+            // cosh H + sinh H = exp(H) > 0 on the hyperbolic branch
+            double hyperbolic = e * s - std::log(std::abs(c + s));
+            meanAnomaly[i] = e > 1.0 ? hyperbolic : elliptic;
+        }
+    }
+}
+
+void ElementArrays::resize(size_t count) {
+    semiMajorAxis.resize(count);
+    eccentricity.resize(count);
+    inclination.resize(count);
+    longitudeOfAscNode.resize(count);
+    argumentOfPeriapsis.resize(count);
+    trueAnomaly.resize(count);
+    meanAnomaly.resize(count);
+    scratch.resize(5 * count);
+}
+
+OrbitalElements ElementArrays::get(size_t index, double epoch) const {
+    OrbitalElements elements;
+    elements.semiMajorAxis = semiMajorAxis[index];
+    elements.eccentricity = eccentricity[index];
+    elements.inclination = inclination[index];
+    elements.longitudeOfAscNode = longitudeOfAscNode[index];
+    elements.argumentOfPeriapsis = argumentOfPeriapsis[index];
+    elements.trueAnomaly = trueAnomaly[index];
+    elements.meanAnomaly = meanAnomaly[index];
+    elements.epoch = epoch;
+    return elements;
+}
+
 namespace OrbitUtils {
 
-    // Convert state vectors to orbital elements
+    // Convert state vectors to orbital elements (single body through the batch kernels)
     OrbitalElements stateToElements(const Vec3& position, const Vec3& velocity, double mu) {
         OrbitalElements elements;
-        
-        Vec3 h = position.cross(velocity);  // specific angular momentum
-        Vec3 n(-h.y, h.x, 0.0);              // node vector
-        
-        double r = position.magnitude();
-        double v = velocity.magnitude();
-        
-        // Eccentricity vector
-        Vec3 eVec = (position * (v*v - mu/r) - velocity * position.dot(velocity)) / mu;
-        elements.eccentricity = eVec.magnitude();
-        
-        // Semi-major axis
-        double energy = v*v/2.0 - mu/r;
-        if (std::abs(elements.eccentricity - 1.0) > 1e-10) {
-            elements.semiMajorAxis = -mu / (2.0 * energy);
-        } else {
-            elements.semiMajorAxis = std::numeric_limits<double>::infinity();
-        }
-        
-        // Inclination
-        elements.inclination = std::acos(h.z / h.magnitude());
-        
-        // Longitude of ascending node
-        double nMag = n.magnitude();
-        if (nMag > 1e-10) {
-            elements.longitudeOfAscNode = std::acos(n.x / nMag);
-            if (n.y < 0) elements.longitudeOfAscNode = 2*M_PI - elements.longitudeOfAscNode;
-        } else {
-            elements.longitudeOfAscNode = 0.0;
-        }
-        
-        // Argument of periapsis
-        if (nMag > 1e-10 && elements.eccentricity > 1e-10) {
-            elements.argumentOfPeriapsis = std::acos(n.dot(eVec) / (nMag * elements.eccentricity));
-            if (eVec.z < 0) elements.argumentOfPeriapsis = 2*M_PI - elements.argumentOfPeriapsis;
-        } else {
-            elements.argumentOfPeriapsis = 0.0;
-        }
-        
-        // True anomaly
-        if (elements.eccentricity > 1e-10) {
-            elements.trueAnomaly = std::acos(eVec.dot(position) / (elements.eccentricity * r));
-            if (position.dot(velocity) < 0) elements.trueAnomaly = 2*M_PI - elements.trueAnomaly;
-        } else {
-            elements.trueAnomaly = 0.0;
-        }
-        
-        // Mean anomaly (from true anomaly via eccentric anomaly)
-        double E = 2.0 * std::atan(std::sqrt((1-elements.eccentricity)/(1+elements.eccentricity)) 
-                                   * std::tan(elements.trueAnomaly/2));
-        elements.meanAnomaly = E - elements.eccentricity * std::sin(E);
-        
+        double c[5];
+        geometryKernel(&position.x, &position.y, &position.z, &velocity.x, &velocity.y, &velocity.z, &mu,
+                       &elements.semiMajorAxis, &elements.eccentricity,
+                       &elements.inclination, &c[0], &elements.longitudeOfAscNode, &c[1],
+                       &elements.argumentOfPeriapsis, &c[2], &elements.trueAnomaly, &c[3],
+                       &elements.meanAnomaly, &c[4], 1);
+        angleKernel(&elements.eccentricity, &elements.inclination, &c[0], &elements.longitudeOfAscNode, &c[1],
+                    &elements.argumentOfPeriapsis, &c[2], &elements.trueAnomaly, &c[3],
+                    &elements.meanAnomaly, &c[4], 1);
         elements.epoch = 0.0;
-        
         return elements;
     }
 
+    void stateToElementsBatch(const double* x, const double* y, const double* z,
+                              const double* vx, const double* vy, const double* vz,
+                              const double* mu, size_t count, ElementArrays& out) {
+        out.resize(count);
+        double* c = out.scratch.data();
+        geometryKernel(x, y, z, vx, vy, vz, mu,
+                       out.semiMajorAxis.data(), out.eccentricity.data(),
+                       out.inclination.data(), c, out.longitudeOfAscNode.data(), c + count,
+                       out.argumentOfPeriapsis.data(), c + 2 * count, out.trueAnomaly.data(), c + 3 * count,
+                       out.meanAnomaly.data(), c + 4 * count, count);
+        angleKernel(out.eccentricity.data(), out.inclination.data(), c, out.longitudeOfAscNode.data(), c + count,
+                    out.argumentOfPeriapsis.data(), c + 2 * count, out.trueAnomaly.data(), c + 3 * count,
+                    out.meanAnomaly.data(), c + 4 * count, count);
+    }
+
     // Calculate orbital energy
     double orbitalEnergy(double mu, double semiMajorAxis) {
         if (std::abs(semiMajorAxis) < 1e-10) return 0.0;
@@ -0,0 +1,252 @@
+#include "../../include/physics/ParticleGravity.h"
+#include "../../include/diagnostics/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    constexpr size_t BLOCK = 256;
+    constexpr size_t GROUP = 4;
+    constexpr double FLOAT_EPSILON = 5.9604644775390625e-8;    // 2^-24, float32 unit roundoff
+    constexpr double COINCIDENT_SQ = 1e-10;                    // Gravity::computeAcceleration cutoff
+
+    // Error of a float difference of two rounded positions, per unit offset
+    // magnitude: sqrt(3) per-axis roundoff, times 3 for d/r^3 sensitivity
+    const double PROMOTE_FACTOR = 3.0 * std::sqrt(3.0) * FLOAT_EPSILON;
+
+    /*--- Double reference pair loop for one source ---*/
+    template <bool WithPotential>
+    void doublePairs(const double* __restrict x, const double* __restrict y, const double* __restrict z, size_t n,
+                     double sx, double sy, double sz, double gm,
+                     double* __restrict ax, double* __restrict ay, double* __restrict az,
+                     double* __restrict potential) {
+        for (size_t i = 0; i < n; ++i) {
+            double dx = sx - x[i], dy = sy - y[i], dz = sz - z[i];
+            double distSq = dx*dx + dy*dy + dz*dz;
+            bool coincident = distSq < COINCIDENT_SQ;
+            double safeSq = coincident ? 1.0 : distSq;
+            double invR = 1.0 / std::sqrt(safeSq);
+            invR = coincident ? 0.0 : invR;
+            double s = gm * invR * invR * invR;
+            ax[i] += dx * s; ay[i] += dy * s; az[i] += dz * s;
+            if (WithPotential) potential[i] -= gm * invR;
+        }
+    }
+
+    /*--- Float pair loop for one group of sources over one block of scaled offsets ---*/
+    // The GROUP terms of a particle are summed in float and converted once:
+    // float-to-double conversion, not the pair arithmetic, is what bounds the
+    // kernel, and a short float sum adds no more error than one term already
+    // carries. Pairs inside a source's promoteSq are left out and flagged in
+    // the particle's mask; returns how many particles have any flag.
+    struct SourceGroup {
+        float x[GROUP], y[GROUP], z[GROUP];
+        float accel[GROUP];         // G*m / scale^2
+        float potential[GROUP];     // G*m / scale
+        float promoteSq[GROUP];
+    };
+
+    template <bool WithPotential>
+    size_t floatPairs(const float* __restrict fx, const float* __restrict fy, const float* __restrict fz, size_t n,
+                      const SourceGroup& group,
+                      double* __restrict ax, double* __restrict ay, double* __restrict az,
+                      double* __restrict potential, unsigned char* __restrict promoted) {
+        // Local copies: the compiler cannot tell the group apart from the outputs
+        float gx[GROUP], gy[GROUP], gz[GROUP], ga[GROUP], gp[GROUP], gr[GROUP];
+        for (size_t j = 0; j < GROUP; ++j) {
+            gx[j] = group.x[j]; gy[j] = group.y[j]; gz[j] = group.z[j];
+            ga[j] = group.accel[j]; gp[j] = group.potential[j]; gr[j] = group.promoteSq[j];
+        }
+
+        size_t flagged = 0;
+        for (size_t i = 0; i < n; ++i) {
+            float sx = 0.0f, sy = 0.0f, sz = 0.0f, sp = 0.0f;
+            unsigned mask = 0;
+            for (size_t j = 0; j < GROUP; ++j) {
+                float dx = gx[j] - fx[i], dy = gy[j] - fy[i], dz = gz[j] - fz[i];
+                float distSq = dx*dx + dy*dy + dz*dz;
+                bool close = distSq < gr[j];
+                float safeSq = close ? 1.0f : distSq;
+                float invR = 1.0f / std::sqrt(safeSq);
+                invR = close ? 0.0f : invR;
+                float s = ga[j] * invR * invR * invR;
+                sx += dx * s; sy += dy * s; sz += dz * s;
+                if (WithPotential) sp += gp[j] * invR;
+                mask |= static_cast<unsigned>(close) << j;
+            }
+            ax[i] += static_cast<double>(sx);
+            ay[i] += static_cast<double>(sy);
+            az[i] += static_cast<double>(sz);
+            if (WithPotential) potential[i] -= static_cast<double>(sp);
+            promoted[i] = static_cast<unsigned char>(mask);
+            flagged += mask != 0;
+        }
+        return flagged;
+    }
+
+    template <bool WithPotential>
+    void doubleKernel(const ForceSources& sources, const double* x, const double* y, const double* z, size_t count,
+                      double* ax, double* ay, double* az, double* potential) {
+        for (size_t b = 0; b < count; b += BLOCK) {
+            size_t n = std::min(BLOCK, count - b);
+            for (size_t j = 0; j < sources.size(); ++j) {
+                doublePairs<WithPotential>(x + b, y + b, z + b, n, sources.x[j], sources.y[j], sources.z[j],
+                                           sources.gm[j], ax + b, ay + b, az + b,
+                                           WithPotential ? potential + b : nullptr);
+            }
+        }
+    }
+
+    template <bool WithPotential>
+    size_t mixedKernel(const ForceSources& sources, const double* x, const double* y, const double* z, size_t count,
+                       double* ax, double* ay, double* az, double* potential, double tolerance) {
+        const size_t m = sources.size();
+        float fx[BLOCK], fy[BLOCK], fz[BLOCK];
+        unsigned char promoted[BLOCK];
+        std::vector<double> sourceOffset(m);
+        size_t promotedPairs = 0;
+
+        for (size_t b = 0; b < count; b += BLOCK) {
+            size_t n = std::min(BLOCK, count - b);
+            const double* bx = x + b; const double* by = y + b; const double* bz = z + b;
+
+            // Local origin at the centre of the block's bounding box
+            double lo[3] = {bx[0], by[0], bz[0]}, hi[3] = {bx[0], by[0], bz[0]};
+            for (size_t i = 1; i < n; ++i) {
+                lo[0] = std::min(lo[0], bx[i]); hi[0] = std::max(hi[0], bx[i]);
+                lo[1] = std::min(lo[1], by[i]); hi[1] = std::max(hi[1], by[i]);
+                lo[2] = std::min(lo[2], bz[i]); hi[2] = std::max(hi[2], bz[i]);
+            }
+            double ox = 0.5 * (lo[0] + hi[0]), oy = 0.5 * (lo[1] + hi[1]), oz = 0.5 * (lo[2] + hi[2]);
+            double blockRadius = 0.5 * std::sqrt((hi[0] - lo[0]) * (hi[0] - lo[0]) + (hi[1] - lo[1]) * (hi[1] - lo[1])
+                                                 + (hi[2] - lo[2]) * (hi[2] - lo[2]));
+
+            // Power-of-two scale putting every offset below 1: exact, and keeps r^3 in float range
+            double extent = std::max(blockRadius, 1.0);
+            for (size_t j = 0; j < m; ++j) {
+                double dx = sources.x[j] - ox, dy = sources.y[j] - oy, dz = sources.z[j] - oz;
+                sourceOffset[j] = std::sqrt(dx*dx + dy*dy + dz*dz);
+                extent = std::max(extent, sourceOffset[j]);
+            }
+            double scale = std::ldexp(1.0, std::ilogb(extent) + 1);
+            double invScale = 1.0 / scale;
+
+            for (size_t i = 0; i < n; ++i) {
+                fx[i] = static_cast<float>((bx[i] - ox) * invScale);
+                fy[i] = static_cast<float>((by[i] - oy) * invScale);
+                fz[i] = static_cast<float>((bz[i] - oz) * invScale);
+            }
+
+            for (size_t first = 0; first < m; first += GROUP) {
+                // Unused slots: no mass, outside the unit cube, never promoted
+                SourceGroup group;
+                for (size_t j = 0; j < GROUP; ++j) {
+                    size_t k = first + j;
+                    if (k >= m) {
+                        group.x[j] = group.y[j] = group.z[j] = 2.0f;
+                        group.accel[j] = group.potential[j] = 0.0f;
+                        group.promoteSq[j] = -1.0f;
+                        continue;
+                    }
+                    double gm = sources.gm[k];
+                    double promoteRadius = PROMOTE_FACTOR * (blockRadius + sourceOffset[k]) * invScale / tolerance;
+                    group.x[j] = static_cast<float>((sources.x[k] - ox) * invScale);
+                    group.y[j] = static_cast<float>((sources.y[k] - oy) * invScale);
+                    group.z[j] = static_cast<float>((sources.z[k] - oz) * invScale);
+                    group.accel[j] = static_cast<float>(gm * invScale * invScale);
+                    group.potential[j] = static_cast<float>(gm * invScale);
+                    group.promoteSq[j] = static_cast<float>(std::min(promoteRadius * promoteRadius, 1e30));
+                }
+
+                size_t flagged = floatPairs<WithPotential>(fx, fy, fz, n, group, ax + b, ay + b, az + b,
+                                                           WithPotential ? potential + b : nullptr, promoted);
+                if (flagged == 0) continue;
+
+                // Near pairs: full double from the unshifted positions
+                for (size_t i = 0; i < n; ++i) {
+                    if (!promoted[i]) continue;
+                    for (size_t j = 0; j < GROUP; ++j) {
+                        if (!(promoted[i] & (1u << j))) continue;
+                        size_t k = first + j;
+                        ++promotedPairs;
+                        double gm = sources.gm[k];
+                        double dx = sources.x[k] - bx[i], dy = sources.y[k] - by[i], dz = sources.z[k] - bz[i];
+                        double distSq = dx*dx + dy*dy + dz*dz;
+                        if (distSq < COINCIDENT_SQ) continue;
+                        double invR = 1.0 / std::sqrt(distSq);
+                        double s = gm * invR * invR * invR;
+                        ax[b + i] += dx * s; ay[b + i] += dy * s; az[b + i] += dz * s;
+                        if (WithPotential) potential[b + i] -= gm * invR;
+                    }
+                }
+            }
+        }
+        return promotedPairs;
+    }
+}
+
+size_t ParticleGravity::accelerations(const ForceSources& sources,
+                                      const double* x, const double* y, const double* z, size_t count,
+                                      double* ax, double* ay, double* az, double* potential,
+                                      ForcePrecision precision, const MixedPrecisionConfig& config) {
+    SOLARSYS_PROFILE_SCOPE(FORCE_EVALUATION);
+    SOLARSYS_PROFILE_COUNT(FORCE_EVALUATIONS, count);
+    SOLARSYS_PROFILE_COUNT(PAIR_INTERACTIONS, count * sources.size());
+
+    std::fill(ax, ax + count, 0.0);
+    std::fill(ay, ay + count, 0.0);
+    std::fill(az, az + count, 0.0);
+    if (potential) std::fill(potential, potential + count, 0.0);
+    if (count == 0 || sources.size() == 0) return 0;
+
+    if (precision == ForcePrecision::DOUBLE) {
+        if (potential) doubleKernel<true>(sources, x, y, z, count, ax, ay, az, potential);
+        else doubleKernel<false>(sources, x, y, z, count, ax, ay, az, nullptr);
+        return 0;
+    }
+
+    double tolerance = config.pairTolerance > 0.0 ? config.pairTolerance : 1e-5;
+    if (potential) return mixedKernel<true>(sources, x, y, z, count, ax, ay, az, potential, tolerance);
+    return mixedKernel<false>(sources, x, y, z, count, ax, ay, az, nullptr, tolerance);
+}
+
+ForceErrorReport ParticleGravity::measureError(const ForceSources& sources,
+                                               const double* x, const double* y, const double* z, size_t count,
+                                               const MixedPrecisionConfig& config) {
+    ForceErrorReport report;
+    report.particles = count;
+    report.pairs = count * sources.size();
+    if (count == 0) return report;
+
+    std::vector<double> ref(4 * count), mix(4 * count);
+    double* r = ref.data();
+    double* m = mix.data();
+    accelerations(sources, x, y, z, count, r, r + count, r + 2 * count, r + 3 * count, ForcePrecision::DOUBLE);
+    report.promotedPairs = accelerations(sources, x, y, z, count, m, m + count, m + 2 * count, m + 3 * count,
+                                         ForcePrecision::MIXED, config);
+
+    double forceSq = 0.0, energySq = 0.0;
+    size_t forceSamples = 0, energySamples = 0;
+    for (size_t i = 0; i < count; ++i) {
+        Vec3 a(r[i], r[count + i], r[2 * count + i]);
+        Vec3 da = Vec3(m[i], m[count + i], m[2 * count + i]) - a;
+        double magnitude = a.magnitude();
+        if (magnitude > 0.0) {
+            double e = da.magnitude() / magnitude;
+            report.maxForceError = std::max(report.maxForceError, e);
+            forceSq += e * e;
+            ++forceSamples;
+        }
+
+        double phi = r[3 * count + i];
+        if (phi != 0.0) {
+            double e = std::abs(m[3 * count + i] - phi) / std::abs(phi);
+            report.maxEnergyError = std::max(report.maxEnergyError, e);
+            energySq += e * e;
+            ++energySamples;
+        }
+    }
+    if (forceSamples) report.rmsForceError = std::sqrt(forceSq / forceSamples);
+    if (energySamples) report.rmsEnergyError = std::sqrt(energySq / energySamples);
+    return report;
+}
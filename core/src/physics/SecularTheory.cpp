@@ -0,0 +1,340 @@
+#include "../../include/physics/SecularTheory.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+    using Complex = std::complex<double>;
+    constexpr double TWO_PI = 2.0 * M_PI;
+
+    double wrapPositive(double angle) {
+        angle = std::fmod(angle, TWO_PI);
+        return angle < 0.0 ? angle + TWO_PI : angle;
+    }
+
+    // Eigen-decomposition of a symmetric n x n matrix (row-major) by cyclic
+    // Jacobi rotations; eigenvectors are the columns of vectors
+    void jacobiEigen(std::vector<double> m, size_t n, std::vector<double>& values, std::vector<double>& vectors) {
+        vectors.assign(n * n, 0.0);
+        for (size_t i = 0; i < n; ++i) vectors[i * n + i] = 1.0;
+
+        for (int sweep = 0; sweep < 100; ++sweep) {
+            double off = 0.0, scale = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                scale += m[i * n + i] * m[i * n + i];
+                for (size_t j = i + 1; j < n; ++j) off += m[i * n + j] * m[i * n + j];
+            }
+            if (off <= 1e-30 * scale) break;
+
+            for (size_t p = 0; p < n; ++p) {
+                for (size_t q = p + 1; q < n; ++q) {
+                    double apq = m[p * n + q];
+                    if (apq == 0.0) continue;
+                    double theta = (m[q * n + q] - m[p * n + p]) / (2.0 * apq);
+                    double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                    double c = 1.0 / std::sqrt(t * t + 1.0);
+                    double s = t * c;
+                    for (size_t k = 0; k < n; ++k) {
+                        double mkp = m[k * n + p], mkq = m[k * n + q];
+                        m[k * n + p] = c * mkp - s * mkq;
+                        m[k * n + q] = s * mkp + c * mkq;
+                    }
+                    for (size_t k = 0; k < n; ++k) {
+                        double mpk = m[p * n + k], mqk = m[q * n + k];
+                        m[p * n + k] = c * mpk - s * mqk;
+                        m[q * n + k] = s * mpk + c * mqk;
+                    }
+                    for (size_t k = 0; k < n; ++k) {
+                        double vkp = vectors[k * n + p], vkq = vectors[k * n + q];
+                        vectors[k * n + p] = c * vkp - s * vkq;
+                        vectors[k * n + q] = s * vkp + c * vkq;
+                    }
+                }
+            }
+        }
+        values.resize(n);
+        for (size_t i = 0; i < n; ++i) values[i] = m[i * n + i];
+    }
+
+    // alpha * alpha-bar of body j perturbed by body k (M&D 7.128): the
+    // perturber's own term carries an extra alpha when it is the outer one
+    double alphaFactor(double aj, double ak, double& alpha) {
+        alpha = std::min(aj, ak) / std::max(aj, ak);
+        return aj < ak ? alpha * alpha : alpha;
+    }
+
+    Complex eccentricityVector(const OrbitalElements& e) {
+        return std::polar(e.eccentricity, e.longitudeOfAscNode + e.argumentOfPeriapsis);
+    }
+
+    Complex inclinationVector(const OrbitalElements& e) {
+        return std::polar(std::sin(e.inclination), e.longitudeOfAscNode);
+    }
+}
+
+namespace SecularTheory {
+
+    double laplaceCoefficient(double s, int j, double alpha) {
+        // Periodic analytic integrand: the trapezoid rule converges
+        // geometrically, so double the points until it settles
+        auto trapezoid = [&](size_t points) {
+            double sum = 0.0;
+            for (size_t k = 0; k < points; ++k) {
+                double psi = TWO_PI * static_cast<double>(k) / static_cast<double>(points);
+                sum += std::cos(j * psi) / std::pow(1.0 - 2.0 * alpha * std::cos(psi) + alpha * alpha, s);
+            }
+            return 2.0 * sum / static_cast<double>(points);
+        };
+        double value = trapezoid(64);
+        for (size_t points = 128; points <= (size_t(1) << 20); points *= 2) {
+            double refined = trapezoid(points);
+            bool settled = std::abs(refined - value) <= 1e-13 * std::abs(refined);
+            value = refined;
+            if (settled) break;
+        }
+        return value;
+    }
+}
+
+/*--- Setup ---*/
+
+bool SecularSystem::build(double starMass_, const std::vector<SecularBody>& perturbers,
+                          const std::vector<SecularBody>& minorBodies, double time,
+                          const SecularConfig& config_, std::string* error) {
+    if (perturbers.empty()) {
+        if (error) *error = "secular model needs at least one perturber";
+        return false;
+    }
+    config = config_;
+    epoch = time;
+    starMass = starMass_;
+    perturberCount = perturbers.size();
+
+    ids.clear();
+    masses.clear();
+    initial.clear();
+    meanMotion.clear();
+    meanLongitude.clear();
+    for (const auto* group : {&perturbers, &minorBodies}) {
+        for (const SecularBody& body : *group) {
+            const OrbitalElements& e = body.orbit.getElements();
+            if (e.eccentricity >= 1.0 || e.semiMajorAxis <= 0.0) {
+                if (error) *error = "body " + std::to_string(body.id) + " is not on a bound orbit";
+                return false;
+            }
+            double n = body.orbit.getMeanMotion();
+            ids.push_back(body.id);
+            masses.push_back(body.mass);
+            initial.push_back(body.orbit);
+            meanMotion.push_back(n);
+            meanLongitude.push_back(e.meanAnomaly + n * (time - e.epoch) + e.longitudeOfAscNode + e.argumentOfPeriapsis);
+        }
+    }
+
+    /*--- Perturber matrices ---*/
+    const size_t P = perturberCount;
+    std::vector<double> A(P * P, 0.0), B(P * P, 0.0);
+    for (size_t j = 0; j < P; ++j) {
+        double aj = initial[j].getElements().semiMajorAxis;
+        for (size_t k = 0; k < P; ++k) {
+            if (k == j) continue;
+            double ak = initial[k].getElements().semiMajorAxis;
+            if (aj == ak) {
+                if (error) *error = "bodies " + std::to_string(ids[j]) + " and " + std::to_string(ids[k]) +
+                                    " share a semi-major axis";
+                return false;
+            }
+            double alpha;
+            double f = 0.25 * meanMotion[j] * masses[k] / (starMass + masses[j]) * alphaFactor(aj, ak, alpha);
+            double b1 = SecularTheory::laplaceCoefficient(1.5, 1, alpha);
+            double b2 = SecularTheory::laplaceCoefficient(1.5, 2, alpha);
+            A[j * P + j] += f * b1;
+            A[j * P + k] = -f * b2;
+            B[j * P + j] -= f * b1;
+            B[j * P + k] = f * b1;
+        }
+    }
+
+    // Scaling by sqrt(m n a^2) makes both symmetric; modes are then orthogonal
+    std::vector<double> weight(P);
+    for (size_t j = 0; j < P; ++j) {
+        double a = initial[j].getElements().semiMajorAxis;
+        weight[j] = std::sqrt(masses[j] * meanMotion[j] * a * a);
+    }
+    auto diagonalize = [&](const std::vector<double>& M, std::vector<double>& frequency,
+                           std::vector<Complex>& amplitude, Complex (*vectorOf)(const OrbitalElements&)) {
+        std::vector<double> C(P * P);
+        for (size_t j = 0; j < P; ++j) {
+            for (size_t k = 0; k < P; ++k) {
+                double cjk = weight[j] * M[j * P + k] / weight[k];
+                double ckj = weight[k] * M[k * P + j] / weight[j];
+                C[j * P + k] = 0.5 * (cjk + ckj);
+            }
+        }
+        std::vector<double> Q;
+        jacobiEigen(C, P, frequency, Q);
+
+        // Modal amplitudes c = Q^T D z0, body amplitudes D^-1 Q c
+        amplitude.assign(ids.size() * P, Complex());
+        for (size_t i = 0; i < P; ++i) {
+            Complex c;
+            for (size_t j = 0; j < P; ++j) c += Q[j * P + i] * weight[j] * vectorOf(initial[j].getElements());
+            for (size_t j = 0; j < P; ++j) amplitude[j * P + i] = Q[j * P + i] / weight[j] * c;
+        }
+    };
+    diagonalize(A, eccentricityFrequency, eccentricityAmplitude, eccentricityVector);
+    diagonalize(B, inclinationFrequency, inclinationAmplitude, inclinationVector);
+
+    /*--- Minor bodies: free oscillation plus the response to each mode ---*/
+    freeEccentricityFrequency.assign(ids.size(), 0.0);
+    freeInclinationFrequency.assign(ids.size(), 0.0);
+    freeEccentricity.assign(ids.size(), Complex());
+    freeInclination.assign(ids.size(), Complex());
+    nearResonance.assign(ids.size(), false);
+    for (size_t p = P; p < ids.size(); ++p) {
+        double ap = initial[p].getElements().semiMajorAxis;
+        double Ap = 0.0;
+        std::vector<double> Aj(P), Bj(P);
+        for (size_t j = 0; j < P; ++j) {
+            double aj = initial[j].getElements().semiMajorAxis;
+            double alpha;
+            double f = 0.25 * meanMotion[p] * masses[j] / starMass * alphaFactor(ap, aj, alpha);
+            double b1 = SecularTheory::laplaceCoefficient(1.5, 1, alpha);
+            Ap += f * b1;
+            Aj[j] = -f * SecularTheory::laplaceCoefficient(1.5, 2, alpha);
+            Bj[j] = f * b1;
+        }
+        const double Bp = -Ap;
+        freeEccentricityFrequency[p] = Ap;
+        freeInclinationFrequency[p] = Bp;
+
+        Complex z = eccentricityVector(initial[p].getElements());
+        Complex zeta = inclinationVector(initial[p].getElements());
+        for (size_t i = 0; i < P; ++i) {
+            Complex forcingE, forcingI;
+            for (size_t j = 0; j < P; ++j) {
+                forcingE += Aj[j] * eccentricityAmplitude[j * P + i];
+                forcingI += Bj[j] * inclinationAmplitude[j * P + i];
+            }
+            double gapE = eccentricityFrequency[i] - Ap;
+            double gapI = inclinationFrequency[i] - Bp;
+            if (std::abs(gapE) <= config.resonanceMargin * std::abs(Ap) ||
+                std::abs(gapI) <= config.resonanceMargin * std::abs(Bp)) {
+                nearResonance[p] = true;
+            }
+            eccentricityAmplitude[p * P + i] = forcingE / gapE;
+            inclinationAmplitude[p * P + i] = forcingI / gapI;
+            z -= eccentricityAmplitude[p * P + i];
+            zeta -= inclinationAmplitude[p * P + i];
+        }
+        freeEccentricity[p] = z;
+        freeInclination[p] = zeta;
+    }
+    return true;
+}
+
+/*--- Evaluation ---*/
+
+void SecularSystem::evaluate(double time, std::vector<OrbitalElements>& out) const {
+    const size_t P = perturberCount;
+    const double dt = time - epoch;
+    std::vector<Complex> rotation(2 * P);
+    for (size_t i = 0; i < P; ++i) {
+        rotation[i] = std::polar(1.0, eccentricityFrequency[i] * dt);
+        rotation[P + i] = std::polar(1.0, inclinationFrequency[i] * dt);
+    }
+
+    out.resize(ids.size());
+    for (size_t b = 0; b < ids.size(); ++b) {
+        Complex z, zeta;
+        for (size_t i = 0; i < P; ++i) {
+            z += eccentricityAmplitude[b * P + i] * rotation[i];
+            zeta += inclinationAmplitude[b * P + i] * rotation[P + i];
+        }
+        if (b >= P) {
+            z += freeEccentricity[b] * std::polar(1.0, freeEccentricityFrequency[b] * dt);
+            zeta += freeInclination[b] * std::polar(1.0, freeInclinationFrequency[b] * dt);
+        }
+
+        OrbitalElements& e = out[b];
+        e.semiMajorAxis = initial[b].getElements().semiMajorAxis;
+        // A runaway forced solution (near resonance) still has to be an ellipse
+        e.eccentricity = std::min(std::abs(z), 0.999);
+        e.inclination = std::asin(std::min(std::abs(zeta), 1.0));
+        double perihelion = std::arg(z);
+        e.longitudeOfAscNode = wrapPositive(std::arg(zeta));
+        e.argumentOfPeriapsis = wrapPositive(perihelion - e.longitudeOfAscNode);
+        e.meanAnomaly = wrapPositive(meanLongitude[b] + meanMotion[b] * dt - perihelion);
+        e.epoch = time;
+        Orbit orbit(e, initial[b].getCentralMass());
+        e.trueAnomaly = orbit.eccentricToTrueAnomaly(orbit.solveKeplerEquation(e.meanAnomaly));
+    }
+}
+
+SecularErrorReport SecularSystem::compareWithDirect(double horizon, double dt, size_t samples,
+                                                     IntegrationMethod method) const {
+    SecularErrorReport report;
+    report.horizon = horizon;
+    report.samples = samples;
+    report.ids = ids;
+    report.eccentricityError.assign(ids.size(), 0.0);
+    report.inclinationError.assign(ids.size(), 0.0);
+    if (samples == 0 || horizon <= 0.0 || dt <= 0.0) return report;
+
+    // Star first, minor bodies massless as in the theory
+    std::vector<BodyState> bodies(ids.size() + 1);
+    bodies[0].id = -1;
+    bodies[0].mass = starMass;
+    for (size_t b = 0; b < ids.size(); ++b) {
+        BodyState& s = bodies[b + 1];
+        s.id = ids[b];
+        s.mass = b < perturberCount ? masses[b] : 0.0;
+        initial[b].getStateAtTime(epoch, s.position, s.velocity);
+    }
+    Vec3 com = IntegratorUtils::computeCenterOfMass(bodies);
+    Vec3 comVelocity = IntegratorUtils::computeCenterOfMassVelocity(bodies);
+    for (auto& s : bodies) {
+        s.position -= com;
+        s.velocity -= comVelocity;
+    }
+    EnsembleState ensemble = EnsembleState::broadcast(bodies, 1);
+
+    const double interval = horizon / static_cast<double>(samples);
+    const uint64_t stepsPerSample = static_cast<uint64_t>(std::ceil(interval / dt));
+    const double h = interval / static_cast<double>(stepsPerSample);
+    std::vector<OrbitalElements> secular;
+    using Clock = std::chrono::steady_clock;
+
+    for (size_t k = 1; k <= samples; ++k) {
+        auto start = Clock::now();
+        for (uint64_t s = 0; s < stepsPerSample; ++s) Integrator::stepEnsemble(ensemble, h, method);
+        auto direct = Clock::now();
+        evaluate(epoch + interval * static_cast<double>(k), secular);
+        auto end = Clock::now();
+        report.directSeconds += std::chrono::duration<double>(direct - start).count();
+        report.secularSeconds += std::chrono::duration<double>(end - direct).count();
+
+        Vec3 starPosition(ensemble.px[0], ensemble.py[0], ensemble.pz[0]);
+        Vec3 starVelocity(ensemble.vx[0], ensemble.vy[0], ensemble.vz[0]);
+        for (size_t b = 0; b < ids.size(); ++b) {
+            size_t i = b + 1;
+            Vec3 r = Vec3(ensemble.px[i], ensemble.py[i], ensemble.pz[i]) - starPosition;
+            Vec3 v = Vec3(ensemble.vx[i], ensemble.vy[i], ensemble.vz[i]) - starVelocity;
+            OrbitalElements osculating = OrbitUtils::stateToElements(r, v, initial[b].getMu());
+            double de = std::abs(eccentricityVector(osculating) - eccentricityVector(secular[b]));
+            double di = std::abs(inclinationVector(osculating) - inclinationVector(secular[b]));
+            report.eccentricityError[b] = std::max(report.eccentricityError[b], de);
+            report.inclinationError[b] = std::max(report.inclinationError[b], di);
+        }
+    }
+
+    for (size_t b = 0; b < ids.size(); ++b) {
+        if (report.eccentricityError[b] > report.maxEccentricityError) {
+            report.maxEccentricityError = report.eccentricityError[b];
+            report.worstBodyId = ids[b];
+        }
+        report.maxInclinationError = std::max(report.maxInclinationError, report.inclinationError[b]);
+    }
+    return report;
+}
@@ -0,0 +1,87 @@
+#include "../../include/simulation/EnsembleRunner.h"
+#include "../../include/simulation/WorkStealingPool.h"
+#include <algorithm>
+#include <mutex>
+
+RunRecord EnsembleRunner::runSingle(const SolarSystem& base, size_t runIndex) const {
+    SolarSystem system = base.clone();
+
+    // Stars get their own stream so perturbation draws don't shift flare draws
+    CounterRng rng(CounterRng::mixSeed(config.seed, RandomDomain::PERTURBATION), runIndex);
+    if (system.getStar()) system.getStar()->seedRandomStream(config.seed, runIndex);
+
+    if (perturbation) perturbation(system, rng, runIndex);
+
+    for (uint64_t s = 0; s < config.stepsPerRun; ++s) {
+        system.step();
+    }
+
+    RunRecord record(runIndex);
+    if (observer) observer(system, record);
+    return record;
+}
+
+EnsembleSummary EnsembleRunner::run(const SolarSystem& base) const {
+    WorkStealingPool pool(config.threadCount);
+    std::vector<EnsembleSummary> perWorker(pool.getThreadCount());
+    std::mutex callbackMutex;
+
+    pool.parallelFor(config.runCount, config.runsPerChunk,
+        [&](size_t begin, size_t end, unsigned worker) {
+            for (size_t run = begin; run < end; ++run) {
+                RunRecord record = runSingle(base, run);
+                perWorker[worker].add(record);
+
+                if (runCallback) {
+                    std::lock_guard<std::mutex> lock(callbackMutex);
+                    runCallback(record);
+                }
+            }
+        });
+
+    EnsembleSummary summary;
+    for (const auto& partial : perWorker) summary.merge(partial);
+    return summary;
+}
+
+namespace EnsemblePerturbations {
+
+    EnsembleRunner::Perturbation jitterOrbits(double sigmaSemiMajorRel, double sigmaEccentricity,
+                                              double sigmaAngle) {
+        return [=](SolarSystem& system, CounterRng& rng, size_t) {
+            // unordered_map order is not stable across builds; visit by id
+            std::vector<int> ids;
+            for (const auto& [id, orbit] : system.getOrbits()) ids.push_back(id);
+            std::sort(ids.begin(), ids.end());
+
+            for (int id : ids) {
+                Orbit& orbit = system.getOrbits().at(id);
+                OrbitalElements e = orbit.getElements();
+                e.semiMajorAxis *= 1.0 + rng.normal(0.0, sigmaSemiMajorRel);
+                e.eccentricity = std::clamp(e.eccentricity + rng.normal(0.0, sigmaEccentricity), 0.0, 0.99);
+                e.inclination += rng.normal(0.0, sigmaAngle);
+                e.longitudeOfAscNode += rng.normal(0.0, sigmaAngle);
+                e.argumentOfPeriapsis += rng.normal(0.0, sigmaAngle);
+                e.meanAnomaly += rng.normal(0.0, sigmaAngle);
+                orbit.setElements(e);
+            }
+        };
+    }
+
+    EnsembleRunner::Perturbation jitterStates(double sigmaPosition, double sigmaVelocity) {
+        return [=](SolarSystem& system, CounterRng& rng, size_t) {
+            for (auto& state : system.getBodyStates()) {
+                state.position += Vec3(rng.normal(), rng.normal(), rng.normal()) * sigmaPosition;
+                state.velocity += Vec3(rng.normal(), rng.normal(), rng.normal()) * sigmaVelocity;
+            }
+        };
+    }
+
+    EnsembleRunner::Perturbation combine(std::vector<EnsembleRunner::Perturbation> parts) {
+        return [parts = std::move(parts)](SolarSystem& system, CounterRng& rng, size_t run) {
+            for (const auto& part : parts) {
+                if (part) part(system, rng, run);
+            }
+        };
+    }
+}
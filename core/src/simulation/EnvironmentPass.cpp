@@ -0,0 +1,151 @@
+#include "../../include/simulation/EnvironmentPass.h"
+#include "../../include/simulation/SolarSystem.h"
+#include "../../include/diagnostics/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    // Irradiance and coma over dense arrays. Seven streams exceed GCC's runtime
+    // alias-check budget, so the pointers are restrict-qualified parameters.
+    void distanceKernel(size_t n, const double* __restrict x, const double* __restrict y,
+                        const double* __restrict z, double irradianceAtUnitDistance,
+                        double cutoff, double comaScale, const double* __restrict nucleus,
+                        double* __restrict dist, double* __restrict irr, double* __restrict coma) {
+        for (size_t i = 0; i < n; ++i) {
+            double r2 = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+
+            // Star::irradianceAtDistance, with its r < 1e-10 guard written as a
+            // select after unconditional math (a conditional sqrt/divide stays scalar)
+            bool atCenter = r2 < 1e-20;
+            double safe2 = atCenter ? 1.0 : r2;
+            double r = std::sqrt(safe2);
+            double flux = irradianceAtUnitDistance / safe2;
+            r = atCenter ? 0.0 : r;
+            dist[i] = r;
+            irr[i] = atCenter ? 0.0 : flux;
+
+            // estimateComaRadius; nucleus radius is 0 for non-comets
+            double reach = cutoff - r;
+            coma[i] = nucleus[i] * (reach > 0.0 ? reach : 0.0) * comaScale;
+        }
+    }
+}
+
+bool EnvironmentPass::layoutMatches(const SolarSystem& system) const {
+    const auto& states = system.getBodyStates();
+    if (states.size() != ids.size()) return false;
+    for (size_t i = 0; i < states.size(); ++i) {
+        if (states[i].id != ids[i]) return false;
+    }
+    return true;
+}
+
+void EnvironmentPass::rebuild(const SolarSystem& system) {
+    const auto& states = system.getBodyStates();
+    size_t n = states.size();
+
+    ids.resize(n);
+    for (size_t i = 0; i < n; ++i) ids[i] = states[i].id;
+
+    px.assign(n, 0.0);
+    py.assign(n, 0.0);
+    pz.assign(n, 0.0);
+    distance.assign(n, 0.0);
+    irradiance.assign(n, 0.0);
+    comaRadius.assign(n, 0.0);
+    nucleusRadius.assign(n, 0.0);
+    isComet.assign(n, 0);
+    comets.assign(n, nullptr);
+
+    for (const auto& comet : system.getComets()) {
+        auto it = std::find(ids.begin(), ids.end(), comet->getId());
+        if (it == ids.end()) continue;
+        size_t i = static_cast<size_t>(it - ids.begin());
+        isComet[i] = 1;
+        nucleusRadius[i] = comet->getCometHeadRadius();
+        comets[i] = comet.get();
+    }
+
+    // Start from the bodies' own flags so the first pass only reports real changes
+    activeTail.assign(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        if (comets[i]) activeTail[i] = comets[i]->hasActiveTailNow() ? 1 : 0;
+    }
+    previousTail = activeTail;
+}
+
+void EnvironmentPass::compute(const double* x, const double* y, const double* z,
+                              double irradianceAtUnitDistance, double time) {
+    SOLARSYS_PROFILE_SCOPE(ENVIRONMENT);
+    const size_t n = ids.size();
+
+    const double on = CometActivity::TAIL_ACTIVATION_AU * PhysicsConstants::AU;
+    const double off = on * (1.0 + hysteresis);
+    const double cutoff = CometActivity::COMA_CUTOFF_AU * PhysicsConstants::AU;
+    const double comaScale = CometActivity::MAX_COMA_SCALE / cutoff;
+
+    std::copy(activeTail.begin(), activeTail.end(), previousTail.begin());
+
+    distanceKernel(n, x, y, z, irradianceAtUnitDistance, cutoff, comaScale, nucleusRadius.data(),
+                   distance.data(), irradiance.data(), comaRadius.data());
+
+    const double* dist = distance.data();
+    const uint8_t* comet = isComet.data();
+    uint8_t* tail = activeTail.data();
+
+    // shouldHaveActiveTail with hysteresis: on inside `on`, stays on until `off`.
+    // Kept apart from the double loop; mixing byte and double lanes stops GCC vectorizing
+    for (size_t i = 0; i < n; ++i) {
+        int inside = dist[i] < on;
+        int keep = (tail[i] != 0) & (dist[i] <= off);
+        tail[i] = static_cast<uint8_t>((comet[i] != 0) & (inside | keep));
+    }
+
+    events.clear();
+    for (size_t i = 0; i < n; ++i) {
+        if (activeTail[i] == previousTail[i]) continue;
+        EnvironmentEvent event;
+        event.type = activeTail[i] ? EnvironmentEvent::Type::TAIL_ACTIVATED : EnvironmentEvent::Type::TAIL_DEACTIVATED;
+        event.bodyId = ids[i];
+        event.time = time;
+        event.distance = distance[i];
+        events.push_back(event);
+    }
+}
+
+bool EnvironmentPass::update(SolarSystem& system) {
+    uint64_t tick = system.getTimeSystem().getTickCount();
+    if (hasRun && tick - lastTick < interval) return false;
+    hasRun = true;
+    lastTick = tick;
+
+    if (system.isUsingKeplerianOrbits()) system.syncBodyStatesFromOrbits();
+    if (!layoutMatches(system)) rebuild(system);
+
+    const auto& states = system.getBodyStates();
+    const Star* star = system.getStar();
+    Vec3 sun;
+    for (const auto& s : states) {
+        if (star && s.id == star->getId()) sun = s.position;
+    }
+
+    for (size_t i = 0; i < states.size(); ++i) {
+        px[i] = states[i].position.x - sun.x;
+        py[i] = states[i].position.y - sun.y;
+        pz[i] = states[i].position.z - sun.z;
+    }
+
+    double unitIrradiance = star ? star->irradianceAtDistance(1.0) : 0.0;
+    compute(px.data(), py.data(), pz.data(), unitIrradiance, system.getTimeSystem().getCurrentTime());
+
+    for (size_t i = 0; i < comets.size(); ++i) {
+        if (!comets[i]) continue;
+        comets[i]->setComaRadius(comaRadius[i]);
+        comets[i]->setHasActiveTail(activeTail[i] != 0);
+    }
+    if (listener) {
+        for (const auto& event : events) listener(event);
+    }
+    return true;
+}
@@ -0,0 +1,46 @@
+#include "../../include/simulation/KeyframeHistory.h"
+#include <algorithm>
+
+void KeyframeHistory::store(Keyframe frame) {
+    auto it = std::lower_bound(keyframes.begin(), keyframes.end(), frame.tick,
+                               [](const Keyframe& k, uint64_t tick) { return k.tick < tick; });
+    if (it != keyframes.end() && it->tick == frame.tick) *it = std::move(frame);
+    else keyframes.insert(it, std::move(frame));
+}
+
+void KeyframeHistory::truncateAfter(uint64_t tick) {
+    auto it = std::upper_bound(keyframes.begin(), keyframes.end(), tick,
+                               [](uint64_t t, const Keyframe& k) { return t < k.tick; });
+    keyframes.erase(it, keyframes.end());
+}
+
+const Keyframe* KeyframeHistory::findBefore(double time) const {
+    if (keyframes.empty()) return nullptr;
+    auto it = std::upper_bound(keyframes.begin(), keyframes.end(), time,
+                               [](double t, const Keyframe& k) { return t < k.clock.getCurrentTime(); });
+    return it == keyframes.begin() ? &keyframes.front() : &*(it - 1);
+}
+
+const Keyframe* KeyframeHistory::findAfter(uint64_t tick) const {
+    auto it = std::upper_bound(keyframes.begin(), keyframes.end(), tick,
+                               [](uint64_t t, const Keyframe& k) { return t < k.tick; });
+    return it == keyframes.end() ? nullptr : &*it;
+}
+
+std::shared_ptr<const std::unordered_map<int, Orbit>> KeyframeHistory::reusableOrbits(uint64_t generation) const {
+    if (keyframes.empty() || keyframes.back().orbitGeneration != generation) return nullptr;
+    return keyframes.back().orbits;
+}
+
+size_t KeyframeHistory::memoryBytes() const {
+    size_t bytes = keyframes.capacity() * sizeof(Keyframe);
+    const std::unordered_map<int, Orbit>* lastOrbits = nullptr;
+    for (const Keyframe& k : keyframes) {
+        bytes += k.states.capacity() * sizeof(BodyState);
+        if (k.orbits && k.orbits.get() != lastOrbits) {
+            bytes += k.orbits->size() * (sizeof(int) + sizeof(Orbit));
+            lastOrbits = k.orbits.get();
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,189 @@
+#include "../../include/simulation/OrbitEventScheduler.h"
+#include "../../include/simulation/SolarSystem.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    constexpr double MIN_SIN_INCLINATION = 1e-10;
+    constexpr double MIN_ECCENTRICITY = 1e-10;
+
+    constexpr OrbitEventType FIXED_TYPES[] = {
+        OrbitEventType::PERIAPSIS, OrbitEventType::APOAPSIS,
+        OrbitEventType::ASCENDING_NODE, OrbitEventType::DESCENDING_NODE
+    };
+
+    // True anomaly of a fixed-geometry event; false if the orbit never has it
+    bool fixedAnomaly(const OrbitalElements& e, OrbitEventType type, double& nu) {
+        switch (type) {
+            case OrbitEventType::PERIAPSIS:
+                nu = 0.0;
+                return true;
+            case OrbitEventType::APOAPSIS:
+                nu = M_PI;
+                return e.eccentricity < 1.0;
+            case OrbitEventType::ASCENDING_NODE:
+                nu = -e.argumentOfPeriapsis;
+                return std::abs(std::sin(e.inclination)) > MIN_SIN_INCLINATION;
+            case OrbitEventType::DESCENDING_NODE:
+                nu = M_PI - e.argumentOfPeriapsis;
+                return std::abs(std::sin(e.inclination)) > MIN_SIN_INCLINATION;
+            default:
+                return false;
+        }
+    }
+}
+
+/*--- Watches ---*/
+
+void OrbitEventScheduler::watch(int bodyId, uint32_t mask) {
+    watches[bodyId].mask |= mask;
+    dirty.push_back(bodyId);
+}
+
+void OrbitEventScheduler::watchDistance(int bodyId, double distance, bool inbound, bool outbound) {
+    if (!(distance > 0.0) || (!inbound && !outbound)) return;
+    watches[bodyId].distances.push_back(DistanceWatch{distance, inbound, outbound});
+    dirty.push_back(bodyId);
+}
+
+void OrbitEventScheduler::watchCometActivity(const SolarSystem& system) {
+    for (const auto& comet : system.getComets()) {
+        watchDistance(comet->getId(), CometActivity::TAIL_ACTIVATION_AU * PhysicsConstants::AU);
+    }
+}
+
+void OrbitEventScheduler::unwatch(int bodyId) {
+    // Queued entries become stale because their watch is gone
+    watches.erase(bodyId);
+}
+
+void OrbitEventScheduler::clear() {
+    watches.clear();
+    queue = decltype(queue)();
+    dirty.clear();
+}
+
+/*--- Prediction ---*/
+
+void OrbitEventScheduler::rebuild(const SolarSystem& system) {
+    queue = decltype(queue)();
+    dirty.clear();
+    double now = system.getTimeSystem().getCurrentTime();
+    for (const auto& [id, w] : watches) predictBody(system, id, now);
+    seenGeneration = system.getOrbitGeneration();
+    seenSecularRevision = system.getSecularRevision();
+    primed = true;
+}
+
+void OrbitEventScheduler::invalidate(const SolarSystem& system, int bodyId) {
+    sync(system);
+    if (watches.count(bodyId)) predictBody(system, bodyId, system.getTimeSystem().getCurrentTime());
+}
+
+void OrbitEventScheduler::sync(const SolarSystem& system) {
+    if (!primed || system.getOrbitGeneration() != seenGeneration ||
+        system.getSecularRevision() != seenSecularRevision) {
+        rebuild(system);
+        return;
+    }
+    if (dirty.empty()) return;
+
+    std::sort(dirty.begin(), dirty.end());
+    dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+    double now = system.getTimeSystem().getCurrentTime();
+    for (int id : dirty) {
+        if (watches.count(id)) predictBody(system, id, now);
+    }
+    dirty.clear();
+}
+
+void OrbitEventScheduler::predictBody(const SolarSystem& system, int bodyId, double after) {
+    Watch& w = watches.at(bodyId);
+    w.version = ++versionCounter;
+
+    for (OrbitEventType type : FIXED_TYPES) {
+        if (w.mask & OrbitEventMask::bit(type)) schedule(system, bodyId, w, type, -1, after);
+    }
+    for (size_t k = 0; k < w.distances.size(); ++k) {
+        int32_t index = static_cast<int32_t>(k);
+        if (w.distances[k].inbound) schedule(system, bodyId, w, OrbitEventType::DISTANCE_INBOUND, index, after);
+        if (w.distances[k].outbound) schedule(system, bodyId, w, OrbitEventType::DISTANCE_OUTBOUND, index, after);
+    }
+}
+
+void OrbitEventScheduler::schedule(const SolarSystem& system, int bodyId, const Watch& w,
+                                   OrbitEventType type, int32_t distanceIndex, double after) {
+    auto it = system.getOrbits().find(bodyId);
+    if (it == system.getOrbits().end()) return;
+    const Orbit& orbit = it->second;
+    const OrbitalElements& e = orbit.getElements();
+
+    double nu;
+    if (distanceIndex >= 0) {
+        // r = p / (1 + e cos nu) solved for nu; outbound crossings have nu in (0, pi)
+        if (e.eccentricity < MIN_ECCENTRICITY) return;
+        double p = e.semiMajorAxis * (1.0 - e.eccentricity * e.eccentricity);
+        double cosNu = (p / w.distances[distanceIndex].distance - 1.0) / e.eccentricity;
+        if (cosNu < -1.0 || cosNu > 1.0) return;
+        nu = std::acos(cosNu);
+        if (type == OrbitEventType::DISTANCE_INBOUND) nu = -nu;
+    } else if (!fixedAnomaly(e, type, nu)) {
+        return;
+    }
+
+    double time;
+    if (!orbit.nextTimeAtTrueAnomaly(nu, after, time)) return;
+    queue.push(Entry{time, bodyId, type, distanceIndex, w.version});
+}
+
+void OrbitEventScheduler::dropStale() {
+    while (!queue.empty()) {
+        const Entry& top = queue.top();
+        auto it = watches.find(top.bodyId);
+        if (it != watches.end() && it->second.version == top.version) return;
+        queue.pop();
+    }
+}
+
+/*--- Queries ---*/
+
+bool OrbitEventScheduler::peek(const SolarSystem& system, OrbitEvent& out) {
+    sync(system);
+    dropStale();
+    if (queue.empty()) return false;
+
+    const Entry& top = queue.top();
+    out.type = top.type;
+    out.bodyId = top.bodyId;
+    out.time = top.time;
+    out.distance = top.distanceIndex >= 0 ? watches.at(top.bodyId).distances[top.distanceIndex].distance : 0.0;
+    return true;
+}
+
+bool OrbitEventScheduler::pop(const SolarSystem& system, OrbitEvent& out) {
+    if (!peek(system, out)) return false;
+
+    Entry top = queue.top();
+    queue.pop();
+    schedule(system, top.bodyId, watches.at(top.bodyId), top.type, top.distanceIndex, top.time);
+    return true;
+}
+
+/*--- Event-driven time advance ---*/
+
+size_t OrbitEventScheduler::advanceTo(SolarSystem& system, double endTime, const Listener& onEvent) {
+    if (!system.isUsingKeplerianOrbits()) return 0;
+
+    TimeSystem& clock = system.getTimeSystem();
+    size_t delivered = 0;
+    OrbitEvent event;
+    while (peek(system, event) && event.time <= endTime) {
+        pop(system, event);
+        clock.setCurrentTime(event.time);
+        if (onEvent) onEvent(event);
+        ++delivered;
+    }
+    if (clock.getCurrentTime() < endTime) clock.setCurrentTime(endTime);
+    return delivered;
+}
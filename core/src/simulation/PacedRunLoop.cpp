@@ -0,0 +1,116 @@
+#include "../../include/simulation/PacedRunLoop.h"
+#include "../../include/simulation/SolarSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace {
+    constexpr double METRIC_SMOOTHING = 0.1;
+
+    double steadySeconds() {
+        using namespace std::chrono;
+        return duration<double>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    void sleepSeconds(double seconds) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    }
+
+    double smooth(double average, double sample, uint64_t count) {
+        return count <= 1 ? sample : average + METRIC_SMOOTHING * (sample - average);
+    }
+}
+
+PacedRunLoop::PacedRunLoop(StepFunc step, double stepSeconds_, double simRate_)
+    : stepFunc(std::move(step)), clock(steadySeconds), sleeper(sleepSeconds),
+      stepSeconds(stepSeconds_ > 0.0 ? stepSeconds_ : 1.0), simRate(std::max(0.0, simRate_)),
+      maxStepsPerFrame(8), targetFrameSeconds(1.0 / 60.0), paused(false),
+      accumulator(0.0), lastFrameTime(0.0), started(false) {}
+
+PacedRunLoop PacedRunLoop::forSystem(SolarSystem& system, double simRate_) {
+    const TimeSystem& time = system.getTimeSystem();
+    return PacedRunLoop([&system]() { system.step(); },
+                        time.getTimeStep() * time.getTimeScale(), simRate_);
+}
+
+PacedRunLoop::FrameResult PacedRunLoop::runFrame() {
+    FrameResult result;
+    double now = clock();
+    double elapsed = started ? std::max(0.0, now - lastFrameTime) : 0.0;
+    lastFrameTime = now;
+    started = true;
+
+    ++metrics.frames;
+    metrics.lastFrameSeconds = elapsed;
+    metrics.avgFrameSeconds = smooth(metrics.avgFrameSeconds, elapsed, metrics.frames);
+    metrics.maxFrameSeconds = std::max(metrics.maxFrameSeconds, elapsed);
+
+    if (paused) {
+        result.alpha = getAlpha();
+        return result;
+    }
+
+    accumulator += elapsed * simRate;
+    double pending = std::floor(accumulator / stepSeconds);
+    metrics.stepLag = pending;
+
+    uint32_t steps = static_cast<uint32_t>(std::min<double>(pending, maxStepsPerFrame));
+    if (pending > maxStepsPerFrame) {
+        // Spiral-of-death guard: forget the backlog instead of chasing it
+        metrics.droppedSteps += static_cast<uint64_t>(pending) - maxStepsPerFrame;
+        accumulator = std::fmod(accumulator, stepSeconds) + maxStepsPerFrame * stepSeconds;
+        result.capped = true;
+    }
+
+    double stepStart = steps > 0 ? clock() : 0.0;
+    for (uint32_t s = 0; s < steps; ++s) {
+        if (s + 1 == steps && snapshotFunc) snapshotFunc();
+        stepFunc();
+        accumulator -= stepSeconds;
+    }
+    accumulator = std::max(0.0, accumulator);
+
+    if (steps > 0) {
+        metrics.steps += steps;
+        metrics.avgStepSeconds = smooth(metrics.avgStepSeconds, (clock() - stepStart) / steps, metrics.steps);
+    }
+    if (elapsed > 0.0) {
+        metrics.achievedRate = smooth(metrics.achievedRate, steps * stepSeconds / elapsed, metrics.frames);
+    }
+
+    result.steps = steps;
+    result.alpha = getAlpha();
+    return result;
+}
+
+double PacedRunLoop::timeUntilNextFrame() const {
+    if (!started || targetFrameSeconds <= 0.0) return 0.0;
+    return std::max(0.0, lastFrameTime + targetFrameSeconds - clock());
+}
+
+void PacedRunLoop::run(const std::function<bool(const FrameResult&)>& onFrame) {
+    while (true) {
+        FrameResult result = runFrame();
+        if (!onFrame(result)) return;
+
+        double wait = timeUntilNextFrame();
+        if (wait > 0.0) {
+            sleeper(wait);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void PacedRunLoop::interpolate(const std::vector<BodyState>& previous, const std::vector<BodyState>& current,
+                               double alpha, std::vector<BodyState>& out) {
+    out = current;
+    if (previous.size() != current.size()) return;
+
+    for (size_t i = 0; i < current.size(); ++i) {
+        if (previous[i].id != current[i].id) continue;
+        out[i].position = previous[i].position + (current[i].position - previous[i].position) * alpha;
+        out[i].velocity = previous[i].velocity + (current[i].velocity - previous[i].velocity) * alpha;
+    }
+}
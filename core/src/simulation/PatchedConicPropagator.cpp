@@ -0,0 +1,316 @@
+#include "../../include/simulation/PatchedConicPropagator.h"
+#include "../../include/simulation/SolarSystem.h"
+#include "../../include/simulation/WorkStealingPool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+    // A craft that just left an SOI ignores it until this far outside
+    constexpr double EXIT_CLEARANCE = 1e-6;
+
+    double periapsisAcceleration(double mu, const Orbit& orbit) {
+        double q = orbit.getPeriapsis();
+        return mu / (q * q);
+    }
+}
+
+PatchedConicPropagator::PatchedConicPropagator(const SolarSystem& system, const PatchedConicConfig& config_,
+                                               WorkStealingPool* pool_)
+    : config(config_), starId(0), starMass(PhysicsConstants::SOLAR_MASS), pool(pool_) {
+    if (const Star* star = system.getStar()) {
+        starId = star->getId();
+        starMass = star->getMass();
+    }
+
+    double starMu = PhysicsConstants::G * starMass;
+    for (const auto& [id, orbit] : system.getOrbits()) {
+        const CelestialBody* body = system.findBody(id);
+        double mass = body ? body->getMass() : 0.0;
+        if (mass < config.minFrameMass) continue;
+
+        double a = orbit.getElements().semiMajorAxis;
+        FrameBody frame{id, mass, 0.0, periapsisAcceleration(starMu, orbit), orbit};
+        frame.soiRadius = config.soiModel == SoiModel::HILL
+            ? Gravity::hillSphereRadius(mass, starMass, a)
+            : Gravity::laplaceSphereRadius(mass, starMass, a);
+        frames.push_back(frame);
+    }
+    std::sort(frames.begin(), frames.end(), [](const FrameBody& l, const FrameBody& r) { return l.id < r.id; });
+}
+
+/*--- Craft management ---*/
+
+bool PatchedConicPropagator::addCraft(int craftId, int frameBodyId, const Vec3& position, const Vec3& velocity,
+                                      double time) {
+    if (craftIndex.count(craftId)) return false;
+    int frame = frameBodyId == starId ? -1 : frameIndexOf(frameBodyId);
+    if (frame < -1) return false;
+
+    double mass = frameMass(frame);
+    OrbitalElements elements = OrbitUtils::stateToElements(position, velocity, PhysicsConstants::G * mass);
+    elements.epoch = time;
+
+    Craft craft{craftId, frame, Orbit(elements, mass), time, 0.0, -1, {}};
+    if (frame < 0) {
+        craft.maxAcceleration = periapsisAcceleration(PhysicsConstants::G * starMass, craft.orbit);
+        // A heliocentric state inside a planetary SOI starts in that planet's frame
+        for (size_t k = 0; k < frames.size(); ++k) {
+            if (entryResidual(craft, frames[k], time) <= 0.0) {
+                switchFrame(craft, static_cast<int>(k), time);
+                craft.pending.clear();
+                break;
+            }
+        }
+    }
+
+    craftIndex[craftId] = crafts.size();
+    crafts.push_back(std::move(craft));
+    return true;
+}
+
+bool PatchedConicPropagator::addCraft(const ArtificialBody& body, double time) {
+    int central = body.getCentralBodyId();
+    int frame = central == starId ? -1 : frameIndexOf(central);
+    if (frame < -1 || body.getSemiMajorAxis() == 0.0) return false;
+
+    OrbitalElements elements;
+    elements.eccentricity = body.getEccentricity();
+    elements.semiMajorAxis = elements.eccentricity > 1.0 ? -std::abs(body.getSemiMajorAxis())
+                                                         : body.getSemiMajorAxis();
+    elements.inclination = body.getInclination();
+    elements.longitudeOfAscNode = 0.0;
+    elements.argumentOfPeriapsis = 0.0;
+    elements.trueAnomaly = 0.0;
+    elements.meanAnomaly = 0.0;
+    elements.epoch = time;
+
+    Vec3 position, velocity;
+    Orbit(elements, frameMass(frame)).getStateAtTime(time, position, velocity);
+    return addCraft(body.getId(), central, position, velocity, time);
+}
+
+bool PatchedConicPropagator::removeCraft(int craftId) {
+    auto it = craftIndex.find(craftId);
+    if (it == craftIndex.end()) return false;
+
+    // Swap-remove, keeping the index map in step
+    size_t index = it->second;
+    craftIndex.erase(it);
+    if (index + 1 != crafts.size()) {
+        crafts[index] = std::move(crafts.back());
+        craftIndex[crafts[index].id] = index;
+    }
+    crafts.pop_back();
+    return true;
+}
+
+/*--- Propagation ---*/
+
+void PatchedConicPropagator::propagateTo(double time) {
+    auto runCrafts = [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) advance(crafts[i], time);
+    };
+
+    if (pool && pool->getThreadCount() > 1 && crafts.size() > 1) {
+        pool->parallelFor(crafts.size(), std::max<size_t>(1, crafts.size() / (8 * pool->getThreadCount())), runCrafts);
+    } else {
+        runCrafts(0, crafts.size(), 0);
+    }
+
+    size_t first = transitions.size();
+    for (auto& craft : crafts) {
+        transitions.insert(transitions.end(), craft.pending.begin(), craft.pending.end());
+        craft.pending.clear();
+    }
+    std::stable_sort(transitions.begin() + first, transitions.end(),
+                     [](const SoiTransition& l, const SoiTransition& r) { return l.time < r.time; });
+}
+
+void PatchedConicPropagator::advance(Craft& craft, double endTime) const {
+    while (craft.time < endTime) {
+        if (craft.frame >= 0) {
+            // Closed-form exit: outbound crossing of r = R_soi on the relative conic
+            const OrbitalElements& e = craft.orbit.getElements();
+            double radius = frames[craft.frame].soiRadius;
+            bool hyperbolic = e.eccentricity >= 1.0;
+            if (!hyperbolic && craft.orbit.getApoapsis() <= radius) break;  // captured
+
+            double p = e.semiMajorAxis * (1.0 - e.eccentricity * e.eccentricity);
+            double cosNu = std::clamp((p / radius - 1.0) / e.eccentricity, -1.0, 1.0);
+            double exitTime;
+            if (!craft.orbit.nextTimeAtTrueAnomaly(std::acos(cosNu), craft.time, exitTime)) {
+                exitTime = craft.time;  // hyperbolic and already past the boundary
+            }
+            if (exitTime > endTime) break;
+
+            int left = craft.frame;
+            switchFrame(craft, -1, exitTime);
+            craft.excludedFrame = left;
+        } else {
+            double entryTime;
+            int frame = findEntry(craft, endTime, entryTime);
+            if (frame < 0) break;
+            switchFrame(craft, frame, entryTime);
+        }
+    }
+    craft.time = endTime;
+}
+
+int PatchedConicPropagator::findEntry(Craft& craft, double endTime, double& entryTime) const {
+    double t = craft.time;
+    double previous = t;
+
+    while (true) {
+        Vec3 rc, vc;
+        craft.orbit.getStateAtTime(t, rc, vc);
+
+        double step = std::numeric_limits<double>::infinity();
+        int hit = -1;
+        for (size_t k = 0; k < frames.size(); ++k) {
+            const FrameBody& body = frames[k];
+            Vec3 rb, vb;
+            body.orbit.getStateAtTime(t, rb, vb);
+            double f = (rc - rb).magnitude() - body.soiRadius;
+
+            int frame = static_cast<int>(k);
+            if (frame == craft.excludedFrame) {
+                if (f <= EXIT_CLEARANCE * body.soiRadius) {
+                    // Still at the boundary it just crossed outbound: only bound the step
+                    step = std::min(step, EXIT_CLEARANCE * body.soiRadius / ((vc - vb).magnitude() + 1e-9));
+                    continue;
+                }
+                craft.excludedFrame = -1;
+            }
+
+            if (f <= 0.0) {
+                // Bracketed in (previous, t]: refine, keep the earliest body
+                double lo = previous, hi = t;
+                double flo = entryResidual(craft, body, lo), fhi = f;
+                double tolerance = config.entryTolerance * body.soiRadius;
+                int side = 0;
+                for (int it = 0; it < config.maxRefineIterations && hi - lo > 1e-6; ++it) {
+                    // Illinois regula falsi
+                    double mid = (flo > 0.0 && fhi < 0.0) ? hi - fhi * (hi - lo) / (fhi - flo) : 0.5 * (lo + hi);
+                    double fm = entryResidual(craft, body, mid);
+                    if (fm <= 0.0) {
+                        hi = mid; fhi = fm;
+                        if (side == -1) flo *= 0.5;
+                        side = -1;
+                    } else {
+                        lo = mid; flo = fm;
+                        if (side == 1) fhi *= 0.5;
+                        side = 1;
+                    }
+                    if (fhi > -tolerance && fhi <= 0.0) break;
+                }
+                if (hit < 0 || hi < entryTime) {
+                    hit = frame;
+                    entryTime = hi;
+                }
+                continue;
+            }
+
+            // |f'| <= v + A*h over the step, so f stays positive for h*(v + A*h) < f
+            double v = (vc - vb).magnitude();
+            double a = craft.maxAcceleration + body.maxAcceleration;
+            double h = 2.0 * f / (v + std::sqrt(v * v + 4.0 * a * f));
+            // Floor keeps the approach from stalling just outside the boundary
+            double floor = config.entryTolerance * body.soiRadius / (v + 1e-9);
+            step = std::min(step, std::max(h, floor));
+        }
+
+        if (hit >= 0) return hit;
+        if (t >= endTime) return -1;
+        previous = t;
+        t = std::min(t + step, endTime);
+    }
+}
+
+double PatchedConicPropagator::entryResidual(const Craft& craft, const FrameBody& body, double t) const {
+    return (craft.orbit.getPositionAtTime(t) - body.orbit.getPositionAtTime(t)).magnitude() - body.soiRadius;
+}
+
+void PatchedConicPropagator::switchFrame(Craft& craft, int newFrame, double time) const {
+    Vec3 r, v;
+    craft.orbit.getStateAtTime(time, r, v);
+
+    // Through the heliocentric frame: add the old body's state, subtract the new one's
+    if (craft.frame >= 0) {
+        Vec3 rb, vb;
+        frames[craft.frame].orbit.getStateAtTime(time, rb, vb);
+        r += rb;
+        v += vb;
+    }
+    if (newFrame >= 0) {
+        Vec3 rb, vb;
+        frames[newFrame].orbit.getStateAtTime(time, rb, vb);
+        r -= rb;
+        v -= vb;
+    }
+
+    double mass = frameMass(newFrame);
+    OrbitalElements elements = OrbitUtils::stateToElements(r, v, PhysicsConstants::G * mass);
+    elements.epoch = time;
+
+    craft.pending.push_back(SoiTransition{craft.id, frameBodyId(craft.frame), frameBodyId(newFrame), time});
+    craft.orbit = Orbit(elements, mass);
+    craft.frame = newFrame;
+    craft.time = time;
+    craft.excludedFrame = -1;
+    if (newFrame < 0) craft.maxAcceleration = periapsisAcceleration(PhysicsConstants::G * starMass, craft.orbit);
+}
+
+/*--- Queries ---*/
+
+bool PatchedConicPropagator::getState(int craftId, Vec3& position, Vec3& velocity) const {
+    auto it = craftIndex.find(craftId);
+    if (it == craftIndex.end()) return false;
+
+    const Craft& craft = crafts[it->second];
+    craft.orbit.getStateAtTime(craft.time, position, velocity);
+    if (craft.frame >= 0) {
+        Vec3 rb, vb;
+        frames[craft.frame].orbit.getStateAtTime(craft.time, rb, vb);
+        position += rb;
+        velocity += vb;
+    }
+    return true;
+}
+
+int PatchedConicPropagator::getFrameBodyId(int craftId) const {
+    auto it = craftIndex.find(craftId);
+    return it == craftIndex.end() ? -1 : frameBodyId(crafts[it->second].frame);
+}
+
+const Orbit* PatchedConicPropagator::getOrbit(int craftId) const {
+    auto it = craftIndex.find(craftId);
+    return it == craftIndex.end() ? nullptr : &crafts[it->second].orbit;
+}
+
+void PatchedConicPropagator::writeBack(SolarSystem& system) const {
+    for (const auto& body : system.getArtificialBodies()) {
+        auto it = craftIndex.find(body->getId());
+        if (it == craftIndex.end()) continue;
+
+        const Craft& craft = crafts[it->second];
+        const OrbitalElements& e = craft.orbit.getElements();
+        body->setSemiMajorAxis(e.semiMajorAxis);
+        body->setEccentricity(e.eccentricity);
+        body->setInclination(e.inclination);
+        body->setCentralBodyId(frameBodyId(craft.frame));
+    }
+}
+
+double PatchedConicPropagator::getSoiRadius(int bodyId) const {
+    int frame = frameIndexOf(bodyId);
+    return frame >= 0 ? frames[frame].soiRadius : std::numeric_limits<double>::infinity();
+}
+
+int PatchedConicPropagator::frameIndexOf(int bodyId) const {
+    for (size_t k = 0; k < frames.size(); ++k) {
+        if (frames[k].id == bodyId) return static_cast<int>(k);
+    }
+    return -2;
+}
@@ -0,0 +1,241 @@
+#include "../../include/simulation/PipelinedRunLoop.h"
+#include "../../include/simulation/SolarSystem.h"
+#include "../../include/diagnostics/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+    double steadySeconds() {
+        using namespace std::chrono;
+        return duration<double>(steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+/*--- Constructors ---*/
+
+PipelinedRunLoop::PipelinedRunLoop(StepFunc step, CaptureFunc capture)
+    : stepFunc(std::move(step)), captureFunc(std::move(capture)), pipelined(true) {}
+
+PipelinedRunLoop::PipelinedRunLoop(SolarSystem& system)
+    : PipelinedRunLoop([&system]() { system.step(); },
+                       [&system](PipelineSnapshot& snapshot) {
+                           if (system.isUsingKeplerianOrbits()) system.syncBodyStatesFromOrbits();
+                           const TimeSystem& time = system.getTimeSystem();
+                           snapshot.tick = time.getTickCount();
+                           snapshot.time = time.getCurrentTime();
+                           // assign() reuses the slot's storage once it has grown
+                           const std::vector<BodyState>& states = system.getBodyStates();
+                           snapshot.states.assign(states.begin(), states.end());
+                       }) {}
+
+/*--- Configuration ---*/
+
+size_t PipelinedRunLoop::addStage(const std::string& name, StageFunc func, const PipelineStageConfig& config) {
+    auto stage = std::make_unique<Stage>();
+    stage->name = name;
+    stage->func = std::move(func);
+    stage->config = config;
+    stage->config.capacity = std::max<size_t>(1, config.capacity);
+    stage->config.stride = std::max<uint32_t>(1, config.stride);
+    stage->stats.name = name;
+    stages.push_back(std::move(stage));
+    return stages.size() - 1;
+}
+
+void PipelinedRunLoop::resetMetrics() {
+    metrics = Metrics();
+    for (auto& stage : stages) {
+        std::string name = stage->stats.name;
+        stage->stats = StageStats();
+        stage->stats.name = name;
+    }
+}
+
+/*--- Driving ---*/
+
+void PipelinedRunLoop::prepareRing() {
+    size_t size = 1;
+    for (const auto& stage : stages) size += stage->config.capacity + 1;
+    if (ring.size() != size) {
+        ring.resize(size);
+        references = std::make_unique<std::atomic<int>[]>(size);
+    }
+    freeSlots.clear();
+    for (size_t slot = size; slot-- > 0;) {
+        references[slot].store(0, std::memory_order_relaxed);
+        freeSlots.push_back(slot);
+    }
+
+    // Size every slot up front so the stepping loop does not allocate
+    captureFunc(ring[0]);
+    for (PipelineSnapshot& snapshot : ring) snapshot.states.reserve(ring[0].states.size());
+}
+
+void PipelinedRunLoop::run(uint64_t steps) {
+    double wallStart = steadySeconds();
+    prepareRing();
+
+    auto closeStages = [this]() {
+        for (auto& stage : stages) {
+            if (!stage->thread.joinable()) continue;
+            {
+                std::lock_guard<std::mutex> lock(stage->mutex);
+                stage->closing = true;
+            }
+            stage->notEmpty.notify_one();
+            stage->thread.join();
+        }
+    };
+
+    if (pipelined) {
+        for (auto& stage : stages) {
+            stage->closing = false;
+            stage->queue.clear();
+            stage->thread = std::thread(&PipelinedRunLoop::runStage, this, std::ref(*stage));
+        }
+    }
+
+    try {
+        for (uint64_t n = 1; n <= steps; ++n) {
+            double t0 = steadySeconds();
+            stepFunc();
+            double t1 = steadySeconds();
+            size_t slot = acquireSlot();
+            double t2 = steadySeconds();
+
+            PipelineSnapshot& snapshot = ring[slot];
+            captureFunc(snapshot);
+            snapshot.sequence = n;
+            double t3 = steadySeconds();
+
+            metrics.stepSeconds += t1 - t0;
+            metrics.stallSeconds += t2 - t1;
+            metrics.captureSeconds += t3 - t2;
+            ++metrics.steps;
+
+            // The stepping thread holds one reference until every stage was offered the slot
+            references[slot].store(1, std::memory_order_relaxed);
+            for (auto& stage : stages) {
+                if (n % stage->config.stride != 0) continue;
+                if (pipelined) {
+                    offer(*stage, slot);
+                } else {
+                    double start = steadySeconds();
+                    stage->func(snapshot);
+                    stage->stats.busySeconds += steadySeconds() - start;
+                    ++stage->stats.processed;
+                }
+            }
+            release(slot);
+        }
+    } catch (...) {
+        closeStages();
+        throw;
+    }
+
+    closeStages();
+    metrics.wallSeconds += steadySeconds() - wallStart;
+}
+
+void PipelinedRunLoop::runStage(Stage& stage) {
+    for (;;) {
+        size_t slot;
+        {
+            std::unique_lock<std::mutex> lock(stage.mutex);
+            stage.notEmpty.wait(lock, [&stage]() { return stage.closing || !stage.queue.empty(); });
+            if (stage.queue.empty()) return;     // closing and drained
+            slot = stage.queue.front();
+            stage.queue.pop_front();
+        }
+        stage.notFull.notify_one();
+
+        double start = steadySeconds();
+        stage.func(ring[slot]);
+        stage.stats.busySeconds += steadySeconds() - start;
+        ++stage.stats.processed;
+        release(slot);
+    }
+}
+
+void PipelinedRunLoop::offer(Stage& stage, size_t slot) {
+    size_t evicted = ring.size();
+    {
+        std::unique_lock<std::mutex> lock(stage.mutex);
+        if (stage.queue.size() >= stage.config.capacity) {
+            switch (stage.config.policy) {
+                case QueuePolicy::DROP_NEWEST:
+                    ++stage.stats.dropped;
+                    return;
+                case QueuePolicy::DROP_OLDEST:
+                    evicted = stage.queue.front();
+                    stage.queue.pop_front();
+                    ++stage.stats.dropped;
+                    break;
+                case QueuePolicy::BLOCK: {
+                    double start = steadySeconds();
+                    stage.notFull.wait(lock, [&stage]() { return stage.queue.size() < stage.config.capacity; });
+                    double waited = steadySeconds() - start;
+                    stage.stats.stallSeconds += waited;
+                    metrics.stallSeconds += waited;
+                    break;
+                }
+            }
+        }
+        references[slot].fetch_add(1, std::memory_order_relaxed);
+        stage.queue.push_back(slot);
+        stage.stats.maxDepth = std::max(stage.stats.maxDepth, stage.queue.size());
+    }
+    stage.notEmpty.notify_one();
+    if (evicted < ring.size()) release(evicted);
+}
+
+void PipelinedRunLoop::release(size_t slot) {
+    if (references[slot].fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    {
+        std::lock_guard<std::mutex> lock(ringMutex);
+        freeSlots.push_back(slot);
+    }
+    slotFreed.notify_one();
+}
+
+size_t PipelinedRunLoop::acquireSlot() {
+    // Never waits with the ring sized as in prepareRing(); kept for safety
+    std::unique_lock<std::mutex> lock(ringMutex);
+    slotFreed.wait(lock, [this]() { return !freeSlots.empty(); });
+    size_t slot = freeSlots.back();
+    freeSlots.pop_back();
+    return slot;
+}
+
+/*--- Ready-made stages ---*/
+
+PipelinedRunLoop::StageFunc PipelineStages::diagnostics(std::vector<DiagnosticSample>& out) {
+    return [&out](const PipelineSnapshot& snapshot) {
+        SOLARSYS_PROFILE_SCOPE(DIAGNOSTICS);
+        out.push_back({snapshot.tick, snapshot.time,
+                       IntegratorUtils::computeTotalEnergy(snapshot.states),
+                       IntegratorUtils::computeTotalAngularMomentum(snapshot.states),
+                       IntegratorUtils::computeCenterOfMass(snapshot.states)});
+    };
+}
+
+PipelinedRunLoop::StageFunc PipelineStages::trajectoryCsv(std::ostream& out) {
+    auto headerWritten = std::make_shared<bool>(false);
+    return [&out, headerWritten](const PipelineSnapshot& snapshot) {
+        SOLARSYS_PROFILE_SCOPE(OUTPUT);
+        if (!*headerWritten) {
+            out << "tick,time,id,x,y,z,vx,vy,vz\n";
+            *headerWritten = true;
+        }
+        char line[256];
+        for (const BodyState& body : snapshot.states) {
+            int length = std::snprintf(line, sizeof(line),
+                                       "%llu,%.17g,%d,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g\n",
+                                       static_cast<unsigned long long>(snapshot.tick), snapshot.time, body.id,
+                                       body.position.x, body.position.y, body.position.z,
+                                       body.velocity.x, body.velocity.y, body.velocity.z);
+            out.write(line, std::min<int>(length, static_cast<int>(sizeof(line)) - 1));
+        }
+    };
+}
@@ -5,26 +5,639 @@
 // SolarSystem is mostly header-only
 // Additional complex operations go here
 
+namespace {
+
+    // Position a velocity Verlet state had one step earlier: inverts
+    // x' = x + v dt + a dt^2 / 2 using v' and a' of the stored state
+    Vec3 verletPreviousPosition(const BodyState& s, double dt) {
+        return s.position - s.velocity * dt + s.acceleration * (0.5 * dt * dt);
+    }
+
+    // Undoes one in-place velocity Verlet sweep. Going forward, body i took its
+    // new acceleration with bodies before it already advanced and those after
+    // it not yet, so going backward (i descending) it must see bodies before
+    // it one step back and bodies after it two steps back; `previous` holds
+    // each body's verletPreviousPosition() and makes that exact up to rounding.
+    void reverseVerletSweep(std::vector<BodyState>& states, std::vector<BodyState>& previous, double dt) {
+        for (size_t i = states.size(); i-- > 0;) {
+            BodyState& s = states[i];
+            Vec3 later = s.acceleration;
+            s.position = previous[i].position;
+            s.acceleration = Integrator::nBodyAcceleration(s, previous);
+            s.velocity -= (later + s.acceleration) * (0.5 * dt);
+            previous[i].position = verletPreviousPosition(s, dt);
+        }
+    }
+}
+
+const CelestialBody* SolarSystem::findBody(int bodyId) const {
+    if (star && star->getId() == bodyId) return star.get();
+    for (const auto& p : planets) if (p->getId() == bodyId) return p.get();
+    for (const auto& m : moons) if (m->getId() == bodyId) return m.get();
+    for (const auto& dp : dwarfPlanets) if (dp->getId() == bodyId) return dp.get();
+    for (const auto& a : asteroids) if (a->getId() == bodyId) return a.get();
+    for (const auto& c : comets) if (c->getId() == bodyId) return c.get();
+    for (const auto& ab : artificialBodies) if (ab->getId() == bodyId) return ab.get();
+    return nullptr;
+}
+
+const SolarSystem::KeplerSample* SolarSystem::sampleOrbit(int bodyId) const {
+    double t = timeSystem.getCurrentTime();
+
+    auto cached = keplerCache.find(bodyId);
+    if (cached != keplerCache.end() && cached->second.time == t) return &cached->second;
+
+    auto it = orbits.find(bodyId);
+    if (it == orbits.end()) return nullptr;
+
+    SOLARSYS_PROFILE_SCOPE(KEPLER_PROPAGATION);
+    KeplerSample& sample = cached != keplerCache.end() ? cached->second : keplerCache[bodyId];
+    sample.time = t;
+    it->second.getStateAtTime(t, sample.position, sample.velocity);
+    return &sample;
+}
+
+void SolarSystem::initializeBodyStates(bool barycentric) {
+    // Numerical bodies carry state the orbits no longer describe
+    std::unordered_map<int, BodyState> integrated;
+    for (const auto& state : bodyStates) {
+        if (numericalBodies.count(state.id)) integrated.emplace(state.id, state);
+    }
+    bodyStates.clear();
+    historyDirty = true;
+    hybridAccelerationsStale = true;
+
+    // Star at origin (heliocentric frame)
+    if (star) {
+        BodyState starState;
+        starState.id = star->getId();
+        starState.mass = star->getMass();
+        starState.position = Vec3(0, 0, 0);
+        starState.velocity = Vec3(0, 0, 0);
+        starState.acceleration = Vec3(0, 0, 0);
+        bodyStates.push_back(starState);
+    }
+
+    // Orbit-driven and numerical bodies in id order so layouts are reproducible
+    std::vector<int> ids;
+    for (const auto& [id, orbit] : orbits) ids.push_back(id);
+    for (const auto& [id, state] : integrated) {
+        if (!orbits.count(id)) ids.push_back(id);
+    }
+    std::sort(ids.begin(), ids.end());
+
+    for (int id : ids) {
+        auto kept = integrated.find(id);
+        if (kept != integrated.end()) {
+            bodyStates.push_back(kept->second);
+            continue;
+        }
+        const CelestialBody* body = findBody(id);
+        BodyState state;
+        state.id = id;
+        state.mass = body ? body->getMass() : 0.0;
+        state.acceleration = Vec3(0, 0, 0);
+        bodyStates.push_back(state);
+    }
+    syncBodyStatesFromOrbits();
+    if (!barycentric) return;
+
+    // The heliocentric layout drifts as a whole under N-body integration: put
+    // the centre of mass at rest at the origin, then seed the accelerations
+    // velocity Verlet reads on its first step
+    Vec3 com = IntegratorUtils::computeCenterOfMass(bodyStates);
+    Vec3 comVelocity = IntegratorUtils::computeCenterOfMassVelocity(bodyStates);
+    for (auto& state : bodyStates) {
+        state.position -= com;
+        state.velocity -= comVelocity;
+    }
+    for (auto& state : bodyStates) state.acceleration = Integrator::nBodyAcceleration(state, bodyStates);
+}
+
+void SolarSystem::syncBodyStatesFromOrbits() {
+    double t = timeSystem.getCurrentTime();
+    for (auto& state : bodyStates) {
+        auto it = orbits.find(state.id);
+        if (it == orbits.end() || numericalBodies.count(state.id)) continue;
+        // Bulk path: one solve per body, bypassing the query cache so a full sync
+        // does not duplicate the state array
+        it->second.getStateAtTime(t, state.position, state.velocity);
+    }
+}
+
+void SolarSystem::stepWithEncounters(double dt) {
+    // Pairs advance from the start-of-step field; the other bodies then take
+    // their usual in-place step and still see the pair members where they were
+    auto externalField = [this](const EncounterPair& pair, const BodyState& a, const BodyState& b,
+                                Vec3& externalA, Vec3& externalB) {
+        externalA = Vec3();
+        externalB = Vec3();
+        for (size_t k = 0; k < bodyStates.size(); ++k) {
+            if (k == pair.first || k == pair.second) continue;
+            externalA += Gravity::computeAcceleration(bodyStates[k].mass, a.position, bodyStates[k].position);
+            externalB += Gravity::computeAcceleration(bodyStates[k].mass, b.position, bodyStates[k].position);
+        }
+    };
+
+    encounterScratch.clear();
+    for (const EncounterPair& pair : encounterPairs) {
+        BodyState a = bodyStates[pair.first];
+        BodyState b = bodyStates[pair.second];
+        Vec3 externalA, externalB;
+        externalField(pair, a, b, externalA, externalB);
+        encounterStats.kicks += EncounterRegularization::advancePair(a, b, externalA, externalB, dt, encounterConfig);
+        ++encounterStats.pairSteps;
+        encounterScratch.push_back(a);
+        encounterScratch.push_back(b);
+    }
+
+    for (size_t k = 0; k < bodyStates.size(); ++k) {
+        bool paired = std::any_of(encounterPairs.begin(), encounterPairs.end(),
+                                  [k](const EncounterPair& p) { return p.first == k || p.second == k; });
+        if (!paired) integrateBody(bodyStates[k], dt);
+    }
+
+    for (size_t p = 0; p < encounterPairs.size(); ++p) {
+        bodyStates[encounterPairs[p].first] = encounterScratch[2 * p];
+        bodyStates[encounterPairs[p].second] = encounterScratch[2 * p + 1];
+    }
+    for (const EncounterPair& pair : encounterPairs) {
+        BodyState& a = bodyStates[pair.first];
+        BodyState& b = bodyStates[pair.second];
+        Vec3 externalA, externalB;
+        externalField(pair, a, b, externalA, externalB);
+        EncounterRegularization::completePair(a, b, externalA, externalB, dt);
+    }
+    // Velocity Verlet carries the acceleration into the next step
+    for (const EncounterPair& pair : encounterPairs) {
+        for (size_t k : {pair.first, pair.second}) {
+            bodyStates[k].acceleration = Integrator::nBodyAcceleration(bodyStates[k], bodyStates);
+        }
+    }
+}
+
+/*--- Per-body propagation ---*/
+
+bool SolarSystem::promoteToNumerical(int bodyId) {
+    if (!useKeplerianOrbits || (star && star->getId() == bodyId)) return false;
+    if (numericalBodies.count(bodyId)) return true;
+
+    auto state = std::find_if(bodyStates.begin(), bodyStates.end(),
+                              [&](const BodyState& s) { return s.id == bodyId; });
+    const KeplerSample* sample = sampleOrbit(bodyId);
+    if (!sample && state == bodyStates.end()) return false;
+
+    if (state == bodyStates.end()) {
+        const CelestialBody* body = findBody(bodyId);
+        BodyState added;
+        added.id = bodyId;
+        added.mass = body ? body->getMass() : 0.0;
+        bodyStates.push_back(added);
+        state = bodyStates.end() - 1;
+    }
+    if (sample) {
+        state->position = sample->position;
+        state->velocity = sample->velocity;
+    }
+
+    numericalBodies.insert(bodyId);
+    hybridSourcesValid = false;
+    hybridAccelerationsStale = true;
+    historyDirty = true;
+    return true;
+}
+
+bool SolarSystem::demoteToKeplerian(int bodyId) {
+    if (!useKeplerianOrbits || !numericalBodies.count(bodyId)) return false;
+    auto state = std::find_if(bodyStates.begin(), bodyStates.end(),
+                              [&](const BodyState& s) { return s.id == bodyId; });
+
+    numericalBodies.erase(bodyId);
+    hybridSourcesValid = false;
+    hybridAccelerationsStale = true;
+    historyDirty = true;
+    if (state == bodyStates.end()) return true;     // nothing integrated: the orbit stands
+
+    // Heliocentric state, so the osculating orbit is around the star directly
+    double centralMass = (star ? star->getMass() : 0.0) + state->mass;
+    OrbitalElements elements =
+        OrbitUtils::stateToElements(state->position, state->velocity, PhysicsConstants::G * centralMass);
+    elements.epoch = timeSystem.getCurrentTime();
+    setOrbit(bodyId, Orbit(elements, centralMass));
+    return true;
+}
+
+void SolarSystem::refreshHybridSources() {
+    if (hybridSourcesValid && hybridSourcesGeneration == orbitGeneration) return;
+    hybridSources.clear();
+    for (const auto& [id, orbit] : orbits) {
+        if (numericalBodies.count(id) || (star && star->getId() == id)) continue;
+        const CelestialBody* body = findBody(id);
+        if (body && body->getMass() >= hybridConfig.minSourceMass) hybridSources.push_back({id, body->getMass(), &orbit});
+    }
+    // Summation order must not depend on the hash layout
+    std::sort(hybridSources.begin(), hybridSources.end(),
+              [](const HybridSource& a, const HybridSource& b) { return a.id < b.id; });
+    hybridSourcePositions.resize(hybridSources.size());
+    hybridSourcesValid = true;
+    hybridSourcesGeneration = orbitGeneration;
+}
+
+void SolarSystem::hybridAccelerations(double time, const Vec3* positions, Vec3* out) {
+    // The star's reflex (indirect term) is the same for every body
+    const Vec3 origin;
+    Vec3 indirect;
+    for (size_t s = 0; s < hybridSources.size(); ++s) {
+        hybridSourcePositions[s] = hybridSources[s].orbit->getPositionAtTime(time);
+        indirect += Gravity::computeAcceleration(hybridSources[s].mass, hybridSourcePositions[s], origin);
+    }
+    const size_t n = hybridIndices.size();
+    hybridMassive.clear();
+    for (size_t k = 0; k < n; ++k) {
+        if (bodyStates[hybridIndices[k]].mass < hybridConfig.minSourceMass) continue;
+        hybridMassive.push_back(k);
+        indirect += Gravity::computeAcceleration(bodyStates[hybridIndices[k]].mass, positions[k], origin);
+    }
+
+    const double starMass = star ? star->getMass() : 0.0;
+    for (size_t k = 0; k < n; ++k) {
+        const Vec3& x = positions[k];
+        // Heliocentric two-body term uses M + m, matching the orbits' mu
+        Vec3 a = Gravity::computeAcceleration(starMass + bodyStates[hybridIndices[k]].mass, x, origin) + indirect;
+        for (size_t s = 0; s < hybridSources.size(); ++s) {
+            a += Gravity::computeAcceleration(hybridSources[s].mass, x, hybridSourcePositions[s]);
+        }
+        for (size_t j : hybridMassive) {
+            if (j == k) {
+                // A body's own reflex does not act on it
+                a -= Gravity::computeAcceleration(bodyStates[hybridIndices[j]].mass, x, origin);
+                continue;
+            }
+            a += Gravity::computeAcceleration(bodyStates[hybridIndices[j]].mass, x, positions[j]);
+        }
+        out[k] = a;
+    }
+}
+
+void SolarSystem::initializeHybridAccelerations() {
+    hybridAccelerationsStale = false;
+    if (numericalBodies.empty()) return;
+    refreshHybridSources();
+    hybridIndices.clear();
+    for (size_t i = 0; i < bodyStates.size(); ++i) {
+        if (numericalBodies.count(bodyStates[i].id)) hybridIndices.push_back(i);
+    }
+    const size_t n = hybridIndices.size();
+    hybridStages.resize(2 * n);
+    Vec3* x = hybridStages.data();
+    Vec3* a = x + n;
+    for (size_t k = 0; k < n; ++k) x[k] = bodyStates[hybridIndices[k]].position;
+    hybridAccelerations(timeSystem.getCurrentTime(), x, a);
+    for (size_t k = 0; k < n; ++k) bodyStates[hybridIndices[k]].acceleration = a[k];
+}
+
+void SolarSystem::stepHybrid(double dt) {
+    // Sources are pinned to the clock, so integrate over what tick() advances
+    if (timeSystem.isPaused()) return;
+    const double h = dt * timeSystem.getTimeScale();
+    const double t = timeSystem.getCurrentTime();
+
+    refreshHybridSources();
+    hybridIndices.clear();
+    for (size_t i = 0; i < bodyStates.size(); ++i) {
+        if (numericalBodies.count(bodyStates[i].id)) hybridIndices.push_back(i);
+    }
+    const size_t n = hybridIndices.size();
+    SOLARSYS_PROFILE_COUNT(FORCE_EVALUATIONS, n * (integrationMethod == IntegrationMethod::RK4 ? 5 : 1));
+
+    // All numerical bodies move together from one field evaluation per stage
+    hybridStages.resize(8 * n);
+    Vec3* x = hybridStages.data();
+    Vec3* a = x + n;
+    for (size_t k = 0; k < n; ++k) x[k] = bodyStates[hybridIndices[k]].position;
+
+    switch (integrationMethod) {
+        case IntegrationMethod::EULER:
+            hybridAccelerations(t, x, a);
+            for (size_t k = 0; k < n; ++k) {
+                BodyState& s = bodyStates[hybridIndices[k]];
+                s.acceleration = a[k];
+                s.position += s.velocity * h;
+                s.velocity += a[k] * h;
+            }
+            break;
+        case IntegrationMethod::SYMPLECTIC_EULER:
+            hybridAccelerations(t, x, a);
+            for (size_t k = 0; k < n; ++k) {
+                BodyState& s = bodyStates[hybridIndices[k]];
+                s.acceleration = a[k];
+                s.velocity += a[k] * h;
+                s.position += s.velocity * h;
+            }
+            break;
+        case IntegrationMethod::VELOCITY_VERLET:
+            for (size_t k = 0; k < n; ++k) {
+                const BodyState& s = bodyStates[hybridIndices[k]];
+                x[k] = s.position + s.velocity * h + s.acceleration * (0.5 * h * h);
+            }
+            hybridAccelerations(t + h, x, a);
+            for (size_t k = 0; k < n; ++k) {
+                BodyState& s = bodyStates[hybridIndices[k]];
+                s.position = x[k];
+                s.velocity += (s.acceleration + a[k]) * (0.5 * h);
+                s.acceleration = a[k];
+            }
+            break;
+        case IntegrationMethod::RK4: {
+            // x holds each stage's positions; k1..k4 accelerations, v2..v3 stage velocities
+            Vec3* k1 = a;
+            Vec3* k2 = k1 + n;
+            Vec3* k3 = k2 + n;
+            Vec3* k4 = k3 + n;
+            Vec3* v2 = k4 + n;
+            Vec3* v3 = v2 + n;
+            hybridAccelerations(t, x, k1);
+            for (size_t k = 0; k < n; ++k) {
+                const BodyState& s = bodyStates[hybridIndices[k]];
+                x[k] = s.position + s.velocity * (0.5 * h);
+                v2[k] = s.velocity + k1[k] * (0.5 * h);
+            }
+            hybridAccelerations(t + 0.5 * h, x, k2);
+            for (size_t k = 0; k < n; ++k) {
+                const BodyState& s = bodyStates[hybridIndices[k]];
+                x[k] = s.position + v2[k] * (0.5 * h);
+                v3[k] = s.velocity + k2[k] * (0.5 * h);
+            }
+            hybridAccelerations(t + 0.5 * h, x, k3);
+            for (size_t k = 0; k < n; ++k) {
+                const BodyState& s = bodyStates[hybridIndices[k]];
+                x[k] = s.position + v3[k] * h;
+            }
+            hybridAccelerations(t + h, x, k4);
+            for (size_t k = 0; k < n; ++k) {
+                BodyState& s = bodyStates[hybridIndices[k]];
+                Vec3 v4 = s.velocity + k3[k] * h;
+                s.position += (s.velocity + v2[k] * 2.0 + v3[k] * 2.0 + v4) * (h / 6.0);
+                s.velocity += (k1[k] + k2[k] * 2.0 + k3[k] * 2.0 + k4[k]) * (h / 6.0);
+                x[k] = s.position;
+            }
+            hybridAccelerations(t + h, x, k1);
+            for (size_t k = 0; k < n; ++k) bodyStates[hybridIndices[k]].acceleration = k1[k];
+            break;
+        }
+    }
+}
+
+/*--- Secular mode ---*/
+
+bool SolarSystem::setSecularMode(bool enabled, const std::vector<int>& minorBodyIds,
+                                 const SecularConfig& config, std::string* error) {
+    if (!enabled) {
+        if (secular) ++orbitGeneration;
+        secular.reset();
+        return true;
+    }
+    if (!star || !useKeplerianOrbits) {
+        if (error) *error = "secular mode needs a star and Keplerian orbits";
+        return false;
+    }
+
+    // Moons orbit their planet, not the star
+    auto heliocentric = [&](const Orbit& orbit) { return orbit.getCentralMass() >= 0.5 * star->getMass(); };
+    std::vector<SecularBody> perturbers, minorBodies;
+    for (int id : minorBodyIds) {
+        auto it = orbits.find(id);
+        if (it == orbits.end() || !heliocentric(it->second)) {
+            if (error) *error = "body " + std::to_string(id) + " has no heliocentric orbit";
+            return false;
+        }
+        const CelestialBody* body = findBody(id);
+        minorBodies.push_back({id, body ? body->getMass() : 0.0, it->second});
+    }
+    for (const auto& [id, orbit] : orbits) {
+        const CelestialBody* body = findBody(id);
+        if (!body || body->getMass() < config.minPerturberMass || !heliocentric(orbit) ||
+            numericalBodies.count(id) || std::count(minorBodyIds.begin(), minorBodyIds.end(), id)) {
+            continue;
+        }
+        perturbers.push_back({id, body->getMass(), orbit});
+    }
+    std::sort(perturbers.begin(), perturbers.end(),
+              [](const SecularBody& a, const SecularBody& b) { return a.id < b.id; });
+
+    auto model = std::make_shared<SecularSystem>();
+    if (!model->build(star->getMass(), perturbers, minorBodies, timeSystem.getCurrentTime(), config, error)) {
+        return false;
+    }
+    secular = std::move(model);
+    syncSecularOrbits();
+    keplerCache.clear();
+    ++orbitGeneration;
+    return true;
+}
+
+void SolarSystem::syncSecularOrbits() {
+    secular->evaluate(timeSystem.getCurrentTime(), secularElements);
+    ++secularRevision;
+    const std::vector<int>& ids = secular->getIds();
+    for (size_t b = 0; b < ids.size(); ++b) {
+        // In place: hybrid sources point into the map
+        Orbit& orbit = orbits[ids[b]];
+        orbit = Orbit(secularElements[b], orbit.getCentralMass());
+    }
+}
+
+/*--- Keyframe history ---*/
+
+void SolarSystem::recordKeyframe() {
+    Keyframe frame;
+    frame.tick = timeSystem.getTickCount();
+    frame.clock = timeSystem;
+    frame.keplerian = useKeplerianOrbits;
+    frame.method = integrationMethod;
+    frame.states = bodyStates;
+    // Secular steps rewrite the orbits without a new generation, so the map
+    // of an earlier keyframe is stale then
+    if (!secular) frame.orbits = history.reusableOrbits(orbitGeneration);
+    if (!frame.orbits) frame.orbits = std::make_shared<const std::unordered_map<int, Orbit>>(orbits);
+    frame.orbitGeneration = orbitGeneration;
+    frame.numericalBodies.assign(numericalBodies.begin(), numericalBodies.end());
+    frame.secular = secular;
+    if (star) frame.flares = star->saveFlareSchedule();
+    history.store(std::move(frame));
+    historyGeneration = orbitGeneration;
+}
+
+void SolarSystem::rebaseHistory() {
+    history.truncateAfter(timeSystem.getTickCount());
+    recordKeyframe();
+    historyDirty = false;
+    historyApproximate = false;
+}
+
+void SolarSystem::restoreKeyframe(const Keyframe& frame) {
+    bodyStates = frame.states;
+    timeSystem = frame.clock;
+    useKeplerianOrbits = frame.keplerian;
+    integrationMethod = frame.method;
+    numericalBodies = std::unordered_set<int>(frame.numericalBodies.begin(), frame.numericalBodies.end());
+    hybridSourcesValid = false;
+    hybridAccelerationsStale = false;       // keyframes are recorded with fresh ones
+    secular = frame.secular;
+    if (frame.orbitGeneration != orbitGeneration) {
+        // New generation rather than the old number, so observers notice
+        orbits = *frame.orbits;
+        keplerCache.clear();
+        ++orbitGeneration;
+    }
+    // The map still holds the secular elements of the pre-seek time
+    if (secular) syncSecularOrbits();
+    // A restarted schedule keeps its state and replays from its own start
+    if (star) star->restoreFlareSchedule(frame.flares);
+    historyGeneration = orbitGeneration;
+    historyDirty = false;
+    historyApproximate = false;
+}
+
+void SolarSystem::setHistoryRecording(bool enabled, const KeyframeConfig& config) {
+    recordHistory = enabled;
+    history = KeyframeHistory(config);
+    historyDirty = false;
+    historyApproximate = false;
+    if (enabled) recordKeyframe();
+}
+
+SeekResult SolarSystem::seekTo(double time) {
+    SeekResult result;
+    if (!recordHistory) return result;
+    // Keep an unrecorded edit so seeking back to it works
+    if (historyDirty || orbitGeneration != historyGeneration) rebaseHistory();
+
+    const Keyframe* before = history.findBefore(time);
+    const double h = before->clock.getTimeStep() * before->clock.getTimeScale();
+    double offsetTicks = h > 0.0 ? std::round((time - before->clock.getCurrentTime()) / h) : 0.0;
+    uint64_t offset = static_cast<uint64_t>(std::max(0.0, offsetTicks));
+    const Keyframe* after = history.findAfter(before->tick);
+    if (after) offset = std::min(offset, after->tick - before->tick);
+    const uint64_t target = before->tick + offset;
+
+    if (after && target == after->tick) {
+        restoreKeyframe(*after);
+    } else if (after && history.getConfig().reverseReplay && after->tick - target < offset && !after->keplerian &&
+               after->method == IntegrationMethod::VELOCITY_VERLET && !regularizeEncounters) {
+        /*--- Backward from the next keyframe ---*/
+        restoreKeyframe(*after);
+        const double dt = timeSystem.getTimeStep();
+        const double clockStep = dt * timeSystem.getTimeScale();
+        std::vector<BodyState> previous = bodyStates;
+        for (auto& s : previous) s.position = verletPreviousPosition(s, dt);
+        for (uint64_t k = after->tick; k > target; --k) {
+            reverseVerletSweep(bodyStates, previous, dt);
+            timeSystem.setCurrentTime(timeSystem.getCurrentTime() - clockStep);
+            timeSystem.setTickCount(k - 1);
+            ++result.steps;
+        }
+        result.backward = true;
+        historyApproximate = true;
+        // Flares only advance forward; rewind them to the keyframe before
+        if (star) star->restoreFlareSchedule(before->flares);
+    } else {
+        /*--- Forward replay ---*/
+        restoreKeyframe(*before);
+        if (useKeplerianOrbits && numericalBodies.empty()) {
+            // Nothing to integrate: tick the clock alone (same rounding as step());
+            // flares and secular elements are caught up below
+            for (uint64_t k = 0; k < offset; ++k) timeSystem.tick();
+        } else {
+            for (uint64_t k = 0; k < offset; ++k) step();
+            result.steps = offset;
+        }
+    }
+
+    // Star activity and secular elements are functions of time, backward seeks included
+    if (star) star->advanceActivity(timeSystem.getCurrentTime());
+    if (secular) syncSecularOrbits();
+
+    result.ok = true;
+    result.exact = !result.backward;
+    result.time = timeSystem.getCurrentTime();
+    result.tick = timeSystem.getTickCount();
+    return result;
+}
+
+bool SolarSystem::computeOsculatingElements(int centralBodyId, ElementArrays& out) const {
+    auto central = std::find_if(bodyStates.begin(), bodyStates.end(),
+                                [&](const BodyState& s) { return s.id == centralBodyId; });
+    if (central == bodyStates.end()) return false;
+
+    // Gather relative states into SoA for the batch kernel
+    size_t n = bodyStates.size();
+    std::vector<double> soa(7 * n);
+    double* x = soa.data();
+    double* y = x + n;
+    double* z = y + n;
+    double* vx = z + n;
+    double* vy = vx + n;
+    double* vz = vy + n;
+    double* mu = vz + n;
+    for (size_t i = 0; i < n; ++i) {
+        const BodyState& s = bodyStates[i];
+        x[i] = s.position.x - central->position.x;
+        y[i] = s.position.y - central->position.y;
+        z[i] = s.position.z - central->position.z;
+        vx[i] = s.velocity.x - central->velocity.x;
+        vy[i] = s.velocity.y - central->velocity.y;
+        vz[i] = s.velocity.z - central->velocity.z;
+        mu[i] = PhysicsConstants::G * (central->mass + s.mass);
+    }
+
+    OrbitUtils::stateToElementsBatch(x, y, z, vx, vy, vz, mu, n, out);
+    return true;
+}
+
+size_t SolarSystem::reseedOrbitsFromStates(int centralBodyId) {
+    ElementArrays elements;
+    if (!computeOsculatingElements(centralBodyId, elements)) return 0;
+
+    double centralMass = 0.0;
+    for (const auto& s : bodyStates) {
+        if (s.id == centralBodyId) centralMass = s.mass;
+    }
+
+    double t = timeSystem.getCurrentTime();
+    size_t written = 0;
+    for (size_t i = 0; i < bodyStates.size(); ++i) {
+        const BodyState& s = bodyStates[i];
+        if (s.id == centralBodyId) continue;
+        orbits[s.id] = Orbit(elements.get(i, t), centralMass + s.mass);
+        ++written;
+    }
+
+    // Numerical bodies stay integrated, in the central body's frame like the orbits
+    Vec3 centralPosition, centralVelocity;
+    for (const auto& s : bodyStates) {
+        if (s.id != centralBodyId) continue;
+        centralPosition = s.position;
+        centralVelocity = s.velocity;
+    }
+    for (auto& s : bodyStates) {
+        if (!numericalBodies.count(s.id)) continue;
+        s.position -= centralPosition;
+        s.velocity -= centralVelocity;
+    }
+    hybridAccelerationsStale = true;
+
+    keplerCache.clear();
+    ++orbitGeneration;
+    return written;
+}
+
 namespace SolarSystemUtils {
 
     // Initialize body states from celestial bodies for N-body simulation
     void initializeBodyStates(SolarSystem& system, std::vector<BodyState>& states) {
-        states.clear();
-        
-        // Add star at origin
-        if (system.getStar()) {
-            BodyState starState;
-            starState.id = system.getStar()->getId();
-            starState.mass = system.getStar()->getMass();
-            starState.position = Vec3(0, 0, 0);
-            starState.velocity = Vec3(0, 0, 0);
-            starState.acceleration = Vec3(0, 0, 0);
-            states.push_back(starState);
-        }
-        
-        // Planets would be added here with their positions from orbits
-        // This requires accessing the private orbits map, so would need
-        // to be a friend function or member method
+        system.initializeBodyStates(true);
+        states = system.getBodyStates();
     }
 
     // Find closest approach between two bodies
@@ -0,0 +1,381 @@
+#include "../../include/simulation/SpatialIndex.h"
+#include "../../include/simulation/SolarSystem.h"
+#include "../../include/simulation/WorkStealingPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+    constexpr uint32_t LEAF_SIZE = 8;
+    constexpr size_t MAX_DEPTH = 64;
+
+    // Squared distance from p to an axis-aligned box (0 inside)
+    inline double boxDistanceSq(const double* lo, const double* hi, double x, double y, double z) {
+        double dx = x < lo[0] ? lo[0] - x : (x > hi[0] ? x - hi[0] : 0.0);
+        double dy = y < lo[1] ? lo[1] - y : (y > hi[1] ? y - hi[1] : 0.0);
+        double dz = z < lo[2] ? lo[2] - z : (z > hi[2] ? z - hi[2] : 0.0);
+        return dx*dx + dy*dy + dz*dz;
+    }
+
+    // Runs query(i, hits) for every i and flattens the hit lists in query order.
+    // With a pool, each worker appends to its own buffer and records spans.
+    template <typename Query>
+    void runBatch(size_t count, WorkStealingPool* pool, SpatialQueryResults& out, const Query& query) {
+        out.offsets.assign(1, 0);
+        out.hits.clear();
+        out.offsets.reserve(count + 1);
+
+        if (!pool || pool->getThreadCount() < 2 || count < 2) {
+            std::vector<SpatialHit> scratch;
+            for (size_t i = 0; i < count; ++i) {
+                query(i, scratch);
+                out.hits.insert(out.hits.end(), scratch.begin(), scratch.end());
+                out.offsets.push_back(out.hits.size());
+            }
+            return;
+        }
+
+        struct Span { unsigned worker; size_t start; size_t count; };
+        unsigned workers = pool->getThreadCount();
+        std::vector<std::vector<SpatialHit>> buffers(workers), scratch(workers);
+        std::vector<Span> spans(count);
+
+        pool->parallelFor(count, std::max<size_t>(1, count / (8 * workers)),
+                          [&](size_t begin, size_t end, unsigned worker) {
+            auto& buffer = buffers[worker];
+            auto& local = scratch[worker];
+            for (size_t i = begin; i < end; ++i) {
+                query(i, local);
+                spans[i] = Span{worker, buffer.size(), local.size()};
+                buffer.insert(buffer.end(), local.begin(), local.end());
+            }
+        });
+
+        for (const Span& s : spans) {
+            const auto& buffer = buffers[s.worker];
+            out.hits.insert(out.hits.end(), buffer.begin() + s.start, buffer.begin() + s.start + s.count);
+            out.offsets.push_back(out.hits.size());
+        }
+    }
+}
+
+/*--- Construction ---*/
+
+void SpatialSnapshot::build(const std::vector<BodyState>& states) {
+    uint32_t n = static_cast<uint32_t>(states.size());
+    px.resize(n); py.resize(n); pz.resize(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        px[i] = states[i].position.x;
+        py[i] = states[i].position.y;
+        pz[i] = states[i].position.z;
+    }
+    order.resize(n);
+    std::iota(order.begin(), order.end(), 0u);
+
+    // Topology first (on original-order coordinates), then permute into leaf order
+    nodes.clear();
+    if (n > 0) {
+        nodes.reserve(2 * (n / LEAF_SIZE) + 1);
+        nodes.push_back(Node{});
+        buildNode(0, 0, n);
+    }
+
+    std::vector<double> tmp(n);
+    for (std::vector<double>* axis : {&px, &py, &pz}) {
+        for (uint32_t k = 0; k < n; ++k) tmp[k] = (*axis)[order[k]];
+        axis->swap(tmp);
+    }
+    ids.resize(n);
+    for (uint32_t k = 0; k < n; ++k) ids[k] = states[order[k]].id;
+
+    for (size_t i = nodes.size(); i-- > 0;) computeBounds(nodes[i]);
+    builtExtent = leafExtent();
+}
+
+void SpatialSnapshot::buildNode(uint32_t node, uint32_t begin, uint32_t end) {
+    nodes[node].begin = begin;
+    nodes[node].end = end;
+    nodes[node].left = 0;
+    if (end - begin <= LEAF_SIZE) return;
+
+    // Split the widest axis at the median
+    const std::vector<double>* axes[3] = {&px, &py, &pz};
+    int axis = 0;
+    double widest = -1.0;
+    for (int a = 0; a < 3; ++a) {
+        const std::vector<double>& c = *axes[a];
+        double lo = c[order[begin]], hi = lo;
+        for (uint32_t k = begin + 1; k < end; ++k) {
+            double v = c[order[k]];
+            lo = v < lo ? v : lo;
+            hi = v > hi ? v : hi;
+        }
+        if (hi - lo > widest) {
+            widest = hi - lo;
+            axis = a;
+        }
+    }
+
+    const std::vector<double>& c = *axes[axis];
+    uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+                     [&](uint32_t l, uint32_t r) { return c[l] < c[r]; });
+
+    uint32_t left = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(Node{});
+    nodes.push_back(Node{});
+    nodes[node].left = left;
+    buildNode(left, begin, mid);
+    buildNode(left + 1, mid, end);
+}
+
+void SpatialSnapshot::refit(const SpatialSnapshot& topology, const std::vector<BodyState>& states) {
+    if (this != &topology) {
+        nodes = topology.nodes;
+        order = topology.order;
+        ids = topology.ids;
+        builtExtent = topology.builtExtent;
+    }
+    size_t n = order.size();
+    px.resize(n); py.resize(n); pz.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        const Vec3& p = states[order[k]].position;
+        px[k] = p.x;
+        py[k] = p.y;
+        pz[k] = p.z;
+    }
+    // Children always follow their parent, so a reverse sweep is bottom-up
+    for (size_t i = nodes.size(); i-- > 0;) computeBounds(nodes[i]);
+}
+
+void SpatialSnapshot::computeBounds(Node& node) const {
+    if (node.left) {
+        const Node& l = nodes[node.left];
+        const Node& r = nodes[node.left + 1];
+        for (int a = 0; a < 3; ++a) {
+            node.lo[a] = std::min(l.lo[a], r.lo[a]);
+            node.hi[a] = std::max(l.hi[a], r.hi[a]);
+        }
+        return;
+    }
+
+    const std::vector<double>* axes[3] = {&px, &py, &pz};
+    for (int a = 0; a < 3; ++a) {
+        const double* c = axes[a]->data();
+        double lo = c[node.begin], hi = lo;
+        for (uint32_t k = node.begin + 1; k < node.end; ++k) {
+            lo = c[k] < lo ? c[k] : lo;
+            hi = c[k] > hi ? c[k] : hi;
+        }
+        node.lo[a] = lo;
+        node.hi[a] = hi;
+    }
+}
+
+double SpatialSnapshot::leafExtent() const {
+    double sum = 0.0;
+    for (const Node& node : nodes) {
+        if (node.left) continue;
+        sum += (node.hi[0] - node.lo[0]) + (node.hi[1] - node.lo[1]) + (node.hi[2] - node.lo[2]);
+    }
+    return sum;
+}
+
+/*--- Single queries ---*/
+
+void SpatialSnapshot::radius(const Vec3& center, double r, std::vector<SpatialHit>& out) const {
+    out.clear();
+    if (nodes.empty() || !(r >= 0.0)) return;
+
+    double r2 = r * r;
+    uint32_t stack[MAX_DEPTH];
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+        if (boxDistanceSq(node.lo, node.hi, center.x, center.y, center.z) > r2) continue;
+
+        if (node.left) {
+            stack[top++] = node.left;
+            stack[top++] = node.left + 1;
+            continue;
+        }
+        for (uint32_t k = node.begin; k < node.end; ++k) {
+            double dx = px[k] - center.x, dy = py[k] - center.y, dz = pz[k] - center.z;
+            double d2 = dx*dx + dy*dy + dz*dz;
+            if (d2 <= r2) out.push_back(SpatialHit{ids[k], order[k], std::sqrt(d2)});
+        }
+    }
+}
+
+void SpatialSnapshot::nearest(const Vec3& point, size_t k, std::vector<SpatialHit>& out) const {
+    out.clear();
+    if (nodes.empty() || k == 0) return;
+
+    // Bounded max-heap of (squared distance, slot)
+    std::vector<std::pair<double, uint32_t>> best;
+    best.reserve(k + 1);
+    auto worst = [&]() { return best.size() < k ? INFINITY : best.front().first; };
+
+    struct Pending { uint32_t node; double distanceSq; };
+    Pending stack[MAX_DEPTH * 2];
+    size_t top = 0;
+    stack[top++] = Pending{0, 0.0};
+
+    while (top > 0) {
+        Pending p = stack[--top];
+        if (p.distanceSq > worst()) continue;
+
+        const Node& node = nodes[p.node];
+        if (node.left) {
+            // Visit the nearer child first: push it last
+            const Node& l = nodes[node.left];
+            const Node& r = nodes[node.left + 1];
+            double dl = boxDistanceSq(l.lo, l.hi, point.x, point.y, point.z);
+            double dr = boxDistanceSq(r.lo, r.hi, point.x, point.y, point.z);
+            if (dl <= dr) {
+                stack[top++] = Pending{node.left + 1, dr};
+                stack[top++] = Pending{node.left, dl};
+            } else {
+                stack[top++] = Pending{node.left, dl};
+                stack[top++] = Pending{node.left + 1, dr};
+            }
+            continue;
+        }
+        for (uint32_t s = node.begin; s < node.end; ++s) {
+            double dx = px[s] - point.x, dy = py[s] - point.y, dz = pz[s] - point.z;
+            double d2 = dx*dx + dy*dy + dz*dz;
+            if (d2 >= worst()) continue;
+            best.emplace_back(d2, s);
+            std::push_heap(best.begin(), best.end());
+            if (best.size() > k) {
+                std::pop_heap(best.begin(), best.end());
+                best.pop_back();
+            }
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end());
+    out.reserve(best.size());
+    for (const auto& [d2, s] : best) out.push_back(SpatialHit{ids[s], order[s], std::sqrt(d2)});
+}
+
+void SpatialSnapshot::cone(const SpatialCone& query, std::vector<SpatialHit>& out) const {
+    out.clear();
+    double dirLength = query.direction.magnitude();
+    if (nodes.empty() || !(dirLength > 0.0) || !(query.range >= 0.0)) return;
+
+    Vec3 d = query.direction / dirLength;
+    const Vec3& apex = query.apex;
+    double cosT = std::cos(query.halfAngle), sinT = std::sin(query.halfAngle);
+    bool prunesByAngle = query.halfAngle < 0.5 * M_PI;
+    double range2 = query.range * query.range;
+
+    uint32_t stack[MAX_DEPTH];
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+
+        // Bounding sphere of the box against range and the cone surface
+        Vec3 c(0.5 * (node.lo[0] + node.hi[0]), 0.5 * (node.lo[1] + node.hi[1]), 0.5 * (node.lo[2] + node.hi[2]));
+        Vec3 half(0.5 * (node.hi[0] - node.lo[0]), 0.5 * (node.hi[1] - node.lo[1]), 0.5 * (node.hi[2] - node.lo[2]));
+        double sphere = half.magnitude();
+        Vec3 v = c - apex;
+        double dist = v.magnitude();
+        if (dist - sphere > query.range) continue;
+        if (prunesByAngle) {
+            double a = v.dot(d);
+            double b = std::sqrt(std::max(dist * dist - a * a, 0.0));
+            // Distance to the lateral surface in the (axial, radial) half-plane, or to the apex behind it
+            double surface = (a * cosT + b * sinT >= 0.0) ? b * cosT - a * sinT : dist;
+            if (surface > sphere) continue;
+        }
+
+        if (node.left) {
+            stack[top++] = node.left;
+            stack[top++] = node.left + 1;
+            continue;
+        }
+        for (uint32_t k = node.begin; k < node.end; ++k) {
+            double dx = px[k] - apex.x, dy = py[k] - apex.y, dz = pz[k] - apex.z;
+            double d2 = dx*dx + dy*dy + dz*dz;
+            if (d2 > range2 || d2 == 0.0) continue;
+            double r = std::sqrt(d2);
+            if (dx * d.x + dy * d.y + dz * d.z >= cosT * r) out.push_back(SpatialHit{ids[k], order[k], r});
+        }
+    }
+}
+
+/*--- Batch queries ---*/
+
+void SpatialSnapshot::radiusBatch(const std::vector<Vec3>& centers, double r, SpatialQueryResults& out,
+                                  WorkStealingPool* pool) const {
+    runBatch(centers.size(), pool, out, [&](size_t i, std::vector<SpatialHit>& hits) { radius(centers[i], r, hits); });
+}
+
+void SpatialSnapshot::nearestBatch(const std::vector<Vec3>& points, size_t k, SpatialQueryResults& out,
+                                   WorkStealingPool* pool) const {
+    runBatch(points.size(), pool, out, [&](size_t i, std::vector<SpatialHit>& hits) { nearest(points[i], k, hits); });
+}
+
+void SpatialSnapshot::coneBatch(const std::vector<SpatialCone>& queries, SpatialQueryResults& out,
+                                WorkStealingPool* pool) const {
+    runBatch(queries.size(), pool, out, [&](size_t i, std::vector<SpatialHit>& hits) { cone(queries[i], hits); });
+}
+
+/*--- Publisher ---*/
+
+void SpatialIndex::update(const std::vector<BodyState>& states, double time, uint64_t tick) {
+    const SpatialSnapshot* previous = front.tree.get();
+    bool sameLayout = previous && previous->size() == states.size();
+    for (size_t k = 0; sameLayout && k < states.size(); ++k) {
+        sameLayout = states[previous->order[k]].id == previous->ids[k];
+    }
+
+    // Recycle the older buffer only once its published handle is gone
+    Buffer target;
+    if (back.tree && back.retired->load(std::memory_order_acquire)) {
+        target = back;
+        target.retired->store(false, std::memory_order_relaxed);
+    } else {
+        target = {std::make_shared<SpatialSnapshot>(), std::make_shared<std::atomic<bool>>(false)};
+    }
+    SpatialSnapshot& tree = *target.tree;
+
+    bool refitted = false;
+    if (sameLayout) {
+        tree.refit(*previous, states);
+        refitted = tree.leafExtent() <= rebuildThreshold * tree.builtExtent;
+    }
+    if (refitted) {
+        ++refitCount;
+    } else {
+        tree.build(states);
+        ++rebuildCount;
+    }
+    tree.time = time;
+    tree.tick = tick;
+
+    // The handle keeps the tree alive past the index and hands it back after
+    // the last reader lets go
+    std::shared_ptr<const SpatialSnapshot> published(
+        target.tree.get(), [owner = target.tree, retired = target.retired](const SpatialSnapshot*) {
+            retired->store(true, std::memory_order_release);
+        });
+    std::atomic_store(&current, std::move(published));
+    back = std::move(front);
+    front = std::move(target);
+}
+
+void SpatialIndex::update(SolarSystem& system) {
+    if (system.isUsingKeplerianOrbits()) system.syncBodyStatesFromOrbits();
+    const TimeSystem& clock = system.getTimeSystem();
+    update(system.getBodyStates(), clock.getCurrentTime(), clock.getTickCount());
+}
+
+std::shared_ptr<const SpatialSnapshot> SpatialIndex::snapshot() const {
+    return std::atomic_load(&current);
+}
@@ -0,0 +1,247 @@
+#include "../../include/simulation/TransferMatrix.h"
+#include "../../include/simulation/SolarSystem.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    constexpr double INF = std::numeric_limits<double>::infinity();
+    constexpr double TWO_PI = 2.0 * M_PI;
+
+    double wrapPositive(double angle) {
+        angle = std::fmod(angle, TWO_PI);
+        return angle < 0.0 ? angle + TWO_PI : angle;
+    }
+
+    // Lead of the target over the origin at departure so that it arrives at
+    // the Hohmann apse (negative for inbound transfers)
+    double hohmannPhase(double a1, double a2) {
+        return M_PI * (1.0 - std::pow((a1 + a2) / (2.0 * a2), 1.5));
+    }
+}
+
+double TransferLeg::waitAt(double t) const {
+    if (!std::isfinite(windowTime)) return INF;
+    double wait = windowTime - t;
+    if (std::isfinite(synodicPeriod)) {
+        wait = std::fmod(wait, synodicPeriod);
+        if (wait < 0.0) wait += synodicPeriod;
+    }
+    return std::max(0.0, wait);
+}
+
+/*--- Constructors ---*/
+
+TransferMatrix::TransferMatrix(const std::vector<int>& bodyIds_, const TransferMatrixConfig& config_)
+    : config(config_), bodyIds(bodyIds_), initialized(false), orbitGeneration(0), version(0), refreshes(0),
+      lastUpdate(0.0), routeVersion(0), routeMetric(RouteMetric::DELTA_V), routeBudget(INF) {
+    for (size_t k = 0; k < bodyIds.size(); ++k) bodyIndex.emplace(bodyIds[k], k);
+    legs.resize(bodyIds.size() * bodyIds.size());
+    samples.resize(bodyIds.size());
+    sampleTime.assign(bodyIds.size(), std::nan(""));
+}
+
+/*--- Maintenance ---*/
+
+const TransferMatrix::BodySample& TransferMatrix::sample(const SolarSystem& system, size_t body, double t) {
+    BodySample& s = samples[body];
+    if (sampleTime[body] == t) return s;
+    sampleTime[body] = t;
+
+    const int id = bodyIds[body];
+    Vec3 r = system.getBodyPosition(id);
+    Vec3 v = system.getBodyVelocity(id);
+    double starMass = PhysicsConstants::SOLAR_MASS;
+    if (const Star* star = system.getStar()) {
+        r -= system.getBodyPosition(star->getId());
+        v -= system.getBodyVelocity(star->getId());
+        starMass = star->getMass();
+    }
+    const CelestialBody* celestial = system.findBody(id);
+    s.mu = PhysicsConstants::G * (starMass + (celestial ? celestial->getMass() : 0.0));
+
+    // Osculating semi-major axis (vis-viva); unbound bodies get no transfers
+    double radius = r.magnitude();
+    double inverseA = 2.0 / radius - v.magnitudeSquared() / s.mu;
+    s.semiMajorAxis = inverseA > 0.0 ? 1.0 / inverseA : INF;
+    s.longitude = std::atan2(r.y, r.x);
+    double meanMotion = std::isfinite(s.semiMajorAxis) ? std::sqrt(s.mu / std::pow(s.semiMajorAxis, 3)) : 0.0;
+    s.meanMotion = r.cross(v).z < 0.0 ? -meanMotion : meanMotion;
+    return s;
+}
+
+void TransferMatrix::refreshPair(const SolarSystem& system, size_t i, size_t j, double t) {
+    const BodySample& si = sample(system, i, t);
+    const BodySample& sj = sample(system, j, t);
+    const size_t n = bodyIds.size();
+    const bool bound = std::isfinite(si.semiMajorAxis) && std::isfinite(sj.semiMajorAxis);
+    const double rate = sj.meanMotion - si.meanMotion;     // d(lon_j - lon_i)/dt
+    const double synodic = rate != 0.0 ? TWO_PI / std::abs(rate) : INF;
+
+    double refreshAt = t + config.maxRefresh;
+    auto evaluate = [&](const BodySample& from, const BodySample& to, double lead, TransferLeg& leg) {
+        leg.computedAt = t;
+        leg.synodicPeriod = synodic;
+        if (!bound) {
+            leg.deltaV = leg.transferTime = leg.windowTime = INF;
+            return;
+        }
+        leg.deltaV = SolarSystemUtils::hohmannTransferDeltaV(from.mu, from.semiMajorAxis, to.semiMajorAxis);
+        leg.transferTime = SolarSystemUtils::hohmannTransferTime(from.mu, from.semiMajorAxis, to.semiMajorAxis);
+
+        // Lead (target minus origin longitude) moves at leadRate; wait until it
+        // reaches the Hohmann phase
+        double target = hohmannPhase(from.semiMajorAxis, to.semiMajorAxis);
+        double leadRate = to.meanMotion - from.meanMotion;
+        double wait = INF;
+        if (leadRate > 0.0) wait = wrapPositive(target - lead) / leadRate;
+        else if (leadRate < 0.0) wait = wrapPositive(lead - target) / -leadRate;
+        leg.windowTime = t + wait;
+
+        double interval = std::min(config.refreshFraction * synodic, 0.5 * wait);
+        interval = std::clamp(interval, config.minRefresh, config.maxRefresh);
+        refreshAt = std::min(refreshAt, t + interval);
+    };
+
+    double lead = sj.longitude - si.longitude;
+    evaluate(si, sj, lead, legs[i * n + j]);
+    evaluate(sj, si, -lead, legs[j * n + i]);
+    legs[i * n + j].refreshAt = legs[j * n + i].refreshAt = refreshAt;
+
+    queue.push({refreshAt, static_cast<uint32_t>(i), static_cast<uint32_t>(j)});
+    ++refreshes;
+    ++version;
+}
+
+void TransferMatrix::refreshAll(const SolarSystem& system) {
+    const double t = system.getTimeSystem().getCurrentTime();
+    queue = decltype(queue)();
+    // Samples at this same time may predate a reseed
+    std::fill(sampleTime.begin(), sampleTime.end(), std::nan(""));
+    for (size_t i = 0; i < bodyIds.size(); ++i) {
+        for (size_t j = i + 1; j < bodyIds.size(); ++j) refreshPair(system, i, j, t);
+    }
+    initialized = true;
+    orbitGeneration = system.getOrbitGeneration();
+    lastUpdate = t;
+}
+
+size_t TransferMatrix::update(const SolarSystem& system) {
+    const double t = system.getTimeSystem().getCurrentTime();
+    // Reseeded orbits or a jump back in time invalidate every window
+    if (!initialized || system.getOrbitGeneration() != orbitGeneration || t < lastUpdate) {
+        uint64_t before = refreshes;
+        refreshAll(system);
+        return static_cast<size_t>(refreshes - before);
+    }
+
+    size_t count = 0;
+    while (!queue.empty() && queue.top().time <= t) {
+        Due due = queue.top();
+        queue.pop();
+        refreshPair(system, due.from, due.to, t);
+        ++count;
+    }
+    lastUpdate = t;
+    return count;
+}
+
+/*--- Lookup ---*/
+
+const TransferLeg* TransferMatrix::find(int from, int to) const {
+    auto a = bodyIndex.find(from);
+    auto b = bodyIndex.find(to);
+    if (a == bodyIndex.end() || b == bodyIndex.end() || a->second == b->second) return nullptr;
+    return &legs[a->second * bodyIds.size() + b->second];
+}
+
+double TransferMatrix::getDeltaV(int from, int to) const {
+    const TransferLeg* leg = find(from, to);
+    return leg ? leg->deltaV : INF;
+}
+
+double TransferMatrix::getTransferTime(int from, int to) const {
+    const TransferLeg* leg = find(from, to);
+    return leg ? leg->transferTime : INF;
+}
+
+double TransferMatrix::getTravelTime(int from, int to, double t) const {
+    const TransferLeg* leg = find(from, to);
+    return leg ? leg->waitAt(t) + leg->transferTime : INF;
+}
+
+/*--- Multi-hop routes ---*/
+
+void TransferMatrix::solveRoutes(RouteMetric metric, double maxLegDeltaV) {
+    const size_t n = bodyIds.size();
+    routeCost.assign(n * n, INF);
+    routeNext.assign(n * n, -1);
+    for (size_t i = 0; i < n; ++i) {
+        routeCost[i * n + i] = 0.0;
+        routeNext[i * n + i] = static_cast<int32_t>(i);
+        for (size_t j = 0; j < n; ++j) {
+            const TransferLeg& leg = legs[i * n + j];
+            if (i == j || !(leg.deltaV <= maxLegDeltaV)) continue;
+            routeCost[i * n + j] = metric == RouteMetric::DELTA_V ? leg.deltaV : leg.transferTime;
+            routeNext[i * n + j] = static_cast<int32_t>(j);
+        }
+    }
+
+    for (size_t k = 0; k < n; ++k) {
+        const double* viaRow = &routeCost[k * n];
+        for (size_t i = 0; i < n; ++i) {
+            double toVia = routeCost[i * n + k];
+            if (!std::isfinite(toVia)) continue;
+            double* row = &routeCost[i * n];
+            int32_t* next = &routeNext[i * n];
+            for (size_t j = 0; j < n; ++j) {
+                double candidate = toVia + viaRow[j];
+                if (candidate < row[j]) {
+                    row[j] = candidate;
+                    next[j] = next[k];
+                }
+            }
+        }
+    }
+
+    routeVersion = version;
+    routeMetric = metric;
+    routeBudget = maxLegDeltaV;
+}
+
+void TransferMatrix::findRoutes(const std::vector<RouteQuery>& queries, std::vector<Route>& out,
+                                RouteMetric metric, double maxLegDeltaV) {
+    if (routeCost.empty() || routeVersion != version || routeMetric != metric || routeBudget != maxLegDeltaV) {
+        solveRoutes(metric, maxLegDeltaV);
+    }
+
+    const size_t n = bodyIds.size();
+    out.assign(queries.size(), Route());
+    for (size_t q = 0; q < queries.size(); ++q) {
+        auto a = bodyIndex.find(queries[q].from);
+        auto b = bodyIndex.find(queries[q].to);
+        if (a == bodyIndex.end() || b == bodyIndex.end()) continue;
+
+        size_t at = a->second;
+        const size_t goal = b->second;
+        if (routeNext[at * n + goal] < 0) continue;
+
+        Route& route = out[q];
+        route.found = true;
+        route.bodies.push_back(bodyIds[at]);
+        while (at != goal) {
+            size_t next = static_cast<size_t>(routeNext[at * n + goal]);
+            const TransferLeg& leg = legs[at * n + next];
+            route.deltaV += leg.deltaV;
+            route.transferTime += leg.transferTime;
+            route.bodies.push_back(bodyIds[next]);
+            at = next;
+        }
+    }
+}
+
+Route TransferMatrix::findRoute(int from, int to, RouteMetric metric, double maxLegDeltaV) {
+    std::vector<Route> out;
+    findRoutes({{from, to}}, out, metric, maxLegDeltaV);
+    return out.front();
+}
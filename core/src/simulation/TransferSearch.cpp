@@ -0,0 +1,211 @@
+#include "../../include/simulation/TransferSearch.h"
+#include "../../include/simulation/WorkStealingPool.h"
+#include "../../include/time/TimeSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+    /*--- Arrival ephemeris: states on a uniform time grid, cubic Hermite in between ---*/
+    // Position uses (r, v) at both nodes; velocity uses (v, a) with the two-body
+    // acceleration, so both are fourth order in the node spacing.
+    class EphemerisTable {
+    private:
+        double t0;
+        double h;
+        double mu;
+        std::vector<Vec3> positions;
+        std::vector<Vec3> velocities;
+        std::vector<Vec3> accelerations;
+
+    public:
+        EphemerisTable(const Orbit& orbit, double start, double end, double spacing)
+            : t0(start), h(spacing), mu(orbit.getMu()) {
+            size_t nodes = static_cast<size_t>(std::ceil((end - start) / h)) + 2;
+            positions.resize(nodes);
+            velocities.resize(nodes);
+            accelerations.resize(nodes);
+            for (size_t k = 0; k < nodes; ++k) {
+                orbit.getStateAtTime(t0 + k * h, positions[k], velocities[k]);
+                double r = positions[k].magnitude();
+                accelerations[k] = positions[k] * (-mu / (r * r * r));
+            }
+        }
+
+        void stateAt(double t, Vec3& position, Vec3& velocity) const {
+            double u = (t - t0) / h;
+            size_t k = std::min(static_cast<size_t>(std::max(0.0, std::floor(u))), positions.size() - 2);
+            double s = u - k;
+
+            double s2 = s * s, s3 = s2 * s;
+            double h00 = 2*s3 - 3*s2 + 1, h10 = s3 - 2*s2 + s;
+            double h01 = -2*s3 + 3*s2,    h11 = s3 - s2;
+
+            position = positions[k] * h00 + velocities[k] * (h10 * h) + positions[k+1] * h01 + velocities[k+1] * (h11 * h);
+            velocity = velocities[k] * h00 + accelerations[k] * (h10 * h) + velocities[k+1] * h01 + accelerations[k+1] * (h11 * h);
+        }
+    };
+
+    double vInf(const Vec3& transfer, const Vec3& planet) {
+        return (transfer - planet).magnitude();
+    }
+}
+
+TransferSearch::TransferSearch(const Orbit& from, const Orbit& to, WorkStealingPool* pool_)
+    : departure(from), arrival(to), mu(from.getMu()), pool(pool_) {}
+
+TransferCandidate TransferSearch::evaluate(double launchTime, double timeOfFlight, bool prograde) const {
+    TransferCandidate c;
+    c.launchTime = launchTime;
+    c.timeOfFlight = timeOfFlight;
+
+    Vec3 r1, vp1, r2, vp2;
+    departure.getStateAtTime(launchTime, r1, vp1);
+    arrival.getStateAtTime(launchTime + timeOfFlight, r2, vp2);
+
+    LambertSolution s = LambertSolver::solve(r1, r2, timeOfFlight, mu, prograde);
+    if (!s.valid) return c;
+
+    c.departureVInf = vInf(s.departureVelocity, vp1);
+    c.arrivalVInf = vInf(s.arrivalVelocity, vp2);
+    c.totalDeltaV = c.departureVInf + c.arrivalVInf;
+    c.departureVelocity = s.departureVelocity;
+    c.valid = true;
+    return c;
+}
+
+PorkchopGrid TransferSearch::computeGrid(const PorkchopConfig& config) const {
+    PorkchopGrid grid;
+    grid.config = config;
+    const size_t rows = config.launchSteps;
+    const size_t cols = config.tofSteps;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    grid.departureVInf.assign(rows * cols, nan);
+    grid.arrivalVInf.assign(rows * cols, nan);
+    if (rows == 0 || cols == 0) return grid;
+
+    // Node spacing: grid resolution, but never coarser than 1/720 of the arrival period
+    double spacing = arrival.getPeriod() / 720.0;
+    if (config.launchStep() > 0.0) spacing = std::min(spacing, config.launchStep());
+    if (config.tofStep() > 0.0) spacing = std::min(spacing, config.tofStep());
+    double firstArrival = config.launchStart + config.tofMin;
+    double lastArrival = config.launchEnd + config.tofMax;
+    spacing = std::max(spacing, (lastArrival - firstArrival) / 4.0e6);
+    if (!(spacing > 0.0)) spacing = TimeConstants::DAY;
+    EphemerisTable table(arrival, firstArrival, lastArrival, spacing);
+
+    auto runRows = [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            double launch = grid.launchTime(i);
+            Vec3 r1, vp1;
+            departure.getStateAtTime(launch, r1, vp1);
+
+            double warm = 0.0;
+            bool haveWarm = false;
+            for (size_t j = 0; j < cols; ++j) {
+                double tof = grid.timeOfFlight(j);
+                if (!(tof > 0.0)) continue;
+
+                Vec3 r2, vp2;
+                table.stateAt(launch + tof, r2, vp2);
+                LambertSolution s = LambertSolver::solve(r1, r2, tof, mu, config.prograde, warm, haveWarm);
+                if (!s.valid && haveWarm) {
+                    s = LambertSolver::solve(r1, r2, tof, mu, config.prograde);
+                }
+                haveWarm = s.valid;
+                if (!s.valid) continue;
+
+                warm = s.x;
+                size_t k = grid.index(i, j);
+                grid.departureVInf[k] = vInf(s.departureVelocity, vp1);
+                grid.arrivalVInf[k] = vInf(s.arrivalVelocity, vp2);
+            }
+        }
+    };
+
+    if (pool && pool->getThreadCount() > 1) {
+        pool->parallelFor(rows, std::max<size_t>(1, rows / (8 * pool->getThreadCount())), runRows);
+    } else {
+        runRows(0, rows, 0);
+    }
+    return grid;
+}
+
+std::vector<TransferCandidate> TransferSearch::findWindows(const PorkchopConfig& config, size_t maxWindows,
+                                                           int refineLevels) const {
+    return findWindows(computeGrid(config), maxWindows, refineLevels);
+}
+
+std::vector<TransferCandidate> TransferSearch::findWindows(const PorkchopGrid& grid, size_t maxWindows,
+                                                           int refineLevels) const {
+    const PorkchopConfig& config = grid.config;
+    const size_t rows = config.launchSteps;
+    const size_t cols = config.tofSteps;
+
+    // Local minima over the 8-neighbourhood
+    struct Seed { size_t i, j; double value; };
+    std::vector<Seed> seeds;
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            double v = grid.totalDeltaV(i, j);
+            if (!std::isfinite(v)) continue;
+
+            bool minimum = true;
+            for (int di = -1; di <= 1 && minimum; ++di) {
+                for (int dj = -1; dj <= 1; ++dj) {
+                    if (di == 0 && dj == 0) continue;
+                    long ni = static_cast<long>(i) + di, nj = static_cast<long>(j) + dj;
+                    if (ni < 0 || nj < 0 || ni >= static_cast<long>(rows) || nj >= static_cast<long>(cols)) continue;
+                    double w = grid.totalDeltaV(static_cast<size_t>(ni), static_cast<size_t>(nj));
+                    if (std::isfinite(w) && w < v) { minimum = false; break; }
+                }
+            }
+            if (minimum) seeds.push_back({i, j, v});
+        }
+    }
+    std::sort(seeds.begin(), seeds.end(), [](const Seed& a, const Seed& b) { return a.value < b.value; });
+
+    std::vector<TransferCandidate> windows;
+    double launchSpan = config.launchStep();
+    double tofSpan = config.tofStep();
+
+    // Minima closer than this are treated as one window (ripples near the
+    // 180-degree ridge produce clusters of shallow minima)
+    double launchRadius = std::max(2.0 * launchSpan, 0.02 * (config.launchEnd - config.launchStart));
+    double tofRadius = std::max(2.0 * tofSpan, 0.02 * (config.tofMax - config.tofMin));
+
+    for (const Seed& seed : seeds) {
+        if (windows.size() >= maxWindows) break;
+
+        // Coarse-to-fine: 5x5 patch around the current best, halving the spacing each level
+        TransferCandidate best = evaluate(grid.launchTime(seed.i), grid.timeOfFlight(seed.j), config.prograde);
+        double dl = launchSpan, dt = tofSpan;
+        for (int level = 0; level < refineLevels && best.valid; ++level) {
+            dl *= 0.5;
+            dt *= 0.5;
+            TransferCandidate center = best;
+            for (int a = -2; a <= 2; ++a) {
+                for (int b = -2; b <= 2; ++b) {
+                    double tof = center.timeOfFlight + b * dt;
+                    if (!(tof > 0.0)) continue;
+                    TransferCandidate c = evaluate(center.launchTime + a * dl, tof, config.prograde);
+                    if (c.valid && c.totalDeltaV < best.totalDeltaV) best = c;
+                }
+            }
+        }
+        if (!best.valid) continue;
+
+        // Neighbouring seeds often refine into the same valley
+        bool duplicate = false;
+        for (const auto& w : windows) {
+            if (std::abs(w.launchTime - best.launchTime) <= launchRadius &&
+                std::abs(w.timeOfFlight - best.timeOfFlight) <= tofRadius) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (!duplicate) windows.push_back(best);
+    }
+    return windows;
+}
@@ -0,0 +1,101 @@
+#include "../../include/simulation/WorkStealingPool.h"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount)
+    : generation(0), remainingChunks(0), stopping(false) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned w = 0; w < threadCount; ++w) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (unsigned w = 0; w < threadCount; ++w) {
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, w);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (auto& t : threads) t.join();
+}
+
+void WorkStealingPool::parallelFor(size_t count, size_t grain, const Task& task) {
+    if (count == 0) return;
+    grain = std::max<size_t>(1, grain);
+
+    std::unique_lock<std::mutex> lock(jobMutex);
+    firstError = nullptr;
+    remainingChunks.store((count + grain - 1) / grain, std::memory_order_release);
+
+    // Deal chunks round-robin so every worker starts with local work
+    size_t chunkIndex = 0;
+    unsigned workers = getThreadCount();
+    for (size_t begin = 0; begin < count; begin += grain, ++chunkIndex) {
+        size_t end = std::min(count, begin + grain);
+        WorkerQueue& q = *queues[chunkIndex % workers];
+        std::lock_guard<std::mutex> queueLock(q.mutex);
+        q.chunks.push_back(Chunk{begin, end, &task});
+    }
+
+    ++generation;
+    jobReady.notify_all();
+    jobDone.wait(lock, [this] { return remainingChunks.load(std::memory_order_acquire) == 0; });
+
+    if (firstError) std::rethrow_exception(firstError);
+}
+
+bool WorkStealingPool::popLocal(unsigned worker, Chunk& out) {
+    WorkerQueue& q = *queues[worker];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.chunks.empty()) return false;
+    out = q.chunks.back();
+    q.chunks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned worker, Chunk& out) {
+    unsigned workers = getThreadCount();
+    for (unsigned offset = 1; offset < workers; ++offset) {
+        WorkerQueue& q = *queues[(worker + offset) % workers];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.chunks.empty()) {
+            out = q.chunks.front();
+            q.chunks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(unsigned worker) {
+    uint64_t seenGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+        }
+
+        Chunk chunk;
+        while (popLocal(worker, chunk) || steal(worker, chunk)) {
+            try {
+                (*chunk.task)(chunk.begin, chunk.end, worker);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(jobMutex);
+                if (!firstError) firstError = std::current_exception();
+            }
+
+            if (remainingChunks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(jobMutex);
+                jobDone.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,70 @@
+"""Simulation state export for the Python humanity/event layer.
+
+Wraps ``CoreSimulation`` so consumers receive structured snapshots instead of
+parsing text output. With NumPy available the arrays are zero-copy views into
+the C++ state and are re-fetched only when the engine reallocates its storage.
+"""
+
+import json
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1] / "python_c_bindings"))
+
+from core_wrapper import CoreSimulation  # noqa: E402
+
+AU = 1.495978707e11
+DAY = 86400.0
+YEAR = 31557600.0
+
+
+class StateExporter:
+    """Steps the core in batches and exposes the latest body state."""
+
+    def __init__(self, simulation=None):
+        self.sim = simulation or CoreSimulation()
+        self._generation = None
+        self._views = None
+
+    def advance(self, steps):
+        """Run ``steps`` ticks in a single C call."""
+        self.sim.step_n(steps)
+
+    def arrays(self):
+        """Return (ids, masses, positions, velocities) NumPy views."""
+        generation = self.sim.state_generation
+        if self._views is None or generation != self._generation:
+            self._views = (self.sim.ids(), self.sim.masses(),
+                           self.sim.positions(), self.sim.velocities())
+            self._generation = generation
+        return self._views
+
+    def snapshot(self):
+        """Plain-Python snapshot (copies), suitable for JSON or the AI context."""
+        bodies = [
+            {"id": body_id, "mass": mass, "position": list(pos), "velocity": list(vel)}
+            for body_id, mass, pos, vel in self.sim.read_states()
+        ]
+        return {
+            "time": self.sim.time,
+            "tick": self.sim.tick,
+            "years": self.sim.time / YEAR,
+            "bodies": bodies,
+        }
+
+    def to_json(self, indent=None):
+        return json.dumps(self.snapshot(), indent=indent)
+
+
+def main():
+    """Load the default planets, simulate one year and print the final state."""
+    repo = Path(__file__).resolve().parents[2]
+    exporter = StateExporter()
+    exporter.sim.load_planets(repo / "data" / "solar-system" / "planet.json")
+    exporter.sim.set_time_step(DAY)
+    exporter.advance(365)
+    print(exporter.to_json(indent=2))
+
+
+if __name__ == "__main__":
+    main()
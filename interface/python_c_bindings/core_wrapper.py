@@ -0,0 +1,325 @@
+"""ctypes bindings for the solarsys_core C ABI (core/include/capi/SolarSysC.h).
+
+The shared library is found via the SOLARSYS_CORE_LIB environment variable or
+the usual CMake build directories under core/. Body state is exposed without
+copying: ``positions``, ``velocities`` and ``masses`` return NumPy views into
+the engine's own state array. Views are invalidated when the body count
+changes; ``state_generation`` tells callers when to fetch fresh ones.
+
+Typical use::
+
+    sim = CoreSimulation()
+    sim.load_planets("data/solar-system/planet.json")
+    sim.set_time_step(86400.0)
+    sim.step_n(365)              # one FFI call for a whole simulated year
+    pos = sim.positions()        # (N, 3) float64 view, meters
+"""
+
+import ctypes
+import os
+import sys
+from pathlib import Path
+
+ABI_VERSION = 1
+
+OK = 0
+ERR_INVALID_ARGUMENT = -1
+ERR_IO = -2
+ERR_PARSE = -3
+ERR_STATE = -4
+
+EULER = 0
+SYMPLECTIC_EULER = 1
+VELOCITY_VERLET = 2
+RK4 = 3
+
+_REPO_ROOT = Path(__file__).resolve().parents[2]
+_LIB_NAMES = {
+    "win32": "solarsys_c.dll",
+    "darwin": "libsolarsys_c.dylib",
+}
+_BUILD_DIRS = ("build", "cmake-build-release", "cmake-build-debug")
+
+
+class SolarSysError(RuntimeError):
+    """Raised when a C ABI call returns a negative status."""
+
+    def __init__(self, status, message):
+        super().__init__(f"{message} (status {status})")
+        self.status = status
+
+
+class StateView(ctypes.Structure):
+    """Mirror of solarsys_state_view."""
+
+    _fields_ = [
+        ("base", ctypes.c_void_p),
+        ("count", ctypes.c_size_t),
+        ("stride", ctypes.c_size_t),
+        ("id_offset", ctypes.c_size_t),
+        ("mass_offset", ctypes.c_size_t),
+        ("position_offset", ctypes.c_size_t),
+        ("velocity_offset", ctypes.c_size_t),
+        ("acceleration_offset", ctypes.c_size_t),
+        ("generation", ctypes.c_uint64),
+    ]
+
+
+class EnvironmentView(ctypes.Structure):
+    """Mirror of solarsys_environment_view."""
+
+    _fields_ = [
+        ("count", ctypes.c_size_t),
+        ("ids", ctypes.POINTER(ctypes.c_int32)),
+        ("distance", ctypes.POINTER(ctypes.c_double)),
+        ("irradiance", ctypes.POINTER(ctypes.c_double)),
+        ("coma_radius", ctypes.POINTER(ctypes.c_double)),
+        ("active_tail", ctypes.POINTER(ctypes.c_uint8)),
+        ("pending_events", ctypes.c_size_t),
+    ]
+
+
+class EnvironmentEvent(ctypes.Structure):
+    """Mirror of solarsys_environment_event."""
+
+    _fields_ = [
+        ("body_id", ctypes.c_int32),
+        ("activated", ctypes.c_int32),
+        ("time", ctypes.c_double),
+        ("distance", ctypes.c_double),
+    ]
+
+
+def find_library():
+    """Return the path of the solarsys_c shared library, or raise OSError."""
+    explicit = os.environ.get("SOLARSYS_CORE_LIB")
+    if explicit:
+        return explicit
+
+    name = _LIB_NAMES.get(sys.platform, "libsolarsys_c.so")
+    for build_dir in _BUILD_DIRS:
+        candidate = _REPO_ROOT / "core" / build_dir / name
+        if candidate.exists():
+            return str(candidate)
+    raise OSError(f"{name} not found; build core/ or set SOLARSYS_CORE_LIB")
+
+
+def _bind(lib):
+    p_sys = ctypes.c_void_p
+    d3 = ctypes.POINTER(ctypes.c_double)
+    signatures = {
+        "solarsys_abi_version": (ctypes.c_int, []),
+        "solarsys_create": (p_sys, []),
+        "solarsys_destroy": (None, [p_sys]),
+        "solarsys_last_error": (ctypes.c_char_p, []),
+        "solarsys_load_planets_json": (ctypes.c_int, [p_sys, ctypes.c_char_p]),
+        "solarsys_add_body": (ctypes.c_int, [p_sys, ctypes.c_int32, ctypes.c_double, d3, d3]),
+        "solarsys_set_time_step": (ctypes.c_int, [p_sys, ctypes.c_double]),
+        "solarsys_set_integration_method": (ctypes.c_int, [p_sys, ctypes.c_int]),
+        "solarsys_set_keplerian": (ctypes.c_int, [p_sys, ctypes.c_int]),
+        "solarsys_step_n": (ctypes.c_int, [p_sys, ctypes.c_uint64]),
+        "solarsys_get_time": (ctypes.c_double, [p_sys]),
+        "solarsys_get_tick": (ctypes.c_uint64, [p_sys]),
+        "solarsys_body_count": (ctypes.c_size_t, [p_sys]),
+        "solarsys_get_state_view": (ctypes.c_int, [p_sys, ctypes.POINTER(StateView)]),
+        "solarsys_total_energy": (ctypes.c_double, [p_sys]),
+        "solarsys_configure_environment": (ctypes.c_int, [p_sys, ctypes.c_uint32, ctypes.c_double]),
+        "solarsys_get_environment_view": (ctypes.c_int, [p_sys, ctypes.POINTER(EnvironmentView)]),
+        "solarsys_take_environment_events": (
+            ctypes.c_int,
+            [p_sys, ctypes.POINTER(EnvironmentEvent), ctypes.c_size_t, ctypes.POINTER(ctypes.c_size_t)],
+        ),
+    }
+    for name, (restype, argtypes) in signatures.items():
+        fn = getattr(lib, name)
+        fn.restype = restype
+        fn.argtypes = argtypes
+    return lib
+
+
+_lib = None
+
+
+def load_library(path=None):
+    """Load (once) and return the bound shared library."""
+    global _lib
+    if _lib is None or path is not None:
+        lib = _bind(ctypes.CDLL(path or find_library()))
+        version = lib.solarsys_abi_version()
+        if version != ABI_VERSION:
+            raise OSError(f"solarsys_c ABI {version}, bindings expect {ABI_VERSION}")
+        _lib = lib
+    return _lib
+
+
+class CoreSimulation:
+    """Owns one engine instance behind the C ABI."""
+
+    def __init__(self, library_path=None):
+        self._lib = load_library(library_path)
+        self._handle = self._lib.solarsys_create()
+        if not self._handle:
+            raise MemoryError(self._lib.solarsys_last_error().decode())
+
+    def close(self):
+        if self._handle:
+            self._lib.solarsys_destroy(self._handle)
+            self._handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        try:
+            self.close()
+        except Exception:
+            pass
+
+    def _check(self, status):
+        if status != OK:
+            raise SolarSysError(status, self._lib.solarsys_last_error().decode())
+
+    # --- Setup -------------------------------------------------------------
+
+    def load_planets(self, path):
+        self._check(self._lib.solarsys_load_planets_json(self._handle, os.fsencode(path)))
+
+    def add_body(self, body_id, mass, position, velocity):
+        pos = (ctypes.c_double * 3)(*position)
+        vel = (ctypes.c_double * 3)(*velocity)
+        self._check(self._lib.solarsys_add_body(self._handle, body_id, mass, pos, vel))
+
+    def set_time_step(self, seconds):
+        self._check(self._lib.solarsys_set_time_step(self._handle, seconds))
+
+    def set_integration_method(self, method):
+        self._check(self._lib.solarsys_set_integration_method(self._handle, method))
+
+    def set_keplerian(self, enabled):
+        self._check(self._lib.solarsys_set_keplerian(self._handle, 1 if enabled else 0))
+
+    # --- Stepping ----------------------------------------------------------
+
+    def step_n(self, steps):
+        """Advance ``steps`` ticks in one call."""
+        self._check(self._lib.solarsys_step_n(self._handle, steps))
+
+    # --- Queries -----------------------------------------------------------
+
+    @property
+    def time(self):
+        return self._lib.solarsys_get_time(self._handle)
+
+    @property
+    def tick(self):
+        return self._lib.solarsys_get_tick(self._handle)
+
+    @property
+    def body_count(self):
+        return self._lib.solarsys_body_count(self._handle)
+
+    def total_energy(self):
+        return self._lib.solarsys_total_energy(self._handle)
+
+    def state_view(self):
+        view = StateView()
+        self._check(self._lib.solarsys_get_state_view(self._handle, ctypes.byref(view)))
+        return view
+
+    @property
+    def state_generation(self):
+        return self.state_view().generation
+
+    # --- Zero-copy NumPy views ----------------------------------------------
+
+    def _field(self, offset_name, columns, dtype_name):
+        import numpy as np
+
+        view = self.state_view()
+        if view.count == 0:
+            shape = (0, columns) if columns > 1 else (0,)
+            return np.empty(shape, dtype=dtype_name)
+
+        dtype = np.dtype(dtype_name)
+        offset = getattr(view, offset_name)
+        span = (view.count - 1) * view.stride + offset + columns * dtype.itemsize
+        raw = (ctypes.c_char * span).from_address(view.base)
+        if columns > 1:
+            return np.ndarray(shape=(view.count, columns), dtype=dtype, buffer=raw,
+                              offset=offset, strides=(view.stride, dtype.itemsize))
+        return np.ndarray(shape=(view.count,), dtype=dtype, buffer=raw,
+                          offset=offset, strides=(view.stride,))
+
+    def positions(self):
+        """(N, 3) float64 view of body positions in meters."""
+        return self._field("position_offset", 3, "float64")
+
+    def velocities(self):
+        """(N, 3) float64 view of body velocities in m/s."""
+        return self._field("velocity_offset", 3, "float64")
+
+    def masses(self):
+        """(N,) float64 view of body masses in kg."""
+        return self._field("mass_offset", 1, "float64")
+
+    def ids(self):
+        """(N,) int32 view of body ids."""
+        return self._field("id_offset", 1, "int32")
+
+    # --- Environment pass ---------------------------------------------------
+
+    def configure_environment(self, interval=1, hysteresis=0.1):
+        """Run the irradiance/comet pass every ``interval`` ticks (0 disables)."""
+        self._check(self._lib.solarsys_configure_environment(self._handle, interval, hysteresis))
+
+    def environment(self):
+        """Dict of zero-copy arrays: ids, distance, irradiance, coma_radius, active_tail.
+
+        The arrays alias engine memory and are only valid until the next step.
+        """
+        import numpy as np
+
+        view = EnvironmentView()
+        self._check(self._lib.solarsys_get_environment_view(self._handle, ctypes.byref(view)))
+        n = view.count
+        if n == 0:
+            empty = {"ids": "int32", "distance": "float64", "irradiance": "float64",
+                     "coma_radius": "float64", "active_tail": "uint8"}
+            return {name: np.empty(0, dtype=dtype) for name, dtype in empty.items()}
+        return {
+            "ids": np.ctypeslib.as_array(view.ids, shape=(n,)),
+            "distance": np.ctypeslib.as_array(view.distance, shape=(n,)),
+            "irradiance": np.ctypeslib.as_array(view.irradiance, shape=(n,)),
+            "coma_radius": np.ctypeslib.as_array(view.coma_radius, shape=(n,)),
+            "active_tail": np.ctypeslib.as_array(view.active_tail, shape=(n,)),
+        }
+
+    def environment_events(self):
+        """Drain tail transitions as (body_id, activated, time, distance) tuples."""
+        view = EnvironmentView()
+        self._check(self._lib.solarsys_get_environment_view(self._handle, ctypes.byref(view)))
+        if view.pending_events == 0:
+            return []
+        buffer = (EnvironmentEvent * view.pending_events)()
+        written = ctypes.c_size_t(0)
+        self._check(self._lib.solarsys_take_environment_events(
+            self._handle, buffer, view.pending_events, ctypes.byref(written)))
+        return [(e.body_id, bool(e.activated), e.time, e.distance) for e in buffer[:written.value]]
+
+    # --- Fallback without NumPy (copies) ----------------------------------
+
+    def read_states(self):
+        """Return a list of (id, mass, position, velocity) tuples."""
+        view = self.state_view()
+        states = []
+        for k in range(view.count):
+            addr = view.base + k * view.stride
+            body_id = ctypes.c_int32.from_address(addr + view.id_offset).value
+            mass = ctypes.c_double.from_address(addr + view.mass_offset).value
+            pos = tuple((ctypes.c_double * 3).from_address(addr + view.position_offset))
+            vel = tuple((ctypes.c_double * 3).from_address(addr + view.velocity_offset))
+            states.append((body_id, mass, pos, vel))
+        return states
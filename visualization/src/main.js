@@ -1,12 +1,14 @@
 import { Scene } from './scene.js';
 import { SolarSystemRenderer } from './solarSystem.js';
 import { TimeControls } from './timeControls.js';
+import { StateStream } from './stateStream.js';
 
 class App {
     constructor() {
         this.scene = null;
         this.solarSystem = null;
         this.timeControls = null;
+        this.stateStream = null;
         this.isRunning = true;
     }
 
@@ -19,6 +21,13 @@ class App {
             this.solarSystem = new SolarSystemRenderer(this.scene);
             await this.solarSystem.loadData();
             
+            // Follow the C++ core when `solarsys --serve` is running (?stream=ws://host:port)
+            const streamUrl = new URLSearchParams(window.location.search).get('stream');
+            this.stateStream = new StateStream(streamUrl || undefined);
+            this.stateStream.setView({ lodDistance: 2e12, farStride: 4 });
+            this.stateStream.connect();
+            this.solarSystem.setStateStream(this.stateStream);
+            
             // Initialize time controls
             this.timeControls = new TimeControls(this.solarSystem);
             
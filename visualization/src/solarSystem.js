@@ -13,6 +13,7 @@ export class SolarSystemRenderer {
         
         /*--- Simulation state ---*/
         this.simulationTime = 0;  // seconds since epoch
+        this.stateStream = null;  // optional StateStream from the C++ core
         
         /*--- Scale factors (for visualization) ---*/
         this.distanceScale = 1 / 1e9;    // 1 unit = 1 billion meters
@@ -66,6 +67,7 @@ export class SolarSystemRenderer {
         
         this.sun = new THREE.Mesh(geometry, material);
         this.sun.userData = {
+            bodyId: 0,
             name: 'Sun',
             type: 'star',
             mass: 1.989e30,
@@ -102,6 +104,7 @@ export class SolarSystemRenderer {
 
         for (const data of planetsToUse) {
             const planet = this.createPlanetMesh(data);
+            planet.userData.bodyId = this.planets.length + 1;  // ids assigned by ScenarioLoader
             this.planets.push(planet);
             this.scene.add(planet);
         }
@@ -285,17 +288,33 @@ export class SolarSystemRenderer {
         moon.position.y = parent.position.y;
     }
 
+    setStateStream(stream) {
+        this.stateStream = stream;
+    }
+
+    // Place a body at a streamed core position (core x/y ecliptic maps to scene x/z)
+    applyStreamedPosition(body) {
+        const p = this.stateStream.getPosition(body.userData.bodyId);
+        if (!p) return false;
+        body.position.set(p[0] * this.distanceScale, p[2] * this.distanceScale, p[1] * this.distanceScale);
+        return true;
+    }
+
     update(dt) {
-        this.simulationTime += dt;
+        const streaming = this.stateStream && this.stateStream.isLive();
+        this.simulationTime = streaming ? this.stateStream.time : this.simulationTime + dt;
         
         // Rotate sun
         if (this.sun) {
             this.sun.rotation.y += 0.001;
+            if (streaming) this.applyStreamedPosition(this.sun);
         }
         
-        // Update planet positions
+        // Update planet positions (from the core when connected)
         for (const planet of this.planets) {
-            this.updatePlanetPosition(planet, this.simulationTime);
+            if (!streaming || !this.applyStreamedPosition(planet)) {
+                this.updatePlanetPosition(planet, this.simulationTime);
+            }
             planet.rotation.y += 0.01; // Planet rotation
         }
         
@@ -348,6 +367,12 @@ export class SolarSystemRenderer {
             document.getElementById('body-period').textContent = '-';
         }
         
+        // Re-center streamed coordinates on the selection for best precision nearby
+        if (this.stateStream && this.stateStream.isLive() && data.bodyId !== undefined) {
+            const origin = this.stateStream.getPosition(data.bodyId);
+            if (origin) this.stateStream.setView({ origin });
+        }
+        
         // Focus camera on selected body
         this.scene.focusOn(body.position, 50);
     }
@@ -0,0 +1,123 @@
+/*--- Client for the core's local state server (solarsys --serve) ---*/
+// Decodes the binary frames described in core/include/net/StateStreamServer.h.
+// Positions are kept in core coordinates (meters, ecliptic x/y/z).
+
+const MAGIC = 0x31465353;   // "SSF1"
+const HEADER_BYTES = 56;
+const KEYFRAME = 0;
+const DELTA = 1;
+
+export class StateStream {
+    constructor(url = 'ws://127.0.0.1:8765') {
+        this.url = url;
+        this.socket = null;
+        this.reconnectDelay = 1000;
+
+        /*--- Decoded state ---*/
+        this.time = 0;                  // simulation seconds
+        this.ids = [];
+        this.indexById = new Map();
+        this.relative = new Float64Array(0);   // xyz relative to origin
+        this.origin = [0, 0, 0];
+        this.sequence = -1;
+        this.framesReceived = 0;
+        this.lastFrameAt = 0;
+
+        /*--- View settings sent to the server ---*/
+        this.view = { origin: [0, 0, 0] };
+    }
+
+    connect() {
+        this.socket = new WebSocket(this.url);
+        this.socket.binaryType = 'arraybuffer';
+
+        this.socket.onopen = () => {
+            this.reconnectDelay = 1000;
+            this.socket.send(JSON.stringify(this.view));
+            console.log(`Connected to core state server at ${this.url}`);
+        };
+        this.socket.onmessage = (event) => this.onFrame(event.data);
+        this.socket.onclose = () => {
+            // Keep retrying quietly; the renderer falls back to its own orbits meanwhile
+            this.socket = null;
+            setTimeout(() => this.connect(), this.reconnectDelay);
+            this.reconnectDelay = Math.min(this.reconnectDelay * 2, 10000);
+        };
+        this.socket.onerror = () => {};
+    }
+
+    isLive() {
+        return this.ids.length > 0 && performance.now() - this.lastFrameAt < 2000;
+    }
+
+    // Partial update of { origin: [x, y, z], lodDistance, farStride, quantum, keyframeInterval }
+    setView(settings) {
+        Object.assign(this.view, settings);
+        if (this.socket && this.socket.readyState === WebSocket.OPEN) {
+            this.socket.send(JSON.stringify(this.view));
+        }
+    }
+
+    // Absolute core position in meters, or null if the body is not streamed
+    getPosition(id) {
+        const i = this.indexById.get(id);
+        if (i === undefined) return null;
+        return [
+            this.origin[0] + this.relative[3 * i],
+            this.origin[1] + this.relative[3 * i + 1],
+            this.origin[2] + this.relative[3 * i + 2]
+        ];
+    }
+
+    onFrame(buffer) {
+        const view = new DataView(buffer);
+        if (buffer.byteLength < HEADER_BYTES || view.getUint32(0, true) !== MAGIC) return;
+
+        const type = view.getUint8(4);
+        const sequence = view.getUint32(8, true);
+        const count = view.getUint32(12, true);
+        this.time = view.getFloat64(16, true);
+        const origin = [view.getFloat64(24, true), view.getFloat64(32, true), view.getFloat64(40, true)];
+        const quantum = view.getFloat64(48, true);
+
+        if (type === KEYFRAME) {
+            this.ids = new Array(count);
+            this.indexById.clear();
+            this.relative = new Float64Array(3 * count);
+            let offset = HEADER_BYTES;
+            for (let i = 0; i < count; i++, offset += 4) {
+                this.ids[i] = view.getInt32(offset, true);
+                this.indexById.set(this.ids[i], i);
+            }
+            for (let k = 0; k < 3 * count; k++, offset += 4) {
+                this.relative[k] = view.getFloat32(offset, true);
+            }
+            this.origin = origin;
+        } else if (type === DELTA) {
+            // Deltas are only meaningful on top of the keyframe they follow
+            if (this.ids.length === 0 || sequence !== this.sequence + 1) {
+                this.requestKeyframe();
+                return;
+            }
+            let offset = HEADER_BYTES;
+            for (let n = 0; n < count; n++, offset += 10) {
+                const i = view.getUint32(offset, true);
+                this.relative[3 * i] += view.getInt16(offset + 4, true) * quantum;
+                this.relative[3 * i + 1] += view.getInt16(offset + 6, true) * quantum;
+                this.relative[3 * i + 2] += view.getInt16(offset + 8, true) * quantum;
+            }
+        } else {
+            return;
+        }
+
+        this.sequence = sequence;
+        this.framesReceived++;
+        this.lastFrameAt = performance.now();
+    }
+
+    requestKeyframe() {
+        if (this.socket && this.socket.readyState === WebSocket.OPEN) {
+            this.socket.send('keyframe');
+        }
+    }
+}